@@ -0,0 +1,221 @@
+/// \file AllocationTest.cxx
+/// \brief Checks that the events processing does not allocate once warmed up
+///
+/// Runs a synthetic events loop on a framework with preallocated event
+/// storage and counts, through the replaced global allocation functions,
+/// the heap allocations made while the framework processes each event.
+/// After the warm up events any allocation within the events processing
+/// makes the test fail.
+///
+/// The loop is run in three passes, each one taking as calibration the
+/// output of the previous one, so that the events processing is checked
+/// while only collecting calibration data, once the recentering is
+/// applied and once the twist is applied as well.
+///
+/// Usage:
+///
+///     AllocationTest [number of processing threads]
+///
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <TFile.h>
+#include <TList.h>
+#include <TMath.h>
+#include <TROOT.h>
+#include <TRandom3.h>
+#include <TString.h>
+
+#include "QnCorrectionsLog.h"
+#include "QnCorrectionsEventClassVariablesSet.h"
+#include "QnCorrectionsCutAbove.h"
+#include "QnCorrectionsCutBelow.h"
+#include "QnCorrectionsCutsSet.h"
+#include "QnCorrectionsDetector.h"
+#include "QnCorrectionsDetectorConfigurationTracks.h"
+#include "QnCorrectionsManager.h"
+#include "QnCorrectionsProfile3DCorrelations.h"
+#include "QnCorrectionsQnVectorRecentering.h"
+#include "QnCorrectionsQnVectorTwistAndRescale.h"
+
+/// The allocations counting is active
+static std::atomic<bool> gCountAllocations(false);
+/// The heap allocations counted while active
+static std::atomic<long> gNoOfAllocations(0);
+
+void *operator new(std::size_t size) {
+  if (gCountAllocations) gNoOfAllocations++;
+  void *memory = std::malloc(size != 0 ? size : 1);
+  if (memory == NULL) throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  if (gCountAllocations) gNoOfAllocations++;
+  return std::malloc(size != 0 ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+
+/// The variables the framework reads
+enum Variables {
+  kCentrality,
+  kVertexZ,
+  kCharge,
+  kNVars
+};
+
+/// The track detector identity
+const Int_t kDetector = 0;
+/// The number of events before the allocations are counted
+const Int_t nNoOfWarmUpEvents = 200;
+/// The number of events whose processing is checked
+const Int_t nNoOfCheckedEvents = 2000;
+/// The highest multiplicity of the synthetic events
+const Int_t nMaxMultiplicity = 1000;
+/// The number of calibration passes
+const Int_t nNoOfPasses = 3;
+
+/// Builds a detector configuration on the passed charge cuts
+QnCorrectionsDetectorConfigurationTracks *BuildConfiguration(const char *name,
+    QnCorrectionsEventClassVariablesSet *eventClasses, QnCorrectionsCutsBase *cut) {
+  Int_t harmonicsMap[] = {2};
+
+  QnCorrectionsCutsSet *cuts = new QnCorrectionsCutsSet();
+  cuts->Add(cut);
+  cuts->SetOwner(kTRUE);
+
+  QnCorrectionsDetectorConfigurationTracks *configuration =
+      new QnCorrectionsDetectorConfigurationTracks(name, eventClasses, 1, harmonicsMap);
+  configuration->SetCuts(cuts);
+  configuration->SetQVectorNormalizationMethod(QnCorrectionsQnVector::QVNORM_QoverM);
+  configuration->AddCorrectionOnQnVector(new QnCorrectionsQnVectorRecentering());
+  QnCorrectionsQnVectorTwistAndRescale *twistAndRescale = new QnCorrectionsQnVectorTwistAndRescale();
+  twistAndRescale->SetApplyTwist(kTRUE);
+  twistAndRescale->SetApplyRescale(kFALSE);
+  twistAndRescale->SetTwistAndRescaleMethod(QnCorrectionsQnVectorTwistAndRescale::TWRESCALE_doubleHarmonic);
+  configuration->AddCorrectionOnQnVector(twistAndRescale);
+  return configuration;
+}
+
+/// Sets up the framework with preallocated event storage
+void Setup(QnCorrectionsManager *manager, Int_t nNoOfThreads) {
+
+  QnCorrectionsEventClassVariablesSet *eventClasses = new QnCorrectionsEventClassVariablesSet(2);
+  eventClasses->Add(new QnCorrectionsEventClassVariable(kVertexZ, "VertexZ", 10, -10.0, 10.0));
+  eventClasses->Add(new QnCorrectionsEventClassVariable(kCentrality, "Centrality", 10, 0.0, 100.0));
+
+  QnCorrectionsDetector *detector = new QnCorrectionsDetector("Tracks", kDetector);
+  detector->AddDetectorConfiguration(BuildConfiguration("TracksPos", eventClasses, new QnCorrectionsCutAbove(kCharge, 0.0)));
+  detector->AddDetectorConfiguration(BuildConfiguration("TracksNeg", eventClasses, new QnCorrectionsCutBelow(kCharge, 0.0)));
+  manager->AddDetector(detector);
+
+  manager->SetShouldFillQAHistograms(kTRUE);
+  manager->SetShouldFillNveQAHistograms(kTRUE);
+  manager->SetShouldFillOutputHistograms(kTRUE);
+  manager->SetNoOfProcessingThreads(nNoOfThreads);
+  manager->SetPreallocatedEventStorage(nMaxMultiplicity);
+
+  manager->InitializeQnCorrectionsFramework();
+  manager->SetCurrentProcessListName("AllocationTest");
+}
+
+/// Incorporates a synthetic event into the framework
+void BuildEvent(QnCorrectionsManager *manager, TRandom3 &random) {
+  manager->ClearEvent();
+
+  Double_t centrality = random.Rndm() * 100;
+  manager->SetDataVariable(kCentrality, centrality);
+  manager->SetDataVariable(kVertexZ, (random.Rndm() - 0.5) * 20);
+
+  Double_t flowV2 = 0.5;
+  Double_t PsiRP = random.Rndm() * 2 * TMath::Pi();
+  Int_t multiplicity = 2 + Int_t(random.Rndm() * (100 - centrality) / 100 * (nMaxMultiplicity - 2));
+  Int_t nTracks = 0;
+  while (nTracks < multiplicity) {
+    Double_t trackPhi = random.Rndm() * 2 * TMath::Pi();
+    if (random.Rndm() > (1 - flowV2 + flowV2 * TMath::Cos(2 * (trackPhi - PsiRP)))) continue;
+
+    manager->SetDataVariable(kCharge, (random.Rndm() < 0.4) ? 1 : -1);
+    manager->AddDataVector(kDetector, trackPhi);
+    nTracks++;
+  }
+}
+
+/// Runs a pass of the events loop
+///
+/// \param pass the pass number, the previous pass output is taken as calibration
+/// \param nNoOfThreads the number of processing threads
+/// \return the number of allocations within the checked events processing
+long RunPass(Int_t pass, Int_t nNoOfThreads) {
+  QnCorrectionsManager *manager = new QnCorrectionsManager();
+  TFile *calibrationFile = NULL;
+  if (0 < pass) {
+    calibrationFile = TFile::Open(Form("AllocationTest_%d_%d.root", nNoOfThreads, pass - 1), "READ");
+    manager->SetCalibrationHistogramsList(calibrationFile);
+  }
+  Setup(manager, nNoOfThreads);
+
+  TRandom3 random(4357 + pass);
+  for (Int_t ixEvent = 0; ixEvent < nNoOfWarmUpEvents; ixEvent++) {
+    BuildEvent(manager, random);
+    manager->ProcessEvent();
+  }
+
+  Int_t nNoOfAllocatingEvents = 0;
+  long nNoOfAllocations = 0;
+  for (Int_t ixEvent = 0; ixEvent < nNoOfCheckedEvents; ixEvent++) {
+    BuildEvent(manager, random);
+    gNoOfAllocations = 0;
+    gCountAllocations = true;
+    manager->ProcessEvent();
+    gCountAllocations = false;
+    if (gNoOfAllocations != 0) {
+      nNoOfAllocatingEvents++;
+      nNoOfAllocations += gNoOfAllocations;
+    }
+  }
+
+  manager->FinalizeQnCorrectionsFramework();
+  TFile *outputFile = TFile::Open(Form("AllocationTest_%d_%d.root", nNoOfThreads, pass), "RECREATE");
+  TList *calibrationList = manager->GetOutputHistogramsList();
+  calibrationList->Write(calibrationList->GetName(), TObject::kSingleKey);
+  outputFile->Close();
+  delete outputFile;
+  delete manager;
+  if (calibrationFile != NULL) {
+    calibrationFile->Close();
+    delete calibrationFile;
+  }
+
+  printf("Pass %d: processed %d events after %d warm up events on %d threads, %ld allocations in %d events\n",
+      pass, nNoOfCheckedEvents, nNoOfWarmUpEvents, nNoOfThreads, nNoOfAllocations, nNoOfAllocatingEvents);
+  return nNoOfAllocations;
+}
+
+int main(int argc, char **argv) {
+  Int_t nNoOfThreads = (1 < argc) ? atoi(argv[1]) : 1;
+
+  QnCorrectionsSetTracingLevel(kError);
+  if (1 < nNoOfThreads) ROOT::EnableThreadSafety();
+
+  long nNoOfAllocations = 0;
+  for (Int_t pass = 0; pass < nNoOfPasses; pass++) {
+    nNoOfAllocations += RunPass(pass, nNoOfThreads);
+  }
+  return (nNoOfAllocations == 0) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+/// \file ExampleDriver.cxx
+/// \brief Compiled driver for the example
+///
+/// Runs the example against the precompiled framework library
+/// taking its settings from a configuration file, by default
+/// Example.conf, in the TEnv format. No sources are compiled at
+/// run time so the events processing starts right away.
+///
+/// Usage:
+///
+///     ExampleDriver [configuration file]
+///
+
+#include <TString.h>
+
+void ExampleFromConfiguration(const char *configurationFileName);
+
+int main(int argc, char **argv) {
+  TString configurationFileName = "Example.conf";
+  if (1 < argc) configurationFileName = argv[1];
+
+  ExampleFromConfiguration(configurationFileName);
+  return 0;
+}
@@ -0,0 +1,309 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCheckpoint.cxx
+/// \brief Implementation of the incremental checkpoint of the framework accumulators
+
+#include <TFile.h>
+#include <TSystem.h>
+#include <TParameter.h>
+
+#include "QnCorrectionsHistogramBase.h"
+#include "QnCorrectionsCheckpoint.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsCheckpointBins);
+ClassImp(QnCorrectionsCheckpoint);
+/// \endcond
+
+const char *QnCorrectionsCheckpoint::szCheckpointKeyName = "QnCorrectionsCheckpoint";
+const char *QnCorrectionsCheckpoint::szEventCursorName = "EventCursor";
+
+/// Default constructor
+QnCorrectionsCheckpointBins::QnCorrectionsCheckpointBins() : TNamed(),
+    fNoOfBins(0),
+    fNoOfLinearBins(0),
+    fNoOfCoordinates(0),
+    fNoOfErrors(0),
+    fEntries(0.0),
+    fLinearBins(NULL),
+    fCoordinates(NULL),
+    fContents(NULL),
+    fErrors2(NULL) {
+}
+
+/// Normal constructor
+///
+/// Stores the current content, and squared error if the histogram
+/// calculates errors, of the passed changed bins together with the
+/// histogram number of entries.
+/// \param name the histogram identification
+/// \param histogram the histogram
+/// \param dirtyBins the histogram bins changed since the previous checkpoint
+QnCorrectionsCheckpointBins::QnCorrectionsCheckpointBins(const char *name, const THnBase *histogram, const QnCorrectionsCoreDirtyBins &dirtyBins) :
+    TNamed(name, name),
+    fNoOfBins(dirtyBins.GetNoOfBins()),
+    fNoOfLinearBins(0),
+    fNoOfCoordinates(0),
+    fNoOfErrors(0),
+    fEntries(histogram->GetEntries()),
+    fLinearBins(NULL),
+    fCoordinates(NULL),
+    fContents(NULL),
+    fErrors2(NULL) {
+
+  Bool_t sparse = histogram->InheritsFrom("THnSparse");
+  Int_t nDimensions = histogram->GetNdimensions();
+
+  fContents = new Double_t[fNoOfBins];
+  if (sparse) {
+    fNoOfCoordinates = fNoOfBins * nDimensions;
+    fCoordinates = new Int_t[fNoOfCoordinates];
+  }
+  else {
+    fNoOfLinearBins = fNoOfBins;
+    fLinearBins = new Long64_t[fNoOfLinearBins];
+  }
+  if (histogram->GetCalculateErrors()) {
+    fNoOfErrors = fNoOfBins;
+    fErrors2 = new Double_t[fNoOfErrors];
+  }
+
+  for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+    Long64_t bin = dirtyBins.GetBin(ixBin);
+    if (sparse) {
+      fContents[ixBin] = histogram->GetBinContent(bin, fCoordinates + ixBin * nDimensions);
+    }
+    else {
+      fLinearBins[ixBin] = bin;
+      fContents[ixBin] = histogram->GetBinContent(bin);
+    }
+    if (fNoOfErrors != 0)
+      fErrors2[ixBin] = histogram->GetBinError2(bin);
+  }
+}
+
+/// Default destructor
+QnCorrectionsCheckpointBins::~QnCorrectionsCheckpointBins() {
+  if (fLinearBins != NULL) delete [] fLinearBins;
+  if (fCoordinates != NULL) delete [] fCoordinates;
+  if (fContents != NULL) delete [] fContents;
+  if (fErrors2 != NULL) delete [] fErrors2;
+}
+
+/// Restores the stored bins into the passed histogram
+///
+/// The stored content and squared error replace the ones of each
+/// bin and the histogram number of entries is set to the stored one.
+/// \param histogram the histogram to restore
+void QnCorrectionsCheckpointBins::Restore(THnBase *histogram) const {
+  Int_t nDimensions = (fNoOfBins != 0) ? fNoOfCoordinates / fNoOfBins : 0;
+
+  for (Int_t ixBin = 0; ixBin < fNoOfBins; ixBin++) {
+    Long64_t bin;
+    if (fNoOfLinearBins != 0)
+      bin = fLinearBins[ixBin];
+    else
+      bin = histogram->GetBin(fCoordinates + ixBin * nDimensions, kTRUE);
+    histogram->SetBinContent(bin, fContents[ixBin]);
+    if (fNoOfErrors != 0)
+      histogram->SetBinError2(bin, fErrors2[ixBin]);
+  }
+  histogram->SetEntries(fEntries);
+}
+
+/// Default constructor
+///
+/// The checkpoint is not in use until a file name is given.
+QnCorrectionsCheckpoint::QnCorrectionsCheckpoint() : TObject(),
+    fFileName(""),
+    fNoOfCheckpoints(0) {
+}
+
+/// Default destructor
+QnCorrectionsCheckpoint::~QnCorrectionsCheckpoint() {
+}
+
+/// Stores a new checkpoint
+///
+/// The bins changed since the previous checkpoint of the histograms
+/// within the passed lists are appended to the checkpoint file together
+/// with the passed event cursor. Pending fills should be performed before.
+/// The changed bins trackers are only cleared once the checkpoint is
+/// safely stored, so a failed checkpoint is covered by the next one.
+/// \param lists the lists of histograms to checkpoint
+/// \param context the histograms context tracking the changed bins
+/// \param eventCursor the driver position in its input events
+/// \return kTRUE if the checkpoint was properly stored
+Bool_t QnCorrectionsCheckpoint::Store(TList *lists, const QnCorrectionsHistogramsContext &context, Long64_t eventCursor) {
+  std::map<const THnBase *, QnCorrectionsCoreDirtyBins *> dirtyBins;
+  context.CollectDirtyBins(dirtyBins);
+
+  TList checkpoint;
+  checkpoint.SetOwner(kTRUE);
+  checkpoint.Add(new TParameter<Long64_t>(szEventCursorName, eventCursor));
+  std::vector<QnCorrectionsCoreDirtyBins *> stored;
+  for (Int_t ixList = 0; ixList < lists->GetEntries(); ixList++) {
+    TList *list = (TList *) lists->At(ixList);
+    CollectBins(list, list->GetName(), dirtyBins, &checkpoint, stored);
+  }
+
+  TFile *file = TFile::Open(fFileName, "UPDATE");
+  if ((file == NULL) || !file->IsOpen()) {
+    QnCorrectionsError(Form("Checkpoint file %s could not be opened. Checkpoint at event %lld skipped.",
+        fFileName.Data(), eventCursor));
+    if (file != NULL) delete file;
+    return kFALSE;
+  }
+  Int_t nBytes = file->WriteTObject(&checkpoint, Form("%s%d", szCheckpointKeyName, fNoOfCheckpoints), "SingleKey");
+  file->Close();
+  delete file;
+  if (!(0 < nBytes)) {
+    QnCorrectionsError(Form("Checkpoint at event %lld could not be written into file %s.",
+        eventCursor, fFileName.Data()));
+    return kFALSE;
+  }
+
+  for (UInt_t ixStored = 0; ixStored < stored.size(); ixStored++) {
+    stored[ixStored]->Clear();
+  }
+  fNoOfCheckpoints++;
+  return kTRUE;
+}
+
+/// Restores the histograms from the stored checkpoints
+///
+/// The complete checkpoints in the file are restored in order into
+/// the histograms within the passed lists. The lists should belong to
+/// a freshly initialized framework with the same configuration than the
+/// checkpointed one. If the checkpoint file does not exist yet nothing
+/// is restored.
+/// \param lists the lists of histograms to restore
+/// \return the event cursor of the last checkpoint, -1 if there were none
+Long64_t QnCorrectionsCheckpoint::Restore(TList *lists) {
+  fNoOfCheckpoints = 0;
+  if (gSystem->AccessPathName(fFileName)) {
+    QnCorrectionsInfo(Form("Checkpoint file %s not present. Starting from scratch.", fFileName.Data()));
+    return -1;
+  }
+  TFile *file = TFile::Open(fFileName, "READ");
+  if ((file == NULL) || !file->IsOpen()) {
+    QnCorrectionsFatal(Form("Checkpoint file %s present but could not be opened. FIX IT, PLEASE.", fFileName.Data()));
+    if (file != NULL) delete file;
+    return -1;
+  }
+
+  std::map<TString, THnBase *> histograms;
+  for (Int_t ixList = 0; ixList < lists->GetEntries(); ixList++) {
+    TList *list = (TList *) lists->At(ixList);
+    CollectHistograms(list, list->GetName(), histograms);
+  }
+
+  Long64_t eventCursor = -1;
+  TList *checkpoint;
+  while ((checkpoint = (TList *) file->Get(Form("%s%d", szCheckpointKeyName, fNoOfCheckpoints))) != NULL) {
+    checkpoint->SetOwner(kTRUE);
+    for (Int_t ixEntry = 0; ixEntry < checkpoint->GetEntries(); ixEntry++) {
+      TObject *entry = checkpoint->At(ixEntry);
+      if (entry->InheritsFrom("QnCorrectionsCheckpointBins")) {
+        std::map<TString, THnBase *>::iterator histogram = histograms.find(entry->GetName());
+        if (histogram != histograms.end()) {
+          ((QnCorrectionsCheckpointBins *) entry)->Restore(histogram->second);
+        }
+        else {
+          QnCorrectionsFatal(Form("Histogram %s from checkpoint file %s not present in the framework. " \
+              "The framework configuration does not match the checkpointed one. FIX IT, PLEASE.",
+              entry->GetName(), fFileName.Data()));
+        }
+      }
+      else {
+        eventCursor = ((TParameter<Long64_t> *) entry)->GetVal();
+      }
+    }
+    delete checkpoint;
+    fNoOfCheckpoints++;
+  }
+  file->Close();
+  delete file;
+
+  QnCorrectionsInfo(Form("%d checkpoints restored from file %s. Resuming after event %lld.",
+      fNoOfCheckpoints, fFileName.Data(), eventCursor));
+  return eventCursor;
+}
+
+/// Collects the changed bins of the histograms within the passed list
+///
+/// Recursive function. Nested lists are explored and each histogram
+/// with changed bins incorporates a record to the checkpoint.
+/// \param list the list of histograms
+/// \param path the path of the list within the checkpointed lists
+/// \param dirtyBins the map from histogram to its changed bins tracker
+/// \param checkpoint the checkpoint under construction
+/// \param stored the changed bins trackers stored in the checkpoint
+void QnCorrectionsCheckpoint::CollectBins(TList *list, const TString &path,
+    std::map<const THnBase *, QnCorrectionsCoreDirtyBins *> &dirtyBins,
+    TList *checkpoint, std::vector<QnCorrectionsCoreDirtyBins *> &stored) {
+  for (Int_t ixEntry = 0; ixEntry < list->GetEntries(); ixEntry++) {
+    TObject *entry = list->At(ixEntry);
+    TString name = path + "/" + entry->GetName();
+    if (entry->InheritsFrom("TList")) {
+      CollectBins((TList *) entry, name, dirtyBins, checkpoint, stored);
+    }
+    else if (entry->InheritsFrom("THnBase")) {
+      std::map<const THnBase *, QnCorrectionsCoreDirtyBins *>::iterator dirty = dirtyBins.find((THnBase *) entry);
+      if ((dirty != dirtyBins.end()) && !dirty->second->IsEmpty()) {
+        checkpoint->Add(new QnCorrectionsCheckpointBins(name, (THnBase *) entry, *dirty->second));
+        stored.push_back(dirty->second);
+      }
+    }
+  }
+}
+
+/// Collects the histograms within the passed list
+///
+/// Recursive function. Nested lists are explored and each histogram
+/// is registered under its path.
+/// \param list the list of histograms
+/// \param path the path of the list within the checkpointed lists
+/// \param histograms the map from path to histogram
+void QnCorrectionsCheckpoint::CollectHistograms(TList *list, const TString &path, std::map<TString, THnBase *> &histograms) {
+  for (Int_t ixEntry = 0; ixEntry < list->GetEntries(); ixEntry++) {
+    TObject *entry = list->At(ixEntry);
+    TString name = path + "/" + entry->GetName();
+    if (entry->InheritsFrom("TList")) {
+      CollectHistograms((TList *) entry, name, histograms);
+    }
+    else if (entry->InheritsFrom("THnBase")) {
+      histograms[name] = (THnBase *) entry;
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#ifndef QNCORRECTIONS_CHECKPOINT_H
+#define QNCORRECTIONS_CHECKPOINT_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCheckpoint.h
+/// \brief Incremental checkpoint of the Q vector correction framework accumulators
+
+#include <map>
+#include <vector>
+#include <TObject.h>
+#include <TNamed.h>
+#include <TList.h>
+#include <TString.h>
+#include <THnBase.h>
+#include "QnCorrectionsCoreDirtyBins.h"
+
+class QnCorrectionsHistogramsContext;
+
+/// \class QnCorrectionsCheckpointBins
+/// \brief The changed bins of a histogram at a checkpoint
+///
+/// Stores, for the histogram identified by its name, the current
+/// content and squared error of the bins changed since the previous
+/// checkpoint together with the histogram number of entries. The
+/// stored values are absolute so restoring the successive records in
+/// order leaves the histogram as it was at the last checkpoint.
+///
+/// Non sparse histogram bins are stored as their linear bin number
+/// while sparse histogram bins are stored as their coordinates because
+/// sparse linear bin numbers depend on the order the bins were filled.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCheckpointBins : public TNamed {
+public:
+  QnCorrectionsCheckpointBins();
+  QnCorrectionsCheckpointBins(const char *name, const THnBase *histogram, const QnCorrectionsCoreDirtyBins &dirtyBins);
+  virtual ~QnCorrectionsCheckpointBins();
+
+  void Restore(THnBase *histogram) const;
+  /// Gets the number of stored bins
+  /// \return the number of changed bins
+  Int_t GetNoOfBins() const { return fNoOfBins; }
+
+private:
+  Int_t fNoOfBins;             ///< the number of changed bins
+  Int_t fNoOfLinearBins;       ///< the number of linear bin numbers, fNoOfBins for non sparse histograms, zero otherwise
+  Int_t fNoOfCoordinates;      ///< the number of bin coordinates, fNoOfBins times the dimensions for sparse histograms, zero otherwise
+  Int_t fNoOfErrors;           ///< the number of squared errors, fNoOfBins if the histogram calculates errors, zero otherwise
+  Double_t fEntries;           ///< the histogram number of entries
+  /// array, the linear number of the changed bins
+  Long64_t *fLinearBins;       //[fNoOfLinearBins]
+  /// array, the coordinates of the changed bins
+  Int_t *fCoordinates;         //[fNoOfCoordinates]
+  /// array, the content of the changed bins
+  Double_t *fContents;         //[fNoOfBins]
+  /// array, the squared error of the changed bins
+  Double_t *fErrors2;          //[fNoOfErrors]
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsCheckpointBins(const QnCorrectionsCheckpointBins &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsCheckpointBins& operator= (const QnCorrectionsCheckpointBins &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsCheckpointBins, 1);
+/// \endcond
+};
+
+/// \class QnCorrectionsCheckpoint
+/// \brief Incremental checkpoint and resume of the framework accumulators
+///
+/// Each checkpoint is appended to a local file as a new key which
+/// contains the event cursor supplied by the driver and, for each
+/// histogram with bins changed since the previous checkpoint, a
+/// QnCorrectionsCheckpointBins record. The cost of a checkpoint is then
+/// proportional to the number of bins changed since the previous one
+/// and not to the histograms size. Histograms are identified by their
+/// path within the passed lists of histograms.
+///
+/// The changed bins are the ones tracked by the framework histograms,
+/// see QnCorrectionsHistogramsContext::SetDirtyBinsTracking, so checkpoints
+/// only cover histograms filled through the framework histograms.
+///
+/// Each checkpoint is written as a single key and the file is closed
+/// after it, so a job killed while checkpointing only loses the
+/// checkpoint being written. Resuming replays the complete checkpoints
+/// in order into a freshly initialized framework and returns the event
+/// cursor of the last one. Further checkpoints are appended to the same file.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCheckpoint : public TObject {
+public:
+  QnCorrectionsCheckpoint();
+  virtual ~QnCorrectionsCheckpoint();
+
+  /// Sets the checkpoint file name
+  /// \param fileName the name of the local file
+  void SetFileName(const char *fileName) { fFileName = fileName; }
+  /// Gets the checkpoint file name
+  /// \return the name of the local file
+  const char *GetFileName() const { return fFileName.Data(); }
+  /// Gets whether the checkpoint is in use
+  /// \return kTRUE if a checkpoint file name was given
+  Bool_t IsEnabled() const { return fFileName.Length() != 0; }
+  /// Gets the number of checkpoints stored in the file
+  /// \return the number of checkpoints
+  Int_t GetNoOfCheckpoints() const { return fNoOfCheckpoints; }
+
+  Bool_t Store(TList *lists, const QnCorrectionsHistogramsContext &context, Long64_t eventCursor);
+  Long64_t Restore(TList *lists);
+
+private:
+  void CollectBins(TList *list, const TString &path,
+      std::map<const THnBase *, QnCorrectionsCoreDirtyBins *> &dirtyBins,
+      TList *checkpoint, std::vector<QnCorrectionsCoreDirtyBins *> &stored);
+  void CollectHistograms(TList *list, const TString &path, std::map<TString, THnBase *> &histograms);
+
+  static const char *szCheckpointKeyName;  ///< the prefix of the name of the keys under which checkpoints are stored
+  static const char *szEventCursorName;    ///< the name of the event cursor within each checkpoint
+  TString fFileName;                       ///< the checkpoint file name
+  Int_t fNoOfCheckpoints;                  //!<! the number of checkpoints already in the file
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsCheckpoint(const QnCorrectionsCheckpoint &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsCheckpoint& operator= (const QnCorrectionsCheckpoint &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsCheckpoint, 1);
+/// \endcond
+};
+
+#endif // QNCORRECTIONS_CHECKPOINT_H
@@ -0,0 +1,99 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreAccumulator.cxx
+/// \brief Implementation of the ROOT independent profile accumulator class
+
+#include "QnCorrectionsCoreAccumulator.h"
+
+/// Default constructor
+QnCorrectionsCoreAccumulator::QnCorrectionsCoreAccumulator() :
+  fNBins(0),
+  fNComponents(0),
+  fErrorMode(kERRORMEAN),
+  fMinNoOfEntriesToValidate(2),
+  fSumValues(),
+  fSumValues2(),
+  fEntries() {
+}
+
+/// Normal constructor
+/// \param nBins the number of linear bins
+/// \param nComponents the number of components per bin
+/// \param mode the error mode
+QnCorrectionsCoreAccumulator::QnCorrectionsCoreAccumulator(long long nBins, int nComponents, ErrorMode mode) :
+  fNBins(0),
+  fNComponents(0),
+  fErrorMode(mode),
+  fMinNoOfEntriesToValidate(2),
+  fSumValues(),
+  fSumValues2(),
+  fEntries() {
+
+  Allocate(nBins, nComponents);
+}
+
+/// Allocates the storage for the passed structure
+///
+/// Previous content is discarded
+/// \param nBins the number of linear bins
+/// \param nComponents the number of components per bin
+void QnCorrectionsCoreAccumulator::Allocate(long long nBins, int nComponents) {
+  fNBins = nBins;
+  fNComponents = nComponents;
+  fSumValues.assign(nBins * nComponents, 0.0);
+  fSumValues2.assign(nBins * nComponents, 0.0);
+  fEntries.assign(nBins, 0);
+}
+
+/// Resets the accumulated content without touching the structure
+void QnCorrectionsCoreAccumulator::Reset() {
+  fSumValues.assign(fSumValues.size(), 0.0);
+  fSumValues2.assign(fSumValues2.size(), 0.0);
+  fEntries.assign(fEntries.size(), 0);
+}
+
+/// Adds the content of other accumulator with the same structure
+///
+/// Used for merging partial results. Nothing is done if the
+/// structures do not match.
+/// \param other the accumulator to add
+void QnCorrectionsCoreAccumulator::Add(const QnCorrectionsCoreAccumulator &other) {
+  if ((fNBins != other.fNBins) || (fNComponents != other.fNComponents)) return;
+
+  for (size_t ix = 0; ix < fSumValues.size(); ix++) {
+    fSumValues[ix] += other.fSumValues[ix];
+    fSumValues2[ix] += other.fSumValues2[ix];
+  }
+  for (size_t ix = 0; ix < fEntries.size(); ix++) {
+    fEntries[ix] += other.fEntries[ix];
+  }
+}
@@ -0,0 +1,131 @@
+#ifndef QNCORRECTIONS_COREACCUMULATOR_H
+#define QNCORRECTIONS_COREACCUMULATOR_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreAccumulator.h
+/// \brief ROOT independent profile accumulator for the core engine of the Q vector correction framework
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/// \class QnCorrectionsCoreAccumulator
+/// \brief Plain C++ multicomponent profile accumulator
+///
+/// Dense storage of the sum of values, the sum of squared values
+/// and the number of entries for each linear bin, as the framework
+/// profiles do with their values and entries THn histograms. Several
+/// components (i.e. X and Y for each harmonic) are stored adjacent
+/// for each bin so that all the components of an event class share
+/// the same cache lines. The entries are kept per bin and are
+/// shared by all the components.
+///
+/// The linear bin numbers are the ones produced by
+/// QnCorrectionsCoreEventClassBinning.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreAccumulator {
+public:
+  /// \enum ErrorMode
+  /// \brief The type of bin errors supported
+  enum ErrorMode {
+    kERRORMEAN = 0,     ///< the bin errors are the standard error on the mean
+    kERRORSPREAD        ///< the bin errors are the standard deviation
+  };
+
+  QnCorrectionsCoreAccumulator();
+  QnCorrectionsCoreAccumulator(long long nBins, int nComponents, ErrorMode mode = kERRORMEAN);
+
+  void Allocate(long long nBins, int nComponents);
+  void Reset();
+  void Add(const QnCorrectionsCoreAccumulator &other);
+
+  /// Gets the number of linear bins
+  long long GetNBins() const { return fNBins; }
+  /// Gets the number of components per bin
+  int GetNComponents() const { return fNComponents; }
+  /// Sets the error mode
+  /// \param mode the error mode
+  void SetErrorMode(ErrorMode mode) { fErrorMode = mode; }
+  /// Sets the minimum number of entries needed to validate the bin content
+  /// \param nNoOfEntries the number of entries threshold
+  void SetNoOfEntriesThreshold(int nNoOfEntries) { fMinNoOfEntriesToValidate = nNoOfEntries; }
+
+  /// Accumulates a value for the passed bin and component
+  /// \param bin the linear bin number
+  /// \param component the component number
+  /// \param value the value to accumulate
+  void Fill(long long bin, int component, double value)
+  { long long ix = bin * fNComponents + component; fSumValues[ix] += value; fSumValues2[ix] += value * value; }
+  /// Increments the number of entries of the passed bin
+  /// \param bin the linear bin number
+  void FillEntry(long long bin) { fEntries[bin]++; }
+
+  /// Gets the number of entries of the passed bin
+  /// \param bin the linear bin number
+  int GetEntries(long long bin) const { return fEntries[bin]; }
+  /// Check the validity of the content of the passed bin
+  /// \param bin the linear bin number
+  bool BinContentValidated(long long bin) const { return !(fEntries[bin] < fMinNoOfEntriesToValidate); }
+  double GetBinContent(long long bin, int component) const;
+  double GetBinError(long long bin, int component) const;
+
+  /// Direct access to the sum of values storage
+  double *GetSumValues() { return (fSumValues.size() != 0) ? &fSumValues[0] : NULL; }
+  /// Direct access to the sum of squared values storage
+  double *GetSumValues2() { return (fSumValues2.size() != 0) ? &fSumValues2[0] : NULL; }
+  /// Direct access to the entries storage
+  int *GetEntriesArray() { return (fEntries.size() != 0) ? &fEntries[0] : NULL; }
+
+private:
+  long long fNBins;                   ///< the number of linear bins
+  int fNComponents;                   ///< the number of components per bin
+  ErrorMode fErrorMode;               ///< the error mode
+  int fMinNoOfEntriesToValidate;      ///< the minimum number of entries for validating a bin content
+  std::vector<double> fSumValues;     ///< sum of values for each bin and component
+  std::vector<double> fSumValues2;    ///< sum of squared values for each bin and component
+  std::vector<int> fEntries;          ///< number of entries for each bin
+};
+
+/// Get the bin content for the passed bin and component
+///
+/// If the bin content is not validated zero is returned.
+/// \param bin the linear bin number
+/// \param component the component number
+/// \return the average of the accumulated values
+inline double QnCorrectionsCoreAccumulator::GetBinContent(long long bin, int component) const {
+  if (!BinContentValidated(bin)) return 0.0;
+  return fSumValues[bin * fNComponents + component] / fEntries[bin];
+}
+
+/// Get the bin error for the passed bin and component
+///
+/// If the bin content is not validated zero is returned.
+/// \param bin the linear bin number
+/// \param component the component number
+/// \return the error according to the error mode
+inline double QnCorrectionsCoreAccumulator::GetBinError(long long bin, int component) const {
+  if (!BinContentValidated(bin)) return 0.0;
+  int nEntries = fEntries[bin];
+  double average = fSumValues[bin * fNComponents + component] / nEntries;
+  double serror = std::sqrt(std::fabs(fSumValues2[bin * fNComponents + component] / nEntries - average * average));
+  switch (fErrorMode) {
+  case kERRORMEAN:
+    return serror / std::sqrt(double(nEntries));
+  case kERRORSPREAD:
+    return serror;
+  }
+  return 0.0;
+}
+
+#endif // QNCORRECTIONS_COREACCUMULATOR_H
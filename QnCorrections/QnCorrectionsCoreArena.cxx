@@ -0,0 +1,98 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreArena.cxx
+/// \brief Implementation of the ROOT independent arena class
+
+#include "QnCorrectionsCoreArena.h"
+
+const size_t QnCorrectionsCoreArena::nCacheLineSize = 64;
+
+/// Normal constructor
+///
+/// No memory is allocated until the first allocation request.
+/// \param chunkSize the size of the chunks of memory
+QnCorrectionsCoreArena::QnCorrectionsCoreArena(size_t chunkSize) :
+  fChunkSize(chunkSize),
+  fChunks(),
+  fCurrent(NULL),
+  fEnd(NULL),
+  fNoOfBytes(0),
+  fDestructors() {
+}
+
+/// Default destructor
+///
+/// Destroys the objects built in the arena and releases its storage
+QnCorrectionsCoreArena::~QnCorrectionsCoreArena() {
+  Clear();
+}
+
+/// Allocates a piece of storage from the arena
+///
+/// The piece is taken just after the previous one if it fits in the
+/// current chunk, otherwise a new cache line aligned chunk, large
+/// enough for the request, is started.
+/// \param size the number of bytes requested
+/// \param alignment the alignment requested, a power of two not beyond the cache line size
+/// \return the start of the allocated storage
+void *QnCorrectionsCoreArena::Allocate(size_t size, size_t alignment) {
+  size_t padding = (alignment - (size_t(fCurrent) & (alignment - 1))) & (alignment - 1);
+  if ((fCurrent == NULL) || (size_t(fEnd - fCurrent) < padding + size)) {
+    size_t chunkSize = (fChunkSize < size) ? size : fChunkSize;
+    char *chunk = new char[chunkSize + nCacheLineSize];
+    fChunks.push_back(chunk);
+    fCurrent = chunk + ((nCacheLineSize - (size_t(chunk) & (nCacheLineSize - 1))) & (nCacheLineSize - 1));
+    fEnd = fCurrent + chunkSize;
+    padding = 0;
+  }
+  void *storage = fCurrent + padding;
+  fCurrent += padding + size;
+  fNoOfBytes += size;
+  return storage;
+}
+
+/// Destroys the objects built in the arena and releases its storage
+///
+/// The objects are destroyed in the reverse order of their construction
+void QnCorrectionsCoreArena::Clear() {
+  for (size_t ixObject = fDestructors.size(); 0 < ixObject; ixObject--) {
+    fDestructors[ixObject - 1].fDestroy(fDestructors[ixObject - 1].fObject);
+  }
+  fDestructors.clear();
+  for (size_t ixChunk = 0; ixChunk < fChunks.size(); ixChunk++) {
+    delete [] fChunks[ixChunk];
+  }
+  fChunks.clear();
+  fCurrent = NULL;
+  fEnd = NULL;
+  fNoOfBytes = 0;
+}
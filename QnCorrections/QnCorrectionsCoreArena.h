@@ -0,0 +1,96 @@
+#ifndef QNCORRECTIONS_COREARENA_H
+#define QNCORRECTIONS_COREARENA_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreArena.h
+/// \brief ROOT independent arena for the contiguous layout of long lived objects
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/// \class QnCorrectionsCoreArena
+/// \brief Plain C++ bump allocator for objects sharing their lifetime
+///
+/// Hands out consecutive, suitably aligned, pieces of cache line
+/// aligned chunks of memory so that objects allocated one after
+/// the other end up adjacent in memory in the same order. Nothing
+/// is released individually, the whole storage is released when the
+/// arena is cleared or destroyed. The objects built in the arena are
+/// destroyed at that point in the reverse order of their construction.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreArena {
+public:
+  QnCorrectionsCoreArena(size_t chunkSize = nDefaultChunkSize);
+  ~QnCorrectionsCoreArena();
+
+  void *Allocate(size_t size, size_t alignment = nDefaultAlignment);
+  void Clear();
+
+  /// Builds an array of the template type in the arena as a copy of the passed one
+  ///
+  /// Only for types that do not need destruction
+  /// \param source the array to copy
+  /// \param n the number of elements in the array
+  /// \return the new array
+  template <typename T>
+  T *NewArrayCopy(const T *source, int n)
+  { T *array = static_cast<T *>(Allocate(n * sizeof(T))); for (int i = 0; i < n; i++) new (array + i) T(source[i]); return array; }
+  /// Takes the passed object, built in the arena storage, under the arena responsibility
+  ///
+  /// The object is destroyed when the arena is cleared or destroyed
+  /// \param object the object to adopt
+  template <typename T>
+  void Adopt(T *object) { fDestructors.push_back(Destructor(&Destroy<T>, object)); }
+
+  /// Gets the number of bytes handed out by the arena
+  size_t GetNoOfBytes() const { return fNoOfBytes; }
+  /// Gets the number of chunks of memory the arena holds
+  int GetNoOfChunks() const { return int(fChunks.size()); }
+
+  static const size_t nCacheLineSize;        ///< the size assumed for a cache line
+private:
+  static const size_t nDefaultChunkSize = 4096; ///< the default size of the chunks of memory
+  static const size_t nDefaultAlignment = 16;   ///< the default alignment of the allocations
+
+  /// Destroys an object of the template type built in the arena storage
+  /// \param object the object to destroy
+  template <typename T>
+  static void Destroy(void *object) { static_cast<T *>(object)->~T(); }
+
+  /// \struct Destructor
+  /// \brief The destruction function of an object built in the arena
+  struct Destructor {
+    /// Normal constructor
+    /// \param destroy the destruction function
+    /// \param object the object to destroy
+    Destructor(void (*destroy)(void *), void *object) : fDestroy(destroy), fObject(object) {}
+    void (*fDestroy)(void *);   ///< the destruction function
+    void *fObject;              ///< the object to destroy
+  };
+
+  /// Copy constructor not implemented
+  QnCorrectionsCoreArena(const QnCorrectionsCoreArena &);
+  /// Assignment operator not implemented
+  QnCorrectionsCoreArena &operator=(const QnCorrectionsCoreArena &);
+
+  size_t fChunkSize;                       ///< the size of the chunks of memory
+  std::vector<char *> fChunks;             ///< the chunks of memory as allocated
+  char *fCurrent;                          ///< the next free position in the current chunk
+  char *fEnd;                              ///< the end of the current chunk
+  size_t fNoOfBytes;                       ///< the number of bytes handed out
+  std::vector<Destructor> fDestructors;    ///< the destruction functions of the objects built in the arena
+};
+
+#endif // QNCORRECTIONS_COREARENA_H
@@ -0,0 +1,85 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreBinRegisters.cxx
+/// \brief Implementation of the ROOT independent per bin registers of deferred fills class
+
+#include "QnCorrectionsCoreBinRegisters.h"
+#include <algorithm>
+#include <cstddef>
+
+/// Default constructor
+///
+/// The hash has no slots until the first fill.
+QnCorrectionsCoreBinRegisters::QnCorrectionsCoreBinRegisters() :
+  fSlots(),
+  fHashShift(64),
+  fRegisters(),
+  fFills() {
+}
+
+/// Doubles the hash slots and places again the registers
+///
+/// Starts with 64 slots.
+void QnCorrectionsCoreBinRegisters::Grow() {
+  std::size_t nSlots = fSlots.empty() ? 64 : 2 * fSlots.size();
+  fHashShift = 64;
+  for (std::size_t n = nSlots; n > 1; n >>= 1) fHashShift--;
+  fSlots.assign(nSlots, -1);
+
+  unsigned long long mask = nSlots - 1;
+  for (std::size_t entry = 0; entry < fRegisters.size(); entry++) {
+    unsigned long long slot = GetHomeSlot(fRegisters[entry].fTarget, fRegisters[entry].fBin);
+    while (0 <= fSlots[slot]) slot = (slot + 1) & mask;
+    fSlots[slot] = int(entry);
+    fRegisters[entry].fSlot = int(slot);
+  }
+}
+
+/// Orders the registers by target and bin
+///
+/// Afterwards no more fills should be added until the registers
+/// are cleared, as the hash no longer points to the right registers.
+void QnCorrectionsCoreBinRegisters::Order() {
+  std::sort(fRegisters.begin(), fRegisters.end(), RegisterLess());
+}
+
+/// Releases the touched bins and their fills
+///
+/// Only the used hash slots are freed and the storage is
+/// kept for the next batch of fills.
+void QnCorrectionsCoreBinRegisters::Clear() {
+  for (std::size_t entry = 0; entry < fRegisters.size(); entry++) {
+    fSlots[fRegisters[entry].fSlot] = -1;
+  }
+  fRegisters.clear();
+  fFills.clear();
+}
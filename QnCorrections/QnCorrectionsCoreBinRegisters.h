@@ -0,0 +1,138 @@
+#ifndef QNCORRECTIONS_COREBINREGISTERS_H
+#define QNCORRECTIONS_COREBINREGISTERS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+
+/// \file QnCorrectionsCoreBinRegisters.h
+/// \brief ROOT independent per bin registers of deferred fills for the core engine of the Q vector correction framework
+
+#include <vector>
+
+/// \class QnCorrectionsCoreBinRegisters
+/// \brief Plain C++ per bin registers of deferred histogram fills
+///
+/// The fills for the same target histogram linear bin are chained, as
+/// they arrive, to a single register. The registers are located through
+/// an open addressing hash keyed by target and bin, so that only the
+/// touched bins take storage whatever the size of the target histograms.
+/// When requested the registers are ordered by target and bin and the
+/// owner replays the fills of each bin in their arrival order, so that
+/// the bins contents are updated by the same sequence of increments as
+/// with immediate fills while the updates of each bin stay together.
+///
+/// The storage is kept when the registers are cleared so that, once
+/// the touched bins and the fills of a batch have been seen, registering
+/// the fills does not allocate.
+///
+/// The targets are small integers assigned by the registers owner and the
+/// linear bin numbers are the ones produced by QnCorrectionsCoreEventClassBinning.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreBinRegisters {
+public:
+  QnCorrectionsCoreBinRegisters();
+
+  /// Gets whether there are no touched bins
+  bool IsEmpty() const { return fRegisters.empty(); }
+
+  void Add(int target, long long bin, double value);
+  void Order();
+  void Clear();
+
+  /// Gets the number of touched bins
+  int GetNoOfEntries() const { return int(fRegisters.size()); }
+  /// Gets the target histogram of the passed touched bin
+  /// \param entry the touched bin number
+  int GetTarget(int entry) const { return fRegisters[entry].fTarget; }
+  /// Gets the linear bin number of the passed touched bin
+  /// \param entry the touched bin number
+  long long GetBin(int entry) const { return fRegisters[entry].fBin; }
+  /// Gets the first fill of the passed touched bin
+  /// \param entry the touched bin number
+  int GetFirstFill(int entry) const { return fRegisters[entry].fFirstFill; }
+  /// Gets the fill which follows the passed one within its bin
+  /// \param fill the fill number
+  /// \return the next fill number, -1 if the passed fill is the last one of its bin
+  int GetNextFill(int fill) const { return fFills[fill].fNext; }
+  /// Gets the value of the passed fill
+  /// \param fill the fill number
+  double GetValue(int fill) const { return fFills[fill].fValue; }
+
+private:
+  /// \struct Register
+  /// \brief The chained fills of a target bin
+  struct Register {
+    int fTarget;                ///< the target histogram
+    long long fBin;             ///< the linear bin number
+    int fFirstFill;             ///< the first fill of the bin
+    int fLastFill;              ///< the last fill of the bin
+    int fSlot;                  ///< the hash slot pointing to the register
+  };
+  /// \struct Fill
+  /// \brief A pending fill
+  struct Fill {
+    double fValue;              ///< the value to accumulate
+    int fNext;                  ///< the next fill of the same bin, -1 if none
+  };
+  /// \struct RegisterLess
+  /// \brief Orders the registers by target and bin
+  struct RegisterLess {
+    bool operator()(const Register &a, const Register &b) const
+    { return (a.fTarget < b.fTarget) || ((a.fTarget == b.fTarget) && (a.fBin < b.fBin)); }
+  };
+
+  /// Gets the hash slot where the search for the passed target bin starts
+  /// \param target the target histogram
+  /// \param bin the linear bin number
+  unsigned long long GetHomeSlot(int target, long long bin) const
+  { return ((unsigned long long) bin * 0x9E3779B97F4A7C15ULL + (unsigned long long) target * 0xC2B2AE3D27D4EB4FULL) >> fHashShift; }
+  void Grow();
+
+  std::vector<int> fSlots;                ///< the open addressing hash of the registers, -1 for free slots
+  int fHashShift;                         ///< the right shift taking a hash value to the slots range
+  std::vector<Register> fRegisters;       ///< the registers of the touched bins in touching order
+  std::vector<Fill> fFills;               ///< the pending fills in arrival order
+};
+
+/// Chains a fill to the register of its target bin
+///
+/// The hash is grown when it gets half full.
+/// \param target the target histogram
+/// \param bin the linear bin number within the target histogram
+/// \param value the value to accumulate
+inline void QnCorrectionsCoreBinRegisters::Add(int target, long long bin, double value) {
+  if (!(2 * fRegisters.size() < fSlots.size())) Grow();
+
+  unsigned long long mask = fSlots.size() - 1;
+  unsigned long long slot = GetHomeSlot(target, bin);
+  while (0 <= fSlots[slot]) {
+    const Register &reg = fRegisters[fSlots[slot]];
+    if ((reg.fBin == bin) && (reg.fTarget == target)) break;
+    slot = (slot + 1) & mask;
+  }
+  int fill = int(fFills.size());
+  Fill newFill = { value, -1 };
+  fFills.push_back(newFill);
+  if (fSlots[slot] < 0) {
+    fSlots[slot] = int(fRegisters.size());
+    Register reg = { target, bin, fill, fill, int(slot) };
+    fRegisters.push_back(reg);
+  }
+  else {
+    Register &reg = fRegisters[fSlots[slot]];
+    fFills[reg.fLastFill].fNext = fill;
+    reg.fLastFill = fill;
+  }
+}
+
+#endif // QNCORRECTIONS_COREBINREGISTERS_H
@@ -0,0 +1,196 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreCorrectionKernels.cxx
+/// \brief Implementation of the ROOT independent correction step kernels
+
+#include "QnCorrectionsCoreCorrectionKernels.h"
+#include <thread>
+#include <vector>
+
+const long long QnCorrectionsCoreCorrectionKernels::nMinBinsPerThread = 1 << 16;
+
+/// Computes the alignment rotation angle
+///
+/// The angle is extracted from the correlations between the
+/// Qn vector being aligned and the reference one.
+/// \param XX the XX correlation average
+/// \param YY the YY correlation average
+/// \param XY the XY correlation average
+/// \param YX the YX correlation average
+/// \param eXY the XY correlation error
+/// \param eYX the YX correlation error
+/// \param harmonicForAlignment the harmonic used for the alignment
+/// \param deltaPhi storage for the rotation angle
+/// \return true if the correction is significant and should be applied
+bool QnCorrectionsCoreCorrectionKernels::AlignmentAngle(double XX, double YY, double XY, double YX, double eXY, double eYX,
+    int harmonicForAlignment, double &deltaPhi) {
+
+  deltaPhi = - std::atan2((XY-YX),(XX+YY)) * (1.0 / harmonicForAlignment);
+
+  /* significant correction? */
+  return !(std::sqrt((XY-YX)*(XY-YX)/(eXY*eXY+eYX*eYX)) < 2.0);
+}
+
+/// Computes the twist and rescale parameters with the double harmonic method
+/// \param X2n the X component average of the double harmonic
+/// \param Y2n the Y component average of the double harmonic
+/// \param Aplus storage for the \f$ A^{+} \f$ rescale parameter
+/// \param Aminus storage for the \f$ A^{-} \f$ rescale parameter
+/// \param LambdaPlus storage for the \f$ \Lambda^{+} \f$ twist parameter
+/// \param LambdaMinus storage for the \f$ \Lambda^{-} \f$ twist parameter
+void QnCorrectionsCoreCorrectionKernels::TwistAndRescaleFromDoubleHarmonic(double X2n, double Y2n,
+    double &Aplus, double &Aminus, double &LambdaPlus, double &LambdaMinus) {
+
+  Aplus = 1 + X2n;
+  Aminus = 1 - X2n;
+  LambdaPlus = Y2n / Aplus;
+  LambdaMinus = Y2n / Aminus;
+}
+
+/// Computes the twist and rescale parameters with the correlations method
+///
+/// The A detector is the one being corrected, B is the tracking detector
+/// and C is the additional one.
+/// \param XAXC the XAXC correlation average
+/// \param YAYB the YAYB correlation average
+/// \param XAXB the XAXB correlation average
+/// \param XBXC the XBXC correlation average
+/// \param XAYB the XAYB correlation average
+/// \param XBYC the XBYC correlation average
+/// \param Aplus storage for the \f$ A^{+} \f$ rescale parameter
+/// \param Aminus storage for the \f$ A^{-} \f$ rescale parameter
+/// \param LambdaPlus storage for the \f$ \Lambda^{+} \f$ twist parameter
+/// \param LambdaMinus storage for the \f$ \Lambda^{-} \f$ twist parameter
+void QnCorrectionsCoreCorrectionKernels::TwistAndRescaleFromCorrelations(double XAXC, double YAYB, double XAXB, double XBXC, double XAYB, double XBYC,
+    double &Aplus, double &Aminus, double &LambdaPlus, double &LambdaMinus) {
+
+  Aplus = std::sqrt(std::fabs(2.0*XAXC)) * XAXB / std::sqrt(std::fabs(XAXB * XBXC + XAYB * XBYC));
+  Aminus = std::sqrt(std::fabs(2.0*XAXC)) * YAYB / std::sqrt(std::fabs(XAXB * XBXC + XAYB * XBYC));
+  LambdaPlus = XAYB / XAXB;
+  LambdaMinus = XAYB / YAYB;
+}
+
+/// Checks the twist and rescale parameters against the maximum threshold
+/// \param Aplus the \f$ A^{+} \f$ rescale parameter
+/// \param Aminus the \f$ A^{-} \f$ rescale parameter
+/// \param LambdaPlus the \f$ \Lambda^{+} \f$ twist parameter
+/// \param LambdaMinus the \f$ \Lambda^{-} \f$ twist parameter
+/// \param maxThreshold the maximum accepted absolute value
+/// \return true if all parameters are within the threshold
+bool QnCorrectionsCoreCorrectionKernels::TwistAndRescaleParametersValid(double Aplus, double Aminus,
+    double LambdaPlus, double LambdaMinus, double maxThreshold) {
+
+  if (std::fabs(Aplus) > maxThreshold) return false;
+  if (std::fabs(Aminus) > maxThreshold) return false;
+  if (std::fabs(LambdaPlus) > maxThreshold) return false;
+  if (std::fabs(LambdaMinus) > maxThreshold) return false;
+  return true;
+}
+
+/// Divides the values and entries of a profile producing its averages, errors and validation
+///
+/// Bulk version of the bin by bin division of the profiles values by
+/// their entries, operating on the plain bins arrays. Bins with less
+/// entries than the threshold are not validated and get zero average
+/// and error. The bins range is split among the requested number of
+/// threads, each with no less than nMinBinsPerThread bins.
+/// \param nBins the number of linear bins
+/// \param values the sum of values of each bin
+/// \param values2 the sum of squared values of each bin
+/// \param entries the number of entries of each bin
+/// \param minNoOfEntries the minimum number of entries to validate a bin
+/// \param errorOnMean true for the standard error on the mean, false for the standard deviation
+/// \param averages storage for the average of each bin
+/// \param errors2 storage for the squared error of each bin
+/// \param valid storage for the validation of each bin
+/// \param nNoOfThreads the maximum number of threads to use
+/// \return the number of not validated bins with non zero content
+long long QnCorrectionsCoreCorrectionKernels::DivideProfile(long long nBins, const float *values, const double *values2, const int *entries,
+    int minNoOfEntries, bool errorOnMean, float *averages, double *errors2, char *valid, int nNoOfThreads) {
+
+  long long nThreads = (nNoOfThreads < 1) ? 1 : nNoOfThreads;
+  if (nBins / nMinBinsPerThread < nThreads) nThreads = nBins / nMinBinsPerThread;
+  if (nThreads < 2) {
+    return DivideProfileRange(0, nBins, values, values2, entries, minNoOfEntries, errorOnMean, averages, errors2, valid);
+  }
+
+  std::vector<long long> nNotValidated(nThreads, 0);
+  std::vector<std::thread> threads;
+  long long nBinsPerThread = (nBins + nThreads - 1) / nThreads;
+  for (long long ixThread = 0; ixThread < nThreads; ixThread++) {
+    long long firstBin = ixThread * nBinsPerThread;
+    long long lastBin = (nBins < firstBin + nBinsPerThread) ? nBins : firstBin + nBinsPerThread;
+    long long *notValidated = &nNotValidated[ixThread];
+    threads.push_back(std::thread([=]() {
+      *notValidated = DivideProfileRange(firstBin, lastBin, values, values2, entries, minNoOfEntries, errorOnMean, averages, errors2, valid);
+    }));
+  }
+  long long nTotalNotValidated = 0;
+  for (long long ixThread = 0; ixThread < nThreads; ixThread++) {
+    threads[ixThread].join();
+    nTotalNotValidated += nNotValidated[ixThread];
+  }
+  return nTotalNotValidated;
+}
+
+/// Divides the values and entries of a range of profile bins
+///
+/// The loop body has no branches so that the compiler can vectorize it.
+/// \param firstBin the first linear bin of the range
+/// \param lastBin the linear bin after the last one of the range
+/// \param values the sum of values of each bin
+/// \param values2 the sum of squared values of each bin
+/// \param entries the number of entries of each bin
+/// \param minNoOfEntries the minimum number of entries to validate a bin
+/// \param errorOnMean true for the standard error on the mean, false for the standard deviation
+/// \param averages storage for the average of each bin
+/// \param errors2 storage for the squared error of each bin
+/// \param valid storage for the validation of each bin
+/// \return the number of not validated bins with non zero content
+long long QnCorrectionsCoreCorrectionKernels::DivideProfileRange(long long firstBin, long long lastBin,
+    const float *values, const double *values2, const int *entries,
+    int minNoOfEntries, bool errorOnMean, float *averages, double *errors2, char *valid) {
+
+  long long nNotValidated = 0;
+  for (long long bin = firstBin; bin < lastBin; bin++) {
+    bool validated = !(entries[bin] < minNoOfEntries);
+    double nEntries = validated ? double(entries[bin]) : 1.0;
+    double average = values[bin] / nEntries;
+    double variance = std::fabs(values2[bin] / nEntries - average * average);
+    double error2 = errorOnMean ? variance / nEntries : variance;
+    averages[bin] = validated ? float(average) : 0.0f;
+    errors2[bin] = validated ? error2 : 0.0;
+    valid[bin] = validated ? 1 : 0;
+    nNotValidated += (!validated && (values[bin] != 0.0f)) ? 1 : 0;
+  }
+  return nNotValidated;
+}
@@ -0,0 +1,92 @@
+#ifndef QNCORRECTIONS_CORECORRECTIONKERNELS_H
+#define QNCORRECTIONS_CORECORRECTIONKERNELS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreCorrectionKernels.h
+/// \brief ROOT independent correction step kernels for the core engine of the Q vector correction framework
+
+#include <cmath>
+
+/// \class QnCorrectionsCoreCorrectionKernels
+/// \brief The arithmetic of the Qn vector correction steps
+///
+/// Stateless collection of the computations performed by the
+/// Qn vector correction steps once the correction parameters for
+/// the current event class have been obtained. They operate on
+/// plain component values so that they can be used by the core
+/// engine and by the ROOT based correction steps, which rely on
+/// them to guarantee both produce identical results.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreCorrectionKernels {
+public:
+  /// Recentering and optional width equalization of a Qn vector harmonic
+  ///
+  /// \f$ Q' = \frac{Q - \langle Q \rangle}{\sigma_{Q}} \f$
+  ///
+  /// The correction is computed in double precision.
+  /// \param qx the X component, updated with the corrected value
+  /// \param qy the Y component, updated with the corrected value
+  /// \param meanX the X component average for the event class
+  /// \param meanY the Y component average for the event class
+  /// \param widthX the X component width, 1.0 if no width equalization
+  /// \param widthY the Y component width, 1.0 if no width equalization
+  static void Recenter(float &qx, float &qy, double meanX, double meanY, double widthX, double widthY)
+  { qx = float((double(qx) - meanX) / widthX); qy = float((double(qy) - meanY) / widthY); }
+
+  static bool AlignmentAngle(double XX, double YY, double XY, double YX, double eXY, double eYX,
+      int harmonicForAlignment, double &deltaPhi);
+
+  /// Rotates a Qn vector harmonic by the passed angle
+  /// \param qx the X component, updated with the rotated value
+  /// \param qy the Y component, updated with the rotated value
+  /// \param harmonic the harmonic number
+  /// \param deltaPhi the rotation angle
+  static void Rotate(float &qx, float &qy, int harmonic, double deltaPhi) {
+    double cosine = std::cos(((double) harmonic) * deltaPhi);
+    double sine = std::sin(((double) harmonic) * deltaPhi);
+    double x = qx;
+    double y = qy;
+    qx = x * cosine + y * sine;
+    qy = y * cosine - x * sine;
+  }
+
+  static void TwistAndRescaleFromDoubleHarmonic(double X2n, double Y2n,
+      double &Aplus, double &Aminus, double &LambdaPlus, double &LambdaMinus);
+  static void TwistAndRescaleFromCorrelations(double XAXC, double YAYB, double XAXB, double XBXC, double XAYB, double XBYC,
+      double &Aplus, double &Aminus, double &LambdaPlus, double &LambdaMinus);
+  static bool TwistAndRescaleParametersValid(double Aplus, double Aminus, double LambdaPlus, double LambdaMinus, double maxThreshold);
+
+  static long long DivideProfile(long long nBins, const float *values, const double *values2, const int *entries,
+      int minNoOfEntries, bool errorOnMean, float *averages, double *errors2, char *valid, int nNoOfThreads = 1);
+
+  /// Twist correction of a Qn vector harmonic
+  /// \param Qx the X component
+  /// \param Qy the Y component
+  /// \param LambdaPlus the \f$ \Lambda^{+} \f$ twist parameter
+  /// \param LambdaMinus the \f$ \Lambda^{-} \f$ twist parameter
+  /// \param newQx storage for the twisted X component
+  /// \param newQy storage for the twisted Y component
+  static void Twist(double Qx, double Qy, double LambdaPlus, double LambdaMinus, double &newQx, double &newQy) {
+    newQx = (Qx - LambdaMinus * Qy)/(1 - LambdaMinus * LambdaPlus);
+    newQy = (Qy - LambdaPlus * Qx)/(1 - LambdaMinus * LambdaPlus);
+  }
+
+private:
+  static long long DivideProfileRange(long long firstBin, long long lastBin, const float *values, const double *values2, const int *entries,
+      int minNoOfEntries, bool errorOnMean, float *averages, double *errors2, char *valid);
+
+  static const long long nMinBinsPerThread;   ///< the minimum number of bins worth a thread in the profile division
+};
+
+#endif // QNCORRECTIONS_CORECORRECTIONKERNELS_H
@@ -0,0 +1,166 @@
+#ifndef QNCORRECTIONS_CORECUTS_H
+#define QNCORRECTIONS_CORECUTS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreCuts.h
+/// \brief ROOT independent cuts support for the core engine of the Q vector correction framework
+
+#include <cstddef>
+#include <vector>
+
+/// \class QnCorrectionsCoreCut
+/// \brief Plain C++ cut used by the core engine
+///
+/// A single non polymorphic cut that covers the whole family
+/// of QnCorrectionsCutsBase descendants. The kind of cut selects
+/// how the thresholds are interpreted. No virtual call is involved
+/// in its evaluation.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreCut {
+public:
+  /// \enum CutKind
+  /// \brief The supported kinds of cuts
+  enum CutKind {
+    CUT_above,    ///< the value should be above the threshold (QnCorrectionsCutAbove)
+    CUT_below,    ///< the value should be below the threshold (QnCorrectionsCutBelow)
+    CUT_within,   ///< the value should be within the (min, max) range (QnCorrectionsCutWithin)
+    CUT_outside,  ///< the value should be outside the (min, max) range (QnCorrectionsCutOutside)
+    CUT_value,    ///< the value should be equal to the threshold (QnCorrectionsCutValue)
+    CUT_setBit,   ///< the masked value should match the expected result (QnCorrectionsCutSetBit)
+    CUT_external  ///< the cut has no core equivalent and only its framework class can evaluate it
+  };
+
+  /// Default constructor. Builds an always passing cut
+  QnCorrectionsCoreCut() : fKind(CUT_above), fVarId(-1), fMin(0.0), fMax(0.0), fBitMask(0), fExpectedResult(0) {}
+  /// Normal constructor for threshold based cuts
+  /// \param kind the kind of cut
+  /// \param varId the external Id of the variable the cut is applied to
+  /// \param min the threshold or the lower limit
+  /// \param max the upper limit when applicable
+  QnCorrectionsCoreCut(CutKind kind, int varId, float min, float max = 0.0) :
+    fKind(kind), fVarId(varId), fMin(min), fMax(max), fBitMask(0), fExpectedResult(0) {}
+  /// Normal constructor for bit based cuts
+  /// \param varId the external Id of the variable the cut is applied to
+  /// \param mask the bit mask to apply
+  /// \param expected the expected masked value
+  QnCorrectionsCoreCut(int varId, unsigned int mask, unsigned int expected) :
+    fKind(CUT_setBit), fVarId(varId), fMin(0.0), fMax(0.0), fBitMask(mask), fExpectedResult(expected) {}
+
+  /// Gets the variable Id the cut is applied to
+  int GetVariableId() const { return fVarId; }
+  /// Sets the variable Id the cut is applied to
+  /// \param varId the new external variable Id
+  void SetVariableId(int varId) { fVarId = varId; }
+  /// Gets the kind of cut
+  CutKind GetKind() const { return fKind; }
+  /// Checks if the cut can be evaluated by the core engine
+  bool IsFlattenable() const { return (fKind != CUT_external); }
+
+  bool IsSelected(const float *variableContainer) const;
+
+private:
+  CutKind       fKind;            ///< the kind of cut
+  int           fVarId;           ///< the external Id for the variable in the data bank
+  float         fMin;             ///< the threshold or the lower limit
+  float         fMax;             ///< the upper limit
+  unsigned int  fBitMask;         ///< the bit mask for bit cuts
+  unsigned int  fExpectedResult;  ///< the expected masked value for bit cuts
+};
+
+/// Check if the actual variable value passes the cut
+///
+/// Reproduces the behavior of the corresponding QnCorrectionsCutsBase descendant.
+/// External cuts are not flattenable and never pass.
+/// \param variableContainer the current variables content addressed by var Id
+/// \return true if the actual value passes the cut else false
+inline bool QnCorrectionsCoreCut::IsSelected(const float *variableContainer) const {
+  float value = variableContainer[fVarId];
+  switch (fKind) {
+  case CUT_above:
+    return (value > fMin);
+  case CUT_below:
+    return (value < fMin);
+  case CUT_within:
+    return ((fMin < value) && (value < fMax));
+  case CUT_outside:
+    return !((fMin < value) && (value < fMax));
+  case CUT_value:
+    return (value == fMin);
+  case CUT_setBit:
+    return ((((unsigned int) value) & fBitMask) == fExpectedResult);
+  case CUT_external:
+    break;
+  }
+  return false;
+}
+
+/// \class QnCorrectionsCoreCutsSet
+/// \brief Plain C++ set of cuts used by the core engine
+///
+/// Contiguous storage of cuts evaluated in sequence. Equivalent
+/// to QnCorrectionsCutsSet.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreCutsSet {
+public:
+  QnCorrectionsCoreCutsSet() : fCuts() {}
+
+  /// Adds a cut to the set
+  /// \param cut the cut to add
+  void Add(const QnCorrectionsCoreCut &cut) { fCuts.push_back(cut); }
+  /// Gets the number of cuts in the set
+  int GetEntries() const { return int(fCuts.size()); }
+  /// Access the cut at the passed position
+  /// \param i position in the set (starting at zero)
+  const QnCorrectionsCoreCut &At(int i) const { return fCuts[i]; }
+  /// Access the cut at the passed position for modification
+  /// \param i position in the set (starting at zero)
+  QnCorrectionsCoreCut &At(int i) { return fCuts[i]; }
+  /// Removes all cuts from the set
+  void Clear() { fCuts.clear(); }
+
+  bool IsSelected(const float *variableContainer) const;
+  bool IsFlattenable() const;
+
+private:
+  std::vector<QnCorrectionsCoreCut> fCuts;   ///< the cuts in the set
+};
+
+/// Checks that the current content of the variableContainer passes
+/// the whole set of cuts
+///
+/// \param variableContainer the current variables content addressed by var Id
+/// \return true if the actual values pass the set of cuts else false
+inline bool QnCorrectionsCoreCutsSet::IsSelected(const float *variableContainer) const {
+  for (size_t icut = 0; icut < fCuts.size(); icut++) {
+    if (!fCuts[icut].IsSelected(variableContainer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Checks that the whole set of cuts can be evaluated by the core engine
+/// \return true if none of the cuts is an external one
+inline bool QnCorrectionsCoreCutsSet::IsFlattenable() const {
+  for (size_t icut = 0; icut < fCuts.size(); icut++) {
+    if (!fCuts[icut].IsFlattenable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif // QNCORRECTIONS_CORECUTS_H
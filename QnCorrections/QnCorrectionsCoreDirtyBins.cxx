@@ -0,0 +1,64 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreDirtyBins.cxx
+/// \brief Implementation of the ROOT independent changed histogram bins tracker class
+
+#include "QnCorrectionsCoreDirtyBins.h"
+#include <cstddef>
+
+/// Default constructor
+///
+/// No bin is marked as changed.
+QnCorrectionsCoreDirtyBins::QnCorrectionsCoreDirtyBins() :
+  fFlags(),
+  fBins() {
+}
+
+/// Unmarks the changed bins
+///
+/// Only the flags of the changed bins are reset.
+void QnCorrectionsCoreDirtyBins::Clear() {
+  for (size_t ixBin = 0; ixBin < fBins.size(); ixBin++) {
+    fFlags[fBins[ixBin]] = false;
+  }
+  fBins.clear();
+}
+
+/// Grows the bins flags to accommodate the passed bin
+///
+/// The flags size is at least doubled to amortize the growth.
+/// \param bin the linear bin number
+void QnCorrectionsCoreDirtyBins::Grow(long long bin) {
+  size_t size = 2 * fFlags.size();
+  if (size < size_t(bin + 1)) size = size_t(bin + 1);
+  fFlags.resize(size, false);
+}
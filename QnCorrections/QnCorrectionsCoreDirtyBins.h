@@ -0,0 +1,57 @@
+#ifndef QNCORRECTIONS_COREDIRTYBINS_H
+#define QNCORRECTIONS_COREDIRTYBINS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreDirtyBins.h
+/// \brief ROOT independent tracker of the histogram bins changed since a given point
+
+#include <vector>
+
+/// \class QnCorrectionsCoreDirtyBins
+/// \brief Plain C++ set of the histogram bins changed since last cleared
+///
+/// Keeps, for a target histogram, the list of linear bin numbers
+/// that changed since the tracker was last cleared, each of them
+/// only once and in the order they were first changed. A flag per
+/// bin avoids duplicates. Both marking a bin and clearing the tracker
+/// have a cost proportional to the number of changed bins and not to
+/// the histogram size, the flags are grown on demand as higher bin
+/// numbers are marked.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreDirtyBins {
+public:
+  QnCorrectionsCoreDirtyBins();
+
+  /// Marks the passed bin as changed
+  /// \param bin the linear bin number
+  void Mark(long long bin)
+  { if (!(bin < (long long) fFlags.size())) Grow(bin); if (!fFlags[bin]) { fFlags[bin] = true; fBins.push_back(bin); } }
+  void Clear();
+
+  /// Gets whether there are changed bins
+  bool IsEmpty() const { return fBins.empty(); }
+  /// Gets the number of changed bins
+  int GetNoOfBins() const { return int(fBins.size()); }
+  /// Gets the linear bin number of the passed changed bin
+  /// \param entry the changed bin order
+  long long GetBin(int entry) const { return fBins[entry]; }
+
+private:
+  void Grow(long long bin);
+
+  std::vector<bool> fFlags;     ///< the changed flag of each bin
+  std::vector<long long> fBins; ///< the changed bins
+};
+
+#endif // QNCORRECTIONS_COREDIRTYBINS_H
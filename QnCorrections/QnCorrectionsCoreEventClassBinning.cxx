@@ -0,0 +1,138 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreEventClassBinning.cxx
+/// \brief Implementation of the ROOT independent event class binning class
+
+#include "QnCorrectionsCoreEventClassBinning.h"
+#include <cmath>
+
+/// Default constructor
+QnCorrectionsCoreEventClassBinning::QnCorrectionsCoreEventClassBinning() :
+  fAxes(),
+  fNLinearBins(1) {
+}
+
+/// Adds a new axis with explicit bin edges
+///
+/// The new axis becomes the fastest running one in the linear bin number.
+/// The bins are checked for uniformity to select the bin location scheme.
+/// \param varId the external variable Id, negative if the axis values are given externally
+/// \param nbins the number of bins
+/// \param edges the bins edges array, nbins + 1 values
+void QnCorrectionsCoreEventClassBinning::AddAxis(int varId, int nbins, const double *edges) {
+  Axis axis;
+  axis.fVarId = varId;
+  axis.fNBins = nbins;
+  axis.fEdges.assign(edges, edges + nbins + 1);
+  axis.fStride = 1;
+  /* check whether the bins are uniform within rounding */
+  double width = (edges[nbins] - edges[0]) / nbins;
+  axis.fUniform = true;
+  for (int i = 1; i < nbins + 1; i++) {
+    if (std::fabs(edges[i] - (edges[0] + i * width)) > 1e-6 * width) {
+      axis.fUniform = false;
+      break;
+    }
+  }
+  axis.fInvWidth = 1.0 / width;
+  fAxes.push_back(axis);
+  UpdateStrides();
+}
+
+/// Adds a new axis with uniform bins
+///
+/// The bin edges are built in the same way than QnCorrectionsEventClassVariable does
+/// \param varId the external variable Id
+/// \param nbins the number of bins
+/// \param min lower edge value for the first bin
+/// \param max upper edge value for the last bin
+void QnCorrectionsCoreEventClassBinning::AddAxis(int varId, int nbins, double min, double max) {
+  std::vector<double> edges(nbins + 1);
+  double low = min;
+  double width = (max - min) / nbins;
+  for (int i = 0; i < nbins + 1; i++) {
+    edges[i] = low;
+    low += width;
+  }
+  AddAxis(varId, nbins, &edges[0]);
+}
+
+/// Recomputes the axes strides and the total number of linear bins
+///
+/// The last axis is the one that runs faster
+void QnCorrectionsCoreEventClassBinning::UpdateStrides() {
+  fNLinearBins = 1;
+  for (int axis = int(fAxes.size()) - 1; axis >= 0; axis--) {
+    fAxes[axis].fStride = fNLinearBins;
+    fNLinearBins *= (fAxes[axis].fNBins + 2);
+  }
+}
+
+/// Registers the axes variable ids for their remapping into a dense variables bank
+/// \param bank the variables bank remapper
+void QnCorrectionsCoreEventClassBinning::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    bank.Register(fAxes[axis].fVarId);
+  }
+}
+
+/// Gets the linear bin number for the passed axes values
+/// \param values the values, one per axis
+/// \return the linear bin number
+long long QnCorrectionsCoreEventClassBinning::GetBinFromValues(const double *values) const {
+  long long bin = 0;
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    bin += FindAxisBin(int(axis), values[axis]) * fAxes[axis].fStride;
+  }
+  return bin;
+}
+
+/// Gets the linear bin number for the passed axes bin numbers
+/// \param coordinates the bin numbers, one per axis
+/// \return the linear bin number
+long long QnCorrectionsCoreEventClassBinning::GetBinFromCoordinates(const int *coordinates) const {
+  long long bin = 0;
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    bin += coordinates[axis] * fAxes[axis].fStride;
+  }
+  return bin;
+}
+
+/// Gets the axes bin numbers for the passed linear bin number
+/// \param bin the linear bin number
+/// \param coordinates storage for the bin numbers, one per axis
+void QnCorrectionsCoreEventClassBinning::GetCoordinates(long long bin, int *coordinates) const {
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    coordinates[axis] = int(bin / fAxes[axis].fStride);
+    bin = bin % fAxes[axis].fStride;
+  }
+}
@@ -0,0 +1,157 @@
+#ifndef QNCORRECTIONS_COREEVENTCLASSBINNING_H
+#define QNCORRECTIONS_COREEVENTCLASSBINNING_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreEventClassBinning.h
+/// \brief ROOT independent event class binning for the core engine of the Q vector correction framework
+
+#include <cstddef>
+#include <vector>
+#include "QnCorrectionsCoreVariablesBank.h"
+
+/// \class QnCorrectionsCoreEventClassBinning
+/// \brief Plain C++ multidimensional event class binning
+///
+/// Holds, for each event class variable, its external variable Id
+/// and its bin edges. Computes the linear bin number for the current
+/// content of the variables bank with the same layout used by
+/// the THn histograms of the framework: each axis includes its
+/// underflow (0) and overflow (nbins+1) bins and the last axis is
+/// the one that runs faster. In that way the linear bin numbers
+/// produced here can be used to address the THn histograms
+/// content and vice versa.
+///
+/// The bin location along each axis is tailored to the axis edges.
+/// Axes with uniform bins are located with plain arithmetic while
+/// segmented axes, as the ones produced from several binning ranges,
+/// use a branchless search on the edges. In both cases the result is
+/// exactly the one TAxis::FindBin produces for the same edges.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreEventClassBinning {
+public:
+  QnCorrectionsCoreEventClassBinning();
+
+  void AddAxis(int varId, int nbins, const double *edges);
+  void AddAxis(int varId, int nbins, double min, double max);
+  /// Removes all the axes
+  void Clear() { fAxes.clear(); fNLinearBins = 1; }
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+
+  /// Gets the number of axes (dimensions)
+  int GetNDimensions() const { return int(fAxes.size()); }
+  /// Gets the external variable Id associated to the passed axis
+  /// \param axis the axis number
+  int GetVariableId(int axis) const { return fAxes[axis].fVarId; }
+  /// Gets the number of bins of the passed axis
+  /// \param axis the axis number
+  int GetNBins(int axis) const { return fAxes[axis].fNBins; }
+  /// Gets the bin edges of the passed axis
+  /// \param axis the axis number
+  const double *GetEdges(int axis) const { return &(fAxes[axis].fEdges[0]); }
+  /// Gets the linear stride of the passed axis
+  /// \param axis the axis number
+  long long GetStride(int axis) const { return fAxes[axis].fStride; }
+  /// Gets the total number of linear bins including under and overflow bins
+  long long GetNLinearBins() const { return fNLinearBins; }
+
+  int FindAxisBin(int axis, double value) const;
+  long long GetBin(const float *variableContainer) const;
+  long long GetBin(const float *variableContainer, double extraValue) const;
+  long long GetBinFromValues(const double *values) const;
+  long long GetBinFromCoordinates(const int *coordinates) const;
+  void GetCoordinates(long long bin, int *coordinates) const;
+
+private:
+  void UpdateStrides();
+
+  /// \struct Axis
+  /// \brief The information kept for each event class variable
+  struct Axis {
+    int fVarId;                 ///< the external variable Id
+    int fNBins;                 ///< the number of bins
+    std::vector<double> fEdges; ///< the bins edges, fNBins + 1 values
+    long long fStride;          ///< the linear stride for the axis
+    bool fUniform;              ///< the axis bins are uniform
+    double fInvWidth;           ///< the inverse of the bin width for uniform axes
+  };
+
+  std::vector<Axis> fAxes;      ///< the axes
+  long long fNLinearBins;       ///< total number of linear bins, under and overflow included
+};
+
+/// Gets the bin number along the passed axis for the passed value
+///
+/// Same convention than TAxis::FindBin for non extensible axes with
+/// explicit bin edges: 0 for underflow, nbins+1 for overflow.
+/// For uniform axes the bin is guessed arithmetically and then
+/// adjusted against the actual edges so that rounding never makes
+/// it differ from the edges search result.
+/// \param axis the axis number
+/// \param value the value to locate
+/// \return the bin number along the axis
+inline int QnCorrectionsCoreEventClassBinning::FindAxisBin(int axis, double value) const {
+  const Axis &ax = fAxes[axis];
+  const double *edges = &ax.fEdges[0];
+  if (value < edges[0]) return 0;
+  if (!(value < edges[ax.fNBins])) return ax.fNBins + 1;
+  if (ax.fUniform) {
+    int bin = int((value - edges[0]) * ax.fInvWidth);
+    if (!(bin < ax.fNBins)) bin = ax.fNBins - 1;
+    while (value < edges[bin]) bin--;
+    while (!(value < edges[bin + 1])) bin++;
+    return bin + 1;
+  }
+  else {
+    /* branchless search of the largest edge lower or equal than value */
+    const double *base = edges;
+    int length = ax.fNBins;
+    while (length > 1) {
+      int half = length / 2;
+      base = (base[half] <= value) ? base + half : base;
+      length -= half;
+    }
+    return int(base - edges) + 1;
+  }
+}
+
+/// Gets the linear bin number for the current content of the variables bank
+/// \param variableContainer the current variables content addressed by var Id
+/// \return the linear bin number
+inline long long QnCorrectionsCoreEventClassBinning::GetBin(const float *variableContainer) const {
+  long long bin = 0;
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    bin += FindAxisBin(int(axis), double(variableContainer[fAxes[axis].fVarId])) * fAxes[axis].fStride;
+  }
+  return bin;
+}
+
+/// Gets the linear bin number for the current content of the variables bank
+/// and an extra value
+///
+/// The axes not associated to an external variable, i.e. with a negative
+/// variable Id, take the extra value. Used for the channel or group axis
+/// of the channelized histograms.
+/// \param variableContainer the current variables content addressed by var Id
+/// \param extraValue the value for the axes without external variable
+/// \return the linear bin number
+inline long long QnCorrectionsCoreEventClassBinning::GetBin(const float *variableContainer, double extraValue) const {
+  long long bin = 0;
+  for (size_t axis = 0; axis < fAxes.size(); axis++) {
+    double value = (fAxes[axis].fVarId < 0) ? extraValue : double(variableContainer[fAxes[axis].fVarId]);
+    bin += FindAxisBin(int(axis), value) * fAxes[axis].fStride;
+  }
+  return bin;
+}
+
+#endif // QNCORRECTIONS_COREEVENTCLASSBINNING_H
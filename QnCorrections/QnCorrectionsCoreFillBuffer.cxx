@@ -0,0 +1,87 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreFillBuffer.cxx
+/// \brief Implementation of the ROOT independent histogram fill buffer class
+
+#include "QnCorrectionsCoreFillBuffer.h"
+#include <algorithm>
+
+/// Default constructor
+///
+/// The buffer is not in use.
+QnCorrectionsCoreFillBuffer::QnCorrectionsCoreFillBuffer() :
+  fCapacity(0),
+  fFills() {
+}
+
+/// Normal constructor
+/// \param capacity the maximum number of fills before the buffer is full, zero for not using the buffer
+QnCorrectionsCoreFillBuffer::QnCorrectionsCoreFillBuffer(int capacity) :
+  fCapacity(0),
+  fFills() {
+  SetCapacity(capacity);
+}
+
+/// Sets the maximum number of fills kept before the buffer is full
+///
+/// Should be called with the buffer empty.
+/// \param capacity the maximum number of fills, zero for not using the buffer
+void QnCorrectionsCoreFillBuffer::SetCapacity(int capacity) {
+  fCapacity = (capacity < 0) ? 0 : capacity;
+  fFills.clear();
+  fFills.reserve(fCapacity);
+}
+
+/// Sorts the fills by target and bin and coalesces the ones for the same target bin
+///
+/// The sort is stable so, within each target bin, the values are
+/// summed in the order they were stored.
+/// \return the number of coalesced entries
+int QnCorrectionsCoreFillBuffer::Coalesce() {
+  if (fFills.empty()) return 0;
+
+  std::stable_sort(fFills.begin(), fFills.end(), FillLess());
+  size_t last = 0;
+  for (size_t ixFill = 1; ixFill < fFills.size(); ixFill++) {
+    if ((fFills[ixFill].fTarget == fFills[last].fTarget) && (fFills[ixFill].fBin == fFills[last].fBin)) {
+      fFills[last].fSumValues += fFills[ixFill].fSumValues;
+      fFills[last].fSumValues2 += fFills[ixFill].fSumValues2;
+      fFills[last].fNoOfFills += fFills[ixFill].fNoOfFills;
+    }
+    else {
+      last++;
+      fFills[last] = fFills[ixFill];
+    }
+  }
+  fFills.resize(last + 1);
+  return int(fFills.size());
+}
@@ -0,0 +1,101 @@
+#ifndef QNCORRECTIONS_COREFILLBUFFER_H
+#define QNCORRECTIONS_COREFILLBUFFER_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreFillBuffer.h
+/// \brief ROOT independent histogram fill buffer for the core engine of the Q vector correction framework
+
+#include <vector>
+
+/// \class QnCorrectionsCoreFillBuffer
+/// \brief Plain C++ buffer of deferred histogram fills
+///
+/// Keeps up to a fixed number of fills, each of them as the
+/// target histogram, the linear bin number and the value to
+/// accumulate. When the buffer is full, or when explicitly requested,
+/// the fills are sorted by target and bin and the fills for the same
+/// target bin are coalesced into a single entry with the sum of
+/// values, the sum of squared values and the number of fills. The
+/// owner then performs one update per coalesced entry, in increasing
+/// bin order, instead of a scattered update per fill.
+///
+/// The targets are small integers assigned by the buffer owner and the
+/// linear bin numbers are the ones produced by QnCorrectionsCoreEventClassBinning
+/// or by the target histogram itself.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreFillBuffer {
+public:
+  QnCorrectionsCoreFillBuffer();
+  QnCorrectionsCoreFillBuffer(int capacity);
+
+  void SetCapacity(int capacity);
+  /// Gets the maximum number of fills kept before the buffer is full
+  int GetCapacity() const { return fCapacity; }
+  /// Gets whether the buffer is in use
+  bool IsEnabled() const { return 0 < fCapacity; }
+  /// Gets whether the buffer has no pending fills
+  bool IsEmpty() const { return fFills.empty(); }
+
+  /// Stores a new fill
+  /// \param target the target histogram
+  /// \param bin the linear bin number within the target histogram
+  /// \param value the value to accumulate
+  /// \return true if the buffer is full and has to be flushed
+  bool Add(int target, long long bin, double value)
+  { Fill fill = { target, bin, value, value * value, 1 }; fFills.push_back(fill); return !(int(fFills.size()) < fCapacity); }
+
+  int Coalesce();
+  /// Removes all the fills
+  void Clear() { fFills.clear(); }
+
+  /// Gets the number of stored fills, the number of coalesced entries after Coalesce
+  int GetNoOfEntries() const { return int(fFills.size()); }
+  /// Gets the target histogram of the passed entry
+  /// \param entry the entry number
+  int GetTarget(int entry) const { return fFills[entry].fTarget; }
+  /// Gets the linear bin number of the passed entry
+  /// \param entry the entry number
+  long long GetBin(int entry) const { return fFills[entry].fBin; }
+  /// Gets the sum of values of the passed entry
+  /// \param entry the entry number
+  double GetSumValues(int entry) const { return fFills[entry].fSumValues; }
+  /// Gets the sum of squared values of the passed entry
+  /// \param entry the entry number
+  double GetSumValues2(int entry) const { return fFills[entry].fSumValues2; }
+  /// Gets the number of fills coalesced in the passed entry
+  /// \param entry the entry number
+  int GetNoOfFills(int entry) const { return fFills[entry].fNoOfFills; }
+
+private:
+  /// \struct Fill
+  /// \brief A pending fill or a set of coalesced fills
+  struct Fill {
+    int fTarget;                ///< the target histogram
+    long long fBin;             ///< the linear bin number
+    double fSumValues;          ///< the sum of the values
+    double fSumValues2;         ///< the sum of the squared values
+    int fNoOfFills;             ///< the number of fills
+  };
+  /// \struct FillLess
+  /// \brief Orders the fills by target and bin
+  struct FillLess {
+    bool operator()(const Fill &a, const Fill &b) const
+    { return (a.fTarget < b.fTarget) || ((a.fTarget == b.fTarget) && (a.fBin < b.fBin)); }
+  };
+
+  int fCapacity;                ///< the maximum number of fills before the buffer is full
+  std::vector<Fill> fFills;     ///< the pending fills
+};
+
+#endif // QNCORRECTIONS_COREFILLBUFFER_H
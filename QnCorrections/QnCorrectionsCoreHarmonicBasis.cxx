@@ -0,0 +1,83 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreHarmonicBasis.cxx
+/// \brief Implementation of the ROOT independent harmonic basis cache class
+
+#include "QnCorrectionsCoreHarmonicBasis.h"
+#include <cmath>
+
+/// Default constructor
+///
+/// Only the zero term is held.
+QnCorrectionsCoreHarmonicBasis::QnCorrectionsCoreHarmonicBasis() :
+  fHighestTerm(0),
+  fStride(2),
+  fNoOfRows(0),
+  fTerms() {
+}
+
+/// Sets the highest term the rows should hold
+///
+/// The current rows are removed.
+/// \param highestTerm the highest term number
+void QnCorrectionsCoreHarmonicBasis::SetHighestTerm(int highestTerm) {
+  fHighestTerm = highestTerm;
+  fStride = 2 * (highestTerm + 1);
+  fNoOfRows = 0;
+  fTerms.clear();
+}
+
+/// Reserves the storage for the passed number of rows
+///
+/// Events with up to that number of rows will not grow the storage
+/// \param nNoOfRows the number of rows
+void QnCorrectionsCoreHarmonicBasis::Reserve(int nNoOfRows) {
+  if (fTerms.size() < size_t(nNoOfRows) * fStride) fTerms.resize(size_t(nNoOfRows) * fStride);
+}
+
+/// Adds a row with the terms of the passed azimuthal angle
+///
+/// The storage is doubled when full to amortize its growth.
+/// \param phi the azimuthal angle
+/// \return the number of the new row
+int QnCorrectionsCoreHarmonicBasis::AddRow(double phi) {
+  if (fTerms.size() < size_t(fNoOfRows + 1) * fStride) fTerms.resize(2 * size_t(fNoOfRows + 1) * fStride);
+  double *cosTerms = &fTerms[fNoOfRows * fStride];
+  double *sinTerms = cosTerms + fHighestTerm + 1;
+  cosTerms[0] = 1.0;
+  sinTerms[0] = 0.0;
+  for (int k = 1; k < fHighestTerm + 1; k++) {
+    cosTerms[k] = std::cos(k*phi);
+    sinTerms[k] = std::sin(k*phi);
+  }
+  return fNoOfRows++;
+}
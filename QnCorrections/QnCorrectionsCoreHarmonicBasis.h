@@ -0,0 +1,60 @@
+#ifndef QNCORRECTIONS_COREHARMONICBASIS_H
+#define QNCORRECTIONS_COREHARMONICBASIS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreHarmonicBasis.h
+/// \brief ROOT independent cache of the harmonic basis values of the data vectors of an event
+
+#include <vector>
+
+/// \class QnCorrectionsCoreHarmonicBasis
+/// \brief Plain C++ store of the cosine and sine terms of the data vectors azimuthal angles
+///
+/// Keeps, for each data vector of the current event, a row with the
+/// \f$ \cos(k\varphi) \f$ and \f$ \sin(k\varphi) \f$ terms for k up to
+/// the highest term needed. The terms are evaluated once when the row
+/// is added and afterwards shared by whoever builds Q vectors from the
+/// data vector. The storage is kept across events and only grows when
+/// an event has more rows than any previous one.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreHarmonicBasis {
+public:
+  QnCorrectionsCoreHarmonicBasis();
+
+  void SetHighestTerm(int highestTerm);
+  /// Gets the highest term the rows hold
+  int GetHighestTerm() const { return fHighestTerm; }
+  void Reserve(int nNoOfRows);
+
+  int AddRow(double phi);
+  /// Removes all rows keeping the storage
+  void Clear() { fNoOfRows = 0; }
+
+  /// Gets the number of rows
+  int GetNoOfRows() const { return fNoOfRows; }
+  /// Gets the cosine terms of the passed row, indexed by the term number
+  /// \param row the row number
+  const double *GetCos(int row) const { return &fTerms[row * fStride]; }
+  /// Gets the sine terms of the passed row, indexed by the term number
+  /// \param row the row number
+  const double *GetSin(int row) const { return &fTerms[row * fStride + fHighestTerm + 1]; }
+
+private:
+  int fHighestTerm;            ///< the highest term held in each row
+  int fStride;                 ///< the number of values of each row
+  int fNoOfRows;               ///< the number of rows of the current event
+  std::vector<double> fTerms;  ///< the rows, cosine terms followed by sine terms
+};
+
+#endif // QNCORRECTIONS_COREHARMONICBASIS_H
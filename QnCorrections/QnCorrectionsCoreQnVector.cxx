@@ -0,0 +1,194 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreQnVector.cxx
+/// \brief Implementation of the ROOT independent Q vector class
+
+#include "QnCorrectionsCoreQnVector.h"
+
+const float QnCorrectionsCoreQnVector::fMinimumSignificantValue = 1e-6;
+
+/// Default constructor
+QnCorrectionsCoreQnVector::QnCorrectionsCoreQnVector() {
+  memset(fQnX, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  memset(fQnY, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  fHighestHarmonic = 0;
+  fHarmonicMask = 0x0000;
+  fGoodQuality = false;
+  fN = 0;
+  fSumW = 0.0;
+  fHarmonicMultiplier = 1;
+}
+
+/// Normal constructor
+///
+/// Same harmonic numbering scheme than QnCorrectionsQnVector.
+/// If no map is passed as parameter the external harmonic
+/// numbers are considered as: 1, 2, ..., nNoOfHarmonic.
+/// Harmonics beyond the supported range are ignored.
+///
+/// \param nNoOfHarmonics the desired number of harmonics
+/// \param harmonicMap ordered array with the external number of the harmonics
+QnCorrectionsCoreQnVector::QnCorrectionsCoreQnVector(int nNoOfHarmonics, const int *harmonicMap) {
+  memset(fQnX, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  memset(fQnY, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  fHighestHarmonic = 0;
+  fHarmonicMask = 0x0000;
+  fGoodQuality = false;
+  fN = 0;
+  fSumW = 0.0;
+  fHarmonicMultiplier = 1;
+
+  for (int h = 0; h < nNoOfHarmonics; h++) {
+    ActivateHarmonic((harmonicMap != NULL) ? harmonicMap[h] : h + 1);
+  }
+}
+
+/// Activates the desired harmonic for processing
+///
+/// If the harmonic was not active its Q vector is initialized.
+/// \param harmonic the intended harmonic
+/// \return false if the harmonic is beyond the supported range
+bool QnCorrectionsCoreQnVector::ActivateHarmonic(int harmonic) {
+  if ((harmonic < 1) || (COREMAXHARMONICNUMBERSUPPORTED < harmonic)) return false;
+
+  if (!IsActive(harmonic)) {
+    fHarmonicMask |= (1U << harmonic);
+    fQnX[harmonic] = 0.0;
+    fQnY[harmonic] = 0.0;
+  }
+  if (fHighestHarmonic < harmonic) fHighestHarmonic = harmonic;
+  return true;
+}
+
+/// Checks whether the passed Q vector has the same harmonic structure
+/// \param Qn the Q vector to compare with
+/// \return true if the harmonic structures match
+bool QnCorrectionsCoreQnVector::IsSameStructure(const QnCorrectionsCoreQnVector &Qn) const {
+  return ((fHighestHarmonic == Qn.fHighestHarmonic) &&
+      (fHarmonicMask == Qn.fHarmonicMask) &&
+      (fHarmonicMultiplier == Qn.fHarmonicMultiplier));
+}
+
+/// Copies the values of the passed Q vector
+///
+/// Only the active harmonics are copied. The harmonic structure
+/// is expected to match, it is responsibility of the caller to
+/// check it with IsSameStructure if needed.
+/// \param Qn the Q vector to copy the values from
+void QnCorrectionsCoreQnVector::CopyValues(const QnCorrectionsCoreQnVector &Qn) {
+  for (int h = 1; h < fHighestHarmonic + 1; h++) {
+    if (IsActive(h)) {
+      fQnX[h] = Qn.fQnX[h];
+      fQnY[h] = Qn.fQnY[h];
+    }
+  }
+  fGoodQuality = Qn.fGoodQuality;
+  fN = Qn.fN;
+  fSumW = Qn.fSumW;
+}
+
+/// Adds the content of other Q vector with the same harmonic structure
+/// \param Qn the Q vector to add
+void QnCorrectionsCoreQnVector::Add(const QnCorrectionsCoreQnVector &Qn) {
+  for (int h = 1; h < fHighestHarmonic + 1; h++) {
+    if (IsActive(h)) {
+      fQnX[h] += Qn.fQnX[h];
+      fQnY[h] += Qn.fQnY[h];
+    }
+  }
+  fSumW += Qn.fSumW;
+  fN += Qn.fN;
+}
+
+/// Normalizes the Q vector according to the method passed
+///
+/// Same criteria than QnCorrectionsQnVectorBuild: if the sum of weights
+/// is not significant the Q vector quality is set as bad.
+/// \param method the normalization method
+void QnCorrectionsCoreQnVector::Normalize(NormalizationMethod method) {
+  switch (method) {
+  case NORM_noCalibration:
+    break;
+  case NORM_QoverSqrtM:
+  case NORM_QoverM:
+    if (fSumW < fMinimumSignificantValue) {
+      fGoodQuality = false;
+    }
+    else {
+      float norm = (method == NORM_QoverM) ? fSumW : std::sqrt(fSumW);
+      for (int h = 1; h < fHighestHarmonic + 1; h++) {
+        if (IsActive(h)) {
+          fQnX[h] = fQnX[h] / norm;
+          fQnY[h] = fQnY[h] / norm;
+        }
+      }
+    }
+    break;
+  case NORM_QoverQlength:
+    for (int h = 1; h < fHighestHarmonic + 1; h++) {
+      if (IsActive(h)) {
+        float length = Length(h);
+        if (length < fMinimumSignificantValue) {
+          fQnX[h] = 0.0;
+          fQnY[h] = 0.0;
+        }
+        else {
+          fQnX[h] = fQnX[h] / length;
+          fQnY[h] = fQnY[h] / length;
+        }
+      }
+    }
+    break;
+  }
+}
+
+/// Resets the Q vector values without touching the structure
+void QnCorrectionsCoreQnVector::Reset() {
+  memset(fQnX, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  memset(fQnY, 0, (COREMAXHARMONICNUMBERSUPPORTED + 1)*sizeof(float));
+  fGoodQuality = false;
+  fN = 0;
+  fSumW = 0.0;
+}
+
+/// Gets the event plane for the asked harmonic
+///
+/// A check for significant values is made. Not passing them
+/// returns 0.0.
+/// \param harmonic the intended harmonic number
+/// \return The event plane according to \f$\frac{1}{h}\tan^{-1}{\frac{Qh_X}{Qh_Y}}\f$
+double QnCorrectionsCoreQnVector::EventPlane(int harmonic) const {
+  if (std::fabs(fQnX[harmonic]) < fMinimumSignificantValue && std::fabs(fQnY[harmonic]) < fMinimumSignificantValue) {
+    return 0.0;
+  }
+  return std::atan2(fQnY[harmonic], fQnX[harmonic])/double(harmonic*fHarmonicMultiplier);
+}
@@ -0,0 +1,172 @@
+#ifndef QNCORRECTIONS_COREQNVECTOR_H
+#define QNCORRECTIONS_COREQNVECTOR_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreQnVector.h
+/// \brief ROOT independent Q vector for the core engine of the Q vector correction framework
+
+#include <cmath>
+#include <cstring>
+
+/// The maximum external harmonic number the core engine currently support for Q vectors
+#define COREMAXHARMONICNUMBERSUPPORTED 15
+
+/// \class QnCorrectionsCoreQnVector
+/// \brief Plain C++ Q vector used by the core engine
+///
+/// Mirrors the memory layout and behavior of QnCorrectionsQnVector and
+/// QnCorrectionsQnVectorBuild but without any ROOT dependency so that
+/// it can be embedded in lightweight processes. The harmonics are
+/// addressed by their external number and only the ones active in
+/// the harmonic mask are processed.
+///
+/// No dynamic memory is used. Copies are plain structure copies.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreQnVector {
+public:
+  /// \enum NormalizationMethod
+  /// \brief The supported Q vector normalization methods
+  ///
+  /// Same values and meaning than QnCorrectionsQnVector::QnVectorNormalizationMethod
+  enum NormalizationMethod {
+    NORM_noCalibration, ///< \f$ \mbox{Q'} = \mbox{Q}\f$
+    NORM_QoverSqrtM,    ///< \f$ \mbox{Q'} = \frac{\mbox{Q}}{\sqrt{\mbox{M}}} \f$
+    NORM_QoverM,        ///< \f$ \mbox{Q'} = \frac{\mbox{Q}}{\mbox{M}} \f$
+    NORM_QoverQlength   ///< \f$ \mbox{Q'} = \frac{\mbox{Q}}{|\mbox{Q}|} \f$
+  };
+
+  QnCorrectionsCoreQnVector();
+  QnCorrectionsCoreQnVector(int nNoOfHarmonics, const int *harmonicMap = NULL);
+
+  bool ActivateHarmonic(int harmonic);
+  /// Get the mask of active harmonics
+  /// \return the harmonic mask, bit h set for active harmonic h
+  unsigned int GetHarmonicMask() const { return fHarmonicMask; }
+  /// Get the highest active harmonic
+  /// \return the highest harmonic number
+  int GetHighestHarmonic() const { return fHighestHarmonic; }
+  int GetFirstHarmonic() const;
+  int GetNextHarmonic(int harmonic) const;
+  /// Get the harmonic multiplier
+  /// \return the harmonic multiplier
+  int GetHarmonicMultiplier() const { return fHarmonicMultiplier; }
+  /// Set the harmonic multiplier
+  /// With it different from one Qn behaves as Qmxn.
+  /// \param m the harmonic multiplier
+  void SetHarmonicMultiplier(int m) { fHarmonicMultiplier = m; }
+
+  bool IsSameStructure(const QnCorrectionsCoreQnVector &Qn) const;
+  void CopyValues(const QnCorrectionsCoreQnVector &Qn);
+
+  /// Gets the Q vector X component for the considered harmonic
+  /// \param harmonic the intended harmonic
+  float Qx(int harmonic) const { return fQnX[harmonic]; }
+  /// Gets the Q vector Y component for the considered harmonic
+  /// \param harmonic the intended harmonic
+  float Qy(int harmonic) const { return fQnY[harmonic]; }
+  /// Sets the X component for the considered harmonic
+  /// \param harmonic the intended harmonic
+  /// \param qx the X component for the Q vector
+  void SetQx(int harmonic, float qx) { fQnX[harmonic] = qx; }
+  /// Sets the Y component for the considered harmonic
+  /// \param harmonic the intended harmonic
+  /// \param qy the Y component for the Q vector
+  void SetQy(int harmonic, float qy) { fQnY[harmonic] = qy; }
+  /// Gets the X components array addressed by external harmonic number
+  const float *GetQx() const { return fQnX; }
+  /// Gets the Y components array addressed by external harmonic number
+  const float *GetQy() const { return fQnY; }
+  /// Provides the length of the Q vector for the considered harmonic
+  /// \param harmonic the intended harmonic
+  float Length(int harmonic) const { return std::sqrt(fQnX[harmonic]*fQnX[harmonic]+fQnY[harmonic]*fQnY[harmonic]); }
+
+  /// Get the Qn vector quality flag
+  bool IsGoodQuality() const { return fGoodQuality; }
+  /// Set the good quality flag
+  /// \param good true if the quality is good
+  void SetGood(bool good) { fGoodQuality = good; }
+  /// Gets the number of elements that were used for Q vector building
+  int GetN() const { return fN; }
+  /// Gets the sum of weights of the elements that were used for Q vector building
+  float GetSumOfWeights() const { return fSumW; }
+  /// Sets the building counters
+  /// \param n number of elements
+  /// \param sumw sum of weights
+  void SetCounters(int n, float sumw) { fN = n; fSumW = sumw; }
+
+  void Add(double phi, double weight = 1.0);
+  void Add(const QnCorrectionsCoreQnVector &Qn);
+  /// Check the quality of the constructed Qn vector
+  /// Current criteria is number of contributors should be at least one.
+  void CheckQuality() { fGoodQuality = (0 < fN); }
+  void Normalize(NormalizationMethod method);
+  void Reset();
+
+  double EventPlane(int harmonic) const;
+
+  static const float fMinimumSignificantValue;   ///< the minimum value that will be considered as meaningful for processing
+
+protected:
+  /// Checks whether the passed harmonic is active
+  /// \param h the harmonic number
+  bool IsActive(int h) const { return ((fHarmonicMask & (1U << h)) != 0); }
+
+  float fQnX[COREMAXHARMONICNUMBERSUPPORTED+1];   ///< the Q vector X component for each harmonic
+  float fQnY[COREMAXHARMONICNUMBERSUPPORTED+1];   ///< the Q vector Y component for each harmonic
+  int   fHighestHarmonic;                          ///< the highest harmonic number handled
+  unsigned int fHarmonicMask;                      ///< the mask for the supported harmonics
+  bool  fGoodQuality;                              ///< Qn vector good quality flag
+  int   fN;                                        ///< number of elements used for Qn vector building
+  float fSumW;                                     ///< the sum of weights
+  int   fHarmonicMultiplier;                       ///< the multiplier of the different harmonics
+};
+
+/// Get the number of the first harmonic used
+/// \return the number of the first harmonic handled by the Q vector, -1 if none
+inline int QnCorrectionsCoreQnVector::GetFirstHarmonic() const {
+  for (int h = 1; h < fHighestHarmonic + 1; h++) {
+    if (IsActive(h)) return h;
+  }
+  return -1;
+}
+
+/// Get the next harmonic to the one passed as parameter
+/// \param harmonic number to find the next one
+/// \return the number of the next to the passed harmonic, -1 if none
+inline int QnCorrectionsCoreQnVector::GetNextHarmonic(int harmonic) const {
+  for (int h = harmonic + 1; h < fHighestHarmonic + 1; h++) {
+    if (IsActive(h)) return h;
+  }
+  return -1;
+}
+
+/// Adds a contribution to the Q vector
+/// A check for weight significant value is made. Not passing it ignores the contribution.
+/// The process of incorporating contributions takes into account the harmonic multiplier
+/// \param phi azimuthal angle contribution
+/// \param weight the weight of the contribution
+inline void QnCorrectionsCoreQnVector::Add(double phi, double weight) {
+
+  if (weight < fMinimumSignificantValue) return;
+  for (int h = 1; h < fHighestHarmonic + 1; h++) {
+    if (IsActive(h)) {
+      fQnX[h] += (weight * std::cos(h*fHarmonicMultiplier*phi));
+      fQnY[h] += (weight * std::sin(h*fHarmonicMultiplier*phi));
+    }
+  }
+  fSumW += weight;
+  fN += 1;
+}
+
+#endif /* QNCORRECTIONS_COREQNVECTOR_H */
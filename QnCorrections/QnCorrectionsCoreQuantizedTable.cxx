@@ -0,0 +1,121 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreQuantizedTable.cxx
+/// \brief Implementation of the ROOT independent compact table of calibration coefficients
+
+#include "QnCorrectionsCoreQuantizedTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/// Default constructor
+///
+/// The table is empty.
+QnCorrectionsCoreQuantizedTable::QnCorrectionsCoreQuantizedTable() :
+    fValues(),
+    fExactBins(),
+    fExactValues(),
+    fValidMask() {
+}
+
+/// Builds the table from full precision coefficients
+///
+/// Either of the coefficients or the validity flags can be omitted.
+/// The nonzero coefficients out of the half precision normal range
+/// are kept at full precision.
+/// \param nBins the number of linear bins
+/// \param values the coefficient of each bin, NULL for a validity only table
+/// \param valid the validity of each bin, NULL for not keeping the validity mask
+/// \return false, with the table left empty, if any coefficient is not finite
+bool QnCorrectionsCoreQuantizedTable::Build(long long nBins, const float *values, const bool *valid) {
+  Clear();
+
+  if (values != NULL) {
+    for (long long bin = 0; bin < nBins; bin++) {
+      if (!std::isfinite(values[bin])) return false;
+    }
+    fValues.resize(nBins);
+    for (long long bin = 0; bin < nBins; bin++) {
+      fValues[bin] = Encode(values[bin]);
+      if (fValues[bin] == kExactCode) {
+        fExactBins.push_back(bin);
+        fExactValues.push_back(values[bin]);
+      }
+    }
+  }
+
+  if (valid != NULL) {
+    fValidMask.assign((nBins + 63) / 64, 0ULL);
+    for (long long bin = 0; bin < nBins; bin++) {
+      if (valid[bin]) fValidMask[bin >> 6] |= (1ULL << (bin & 63));
+    }
+  }
+  return true;
+}
+
+/// Converts a finite coefficient to half precision, rounding to nearest
+/// \param value the coefficient
+/// \return the half precision float bits, the exact code if out of the half precision normal range
+unsigned short QnCorrectionsCoreQuantizedTable::Encode(float value) {
+  if (value == 0.0f) return 0;
+
+  unsigned int bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  unsigned int sign = (bits >> 16) & 0x8000u;
+  unsigned int magnitude = bits & 0x7fffffffu;
+  /* below the smallest normal half precision float, 2^-14 */
+  if (magnitude < ((127u - 14u) << 23)) return kExactCode;
+  /* round the mantissa to ten bits, a carry goes to the exponent */
+  magnitude = (magnitude + 0x1000u) >> 13;
+  magnitude -= (127u - 15u) << 10;
+  /* beyond the largest normal half precision float, 65504 */
+  if (0x7bffu < magnitude) return kExactCode;
+  return (unsigned short) (sign | magnitude);
+}
+
+/// Gets the coefficient of a bin which scales to zero
+/// \param bin the linear bin number
+/// \return the full precision coefficient if it is nonzero, zero otherwise
+float QnCorrectionsCoreQuantizedTable::GetExact(long long bin) const {
+  std::vector<long long>::const_iterator exact = std::lower_bound(fExactBins.begin(), fExactBins.end(), bin);
+  if ((exact != fExactBins.end()) && (*exact == bin))
+    return fExactValues[exact - fExactBins.begin()];
+  return 0.0f;
+}
+
+/// Releases the table content
+void QnCorrectionsCoreQuantizedTable::Clear() {
+  std::vector<unsigned short>().swap(fValues);
+  std::vector<long long>().swap(fExactBins);
+  std::vector<float>().swap(fExactValues);
+  std::vector<unsigned long long>().swap(fValidMask);
+}
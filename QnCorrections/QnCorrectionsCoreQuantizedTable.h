@@ -0,0 +1,85 @@
+#ifndef QNCORRECTIONS_COREQUANTIZEDTABLE_H
+#define QNCORRECTIONS_COREQUANTIZEDTABLE_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreQuantizedTable.h
+/// \brief ROOT independent compact table of calibration coefficients
+
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+/// \class QnCorrectionsCoreQuantizedTable
+/// \brief Plain C++ table of coefficients stored as half precision floats
+///
+/// Keeps, for each linear bin of a calibration histogram, its final
+/// coefficient as an IEEE 754 half precision float, rounded to nearest.
+/// The relative error of any coefficient is then bounded by 2^-11
+/// whatever its magnitude with respect to the other coefficients of
+/// the table, which matters for the coefficients used as divisors.
+/// The nonzero coefficients out of the half precision normal range,
+/// which would lose their relative precision or overflow, are kept
+/// apart at full precision. Optionally keeps as well a bit packed
+/// mask with the validity of each bin.
+///
+/// Tables are not built from coefficients that are not finite.
+///
+/// A table takes a quarter of the memory of the equivalent single
+/// precision values and errors histograms so that the calibration of
+/// a whole detector configuration can stay cache resident.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreQuantizedTable {
+public:
+  QnCorrectionsCoreQuantizedTable();
+
+  bool Build(long long nBins, const float *values, const bool *valid = NULL);
+  void Clear();
+
+  /// Gets whether the table holds coefficients
+  bool HasValues() const { return !fValues.empty(); }
+  /// Gets the coefficient of the passed bin
+  /// \param bin the linear bin number
+  float Get(long long bin) const
+  { return ((fValues[bin] & 0x7fff) == 0) ? 0.0f : ((fValues[bin] == kExactCode) ? GetExact(bin) : Decode(fValues[bin])); }
+  /// Gets whether the passed bin is valid
+  /// \param bin the linear bin number
+  bool IsValid(long long bin) const { return (fValidMask[bin >> 6] >> (bin & 63)) & 1ULL; }
+  /// Gets the memory taken by the coefficients and the validity mask
+  size_t GetSizeInBytes() const
+  { return fValues.size() * sizeof(unsigned short) + fValidMask.size() * sizeof(unsigned long long)
+      + fExactBins.size() * (sizeof(long long) + sizeof(float)); }
+  /// Gets the number of coefficients kept at full precision
+  size_t GetNoOfExactBins() const { return fExactBins.size(); }
+
+private:
+  static unsigned short Encode(float value);
+  /// Converts a normal half precision float to single precision
+  /// \param half the half precision float bits
+  static float Decode(unsigned short half) {
+    unsigned int bits = ((half & 0x8000u) << 16) | (((half & 0x7fffu) + ((127 - 15) << 10)) << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  float GetExact(long long bin) const;
+
+  static const unsigned short kExactCode = 0x7e00; ///< the half precision NaN flagging a coefficient kept at full precision
+
+  std::vector<unsigned short> fValues;        ///< the half precision coefficients
+  std::vector<long long> fExactBins;          ///< the bins, in increasing order, whose nonzero coefficient is out of the half precision normal range
+  std::vector<float> fExactValues;            ///< the full precision coefficient of those bins
+  std::vector<unsigned long long> fValidMask; ///< the bit packed validity of each bin
+};
+
+#endif // QNCORRECTIONS_COREQUANTIZEDTABLE_H
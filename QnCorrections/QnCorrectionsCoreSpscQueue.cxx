@@ -0,0 +1,121 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreSpscQueue.cxx
+/// \brief Implementation of the ROOT independent bounded single producer single consumer queue
+
+#include "QnCorrectionsCoreSpscQueue.h"
+
+/// Normal constructor
+/// \param capacity the maximum number of items the queue holds, at least one
+QnCorrectionsCoreSpscQueue::QnCorrectionsCoreSpscQueue(int capacity) :
+  fItems((capacity < 1) ? 1 : capacity),
+  fHead(0),
+  fTail(0),
+  fClosed(false),
+  fNoOfSleepers(0),
+  fMutex(),
+  fProgress(),
+  fNoOfFullWaits(0),
+  fNoOfEmptyWaits(0) {
+}
+
+/// Pushes an item at the end of the queue
+///
+/// To be called only from the producer thread. Sleeps while the queue is full.
+/// \param item the item to push
+/// \return false if the queue was closed and the item was not pushed
+bool QnCorrectionsCoreSpscQueue::Push(int item) {
+  unsigned long long tail = fTail.load(std::memory_order_relaxed);
+  if (!(tail - fHead.load() < fItems.size())) {
+    fNoOfFullWaits++;
+    std::unique_lock<std::mutex> lock(fMutex);
+    fNoOfSleepers++;
+    while (!(tail - fHead.load() < fItems.size()) && !fClosed.load()) {
+      fProgress.wait(lock);
+    }
+    fNoOfSleepers--;
+  }
+  if (fClosed.load()) return false;
+
+  fItems[tail % fItems.size()] = item;
+  fTail.store(tail + 1);
+  WakeUp();
+  return true;
+}
+
+/// Pops the item at the front of the queue
+///
+/// To be called only from the consumer thread. Sleeps while the queue
+/// is empty and has not been closed.
+/// \param item where to store the popped item
+/// \return false if the queue was closed and there are no more items
+bool QnCorrectionsCoreSpscQueue::Pop(int &item) {
+  unsigned long long head = fHead.load(std::memory_order_relaxed);
+  if (!(head < fTail.load())) {
+    fNoOfEmptyWaits++;
+    std::unique_lock<std::mutex> lock(fMutex);
+    fNoOfSleepers++;
+    while (!(head < fTail.load()) && !fClosed.load()) {
+      fProgress.wait(lock);
+    }
+    fNoOfSleepers--;
+    if (!(head < fTail.load())) return false;
+  }
+
+  item = fItems[head % fItems.size()];
+  fHead.store(head + 1);
+  WakeUp();
+  return true;
+}
+
+/// Closes the queue
+///
+/// The consumer gets the pending items and afterwards the end of the
+/// stream. A producer sleeping on a full queue is released without pushing.
+void QnCorrectionsCoreSpscQueue::Close() {
+  fClosed.store(true);
+  std::lock_guard<std::mutex> lock(fMutex);
+  fProgress.notify_all();
+}
+
+/// Wakes up the other side if it is sleeping on the queue
+///
+/// The sleepers count is published before the sleeper checks the queue
+/// state and the state change before it is checked here, so either the
+/// sleeper sees the change or the change sees the sleeper. Passing
+/// through the mutex ensures the sleeper is already waiting when notified.
+void QnCorrectionsCoreSpscQueue::WakeUp() {
+  if (0 < fNoOfSleepers.load()) {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fProgress.notify_all();
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef QNCORRECTIONS_CORESPSCQUEUE_H
+#define QNCORRECTIONS_CORESPSCQUEUE_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreSpscQueue.h
+/// \brief ROOT independent bounded single producer single consumer queue
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/// \class QnCorrectionsCoreSpscQueue
+/// \brief Plain C++ bounded queue between one producer and one consumer thread
+///
+/// Carries integer items, i.e. the numbers of preallocated slots, from
+/// one thread to another in order. While the queue is neither full nor
+/// empty pushing and popping only touch the ring positions, without
+/// locks. A producer finding the queue full, and a consumer finding it
+/// empty, sleep until the other side makes progress, which applies
+/// backpressure on the faster side.
+///
+/// Once closed by the producer the consumer still gets the pending
+/// items and then is informed of the end of the stream.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreSpscQueue {
+public:
+  QnCorrectionsCoreSpscQueue(int capacity);
+
+  bool Push(int item);
+  bool Pop(int &item);
+  void Close();
+
+  /// Gets the maximum number of items the queue holds
+  int GetCapacity() const { return int(fItems.size()); }
+  /// Gets the number of times the producer found the queue full
+  long long GetNoOfFullWaits() const { return fNoOfFullWaits; }
+  /// Gets the number of times the consumer found the queue empty
+  long long GetNoOfEmptyWaits() const { return fNoOfEmptyWaits; }
+
+private:
+  void WakeUp();
+
+  std::vector<int> fItems;                  ///< the ring of items
+  std::atomic<unsigned long long> fHead;    ///< the number of items popped
+  std::atomic<unsigned long long> fTail;    ///< the number of items pushed
+  std::atomic<bool> fClosed;                ///< the producer closed the queue
+  std::atomic<int> fNoOfSleepers;           ///< the number of threads sleeping, or about to, on the queue
+  std::mutex fMutex;                        ///< protects the sleeps
+  std::condition_variable fProgress;        ///< signals a push, a pop or the closing
+  long long fNoOfFullWaits;                 ///< the times the producer found the queue full
+  long long fNoOfEmptyWaits;                ///< the times the consumer found the queue empty
+
+  /// Copy constructor not implemented
+  QnCorrectionsCoreSpscQueue(const QnCorrectionsCoreSpscQueue &);
+  /// Assignment operator not implemented
+  QnCorrectionsCoreSpscQueue &operator=(const QnCorrectionsCoreSpscQueue &);
+};
+
+#endif // QNCORRECTIONS_CORESPSCQUEUE_H
@@ -0,0 +1,89 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsCoreVariablesBank.cxx
+/// \brief Implementation of the ROOT independent variables bank remapping class
+
+#include "QnCorrectionsCoreVariablesBank.h"
+#include <algorithm>
+#include <cstddef>
+
+/// Default constructor
+///
+/// No member is registered.
+QnCorrectionsCoreVariablesBank::QnCorrectionsCoreVariablesBank() :
+  fSlots(),
+  fVariables() {
+}
+
+/// Registers a member holding a variable external id
+///
+/// A member already registered is ignored.
+/// \param varId reference to the member holding the variable id
+void QnCorrectionsCoreVariablesBank::Register(int &varId) {
+  if (std::find(fSlots.begin(), fSlots.end(), &varId) == fSlots.end()) {
+    fSlots.push_back(&varId);
+  }
+}
+
+/// Assigns the dense ids and rewrites the registered members with them
+///
+/// The passed map is filled, for each external id, with its dense id
+/// or with the discard slot if the external id is not referenced. Ids
+/// out of the external range are left untouched.
+/// \param nMaxNoOfVariables the number of external ids
+/// \param map array of nMaxNoOfVariables dense ids to fill
+/// \return the number of dense variables, the discard slot id
+int QnCorrectionsCoreVariablesBank::Remap(int nMaxNoOfVariables, int *map) {
+  std::vector<bool> referenced(nMaxNoOfVariables, false);
+  for (size_t ixSlot = 0; ixSlot < fSlots.size(); ixSlot++) {
+    int varId = *fSlots[ixSlot];
+    if ((0 <= varId) && (varId < nMaxNoOfVariables)) referenced[varId] = true;
+  }
+
+  fVariables.clear();
+  for (int varId = 0; varId < nMaxNoOfVariables; varId++) {
+    if (referenced[varId]) {
+      map[varId] = int(fVariables.size());
+      fVariables.push_back(varId);
+    }
+  }
+  int discard = int(fVariables.size());
+  for (int varId = 0; varId < nMaxNoOfVariables; varId++) {
+    if (!referenced[varId]) map[varId] = discard;
+  }
+
+  for (size_t ixSlot = 0; ixSlot < fSlots.size(); ixSlot++) {
+    int varId = *fSlots[ixSlot];
+    if ((0 <= varId) && (varId < nMaxNoOfVariables)) *fSlots[ixSlot] = map[varId];
+  }
+  return discard;
+}
@@ -0,0 +1,56 @@
+#ifndef QNCORRECTIONS_COREVARIABLESBANK_H
+#define QNCORRECTIONS_COREVARIABLESBANK_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsCoreVariablesBank.h
+/// \brief ROOT independent remapping of the variable ids into a dense variables bank
+
+#include <vector>
+
+/// \class QnCorrectionsCoreVariablesBank
+/// \brief Plain C++ collector and remapper of the variable ids referenced by the framework
+///
+/// The framework components register the members where they keep
+/// the external ids of the variables they read from the variables
+/// bank. Each member is only registered once even if it is reached
+/// from several places, i.e. a shared set of event class variables.
+///
+/// Once every component is registered, the distinct external ids are
+/// assigned consecutive dense ids in increasing external id order and
+/// the registered members are rewritten with them. The map from
+/// external id to dense id is also provided; the external ids not
+/// referenced by the framework map to a discard slot located just
+/// after the dense variables. Negative ids are taken as unassigned
+/// and are neither collected nor rewritten.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsCoreVariablesBank {
+public:
+  QnCorrectionsCoreVariablesBank();
+
+  void Register(int &varId);
+  int Remap(int nMaxNoOfVariables, int *map);
+
+  /// Gets the number of dense variables
+  /// Only meaningful after remapping
+  int GetNoOfVariables() const { return int(fVariables.size()); }
+  /// Gets the external id of the passed dense variable
+  /// \param variable the dense variable id
+  int GetExternalId(int variable) const { return fVariables[variable]; }
+
+private:
+  std::vector<int *> fSlots;    ///< the registered members holding variable ids
+  std::vector<int> fVariables;  ///< the external ids of the dense variables
+};
+
+#endif // QNCORRECTIONS_COREVARIABLESBANK_H
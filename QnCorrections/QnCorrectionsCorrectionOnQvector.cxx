@@ -46,6 +46,7 @@ QnCorrectionsCorrectionOnQvector::QnCorrectionsCorrectionOnQvector() :
 
   fCorrectedQnVector = NULL;
   fInputQnVector = NULL;
+  fKeepCorrectedQnVector = kFALSE;
 }
 
 /// Normal constructor
@@ -56,19 +57,21 @@ QnCorrectionsCorrectionOnQvector::QnCorrectionsCorrectionOnQvector(const char *n
 
   fCorrectedQnVector = NULL;
   fInputQnVector = NULL;
+  fKeepCorrectedQnVector = kFALSE;
 }
 
 /// Default destructor
+///
+/// The corrected Qn vector is owned by the detector configuration
 QnCorrectionsCorrectionOnQvector::~QnCorrectionsCorrectionOnQvector() {
-
-  if (fCorrectedQnVector != NULL)
-    delete fCorrectedQnVector;
 }
 
 /// Include the new corrected Qn vector into the passed list
 ///
 /// Adds the Qn vector to the passed list
 /// if the correction step is in correction states.
+/// Once in the list the corrected Qn vector is
+/// kept updated while processing the events.
 /// \param list list where the corrected Qn vector should be added
 void QnCorrectionsCorrectionOnQvector::IncludeCorrectedQnVector(TList *list) {
 
@@ -81,6 +84,7 @@ void QnCorrectionsCorrectionOnQvector::IncludeCorrectedQnVector(TList *list) {
     /* and proceed to ... */
   case QCORRSTEP_apply: /* apply the correction */
     list->Add(fCorrectedQnVector);
+    fKeepCorrectedQnVector = kTRUE;
     break;
   default:
     break;
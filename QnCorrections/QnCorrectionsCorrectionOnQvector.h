@@ -76,6 +76,19 @@ public:
   const QnCorrectionsQnVector *GetCorrectedQnVector() const
   { return fCorrectedQnVector; }
   virtual void IncludeCorrectedQnVector(TList *list);
+  /// Asks the correction step to keep a snapshot of its corrected Qn vector
+  ///
+  /// The correction steps transform in place the detector configuration
+  /// current Qn vector. Their own corrected Qn vector is only updated
+  /// when someone will read it afterwards: the user through the Qn vectors
+  /// list, the next correction step or the own QA histograms.
+  /// \param keep kTRUE if the corrected Qn vector snapshot should be kept
+  void SetKeepCorrectedQnVector(Bool_t keep = kTRUE)
+  { fKeepCorrectedQnVector = keep; }
+  /// Reports if the correction step is collecting data from its input Qn vector
+  /// \return kTRUE if the step is in a data collecting state
+  Bool_t IsCollectingData() const
+  { return ((fState == QCORRSTEP_calibration) || (fState == QCORRSTEP_applyCollect)); }
   /// Clean the correction to accept a new event
   /// Pure virtual function
   virtual void ClearCorrectionStep() = 0;
@@ -105,6 +118,7 @@ private:
 protected:
   QnCorrectionsQnVector *fCorrectedQnVector;    //!<! the step corrected Qn vector
   const QnCorrectionsQnVector *fInputQnVector;   //!<! the previous step corrected Qn vector
+  Bool_t fKeepCorrectedQnVector;                 //!<! keep the step corrected Qn vector snapshot updated
 /// \cond CLASSIMP
   ClassDef(QnCorrectionsCorrectionOnQvector, 2);
 /// \endcond
@@ -71,6 +71,24 @@ public:
   /// \param list list where the inputs should be found
   /// \return kTRUE if everything went OK
   virtual Bool_t AttachInput(TList *list) = 0;
+  /// Stages the input information found in a new calibration for a later swap
+  ///
+  /// Only correction steps being applied stage new input information.
+  /// It can be invoked from a thread other than the processing one
+  /// while events are being processed.
+  /// Default behavior: nothing to stage
+  /// \param list list where the new inputs should be found
+  /// \return kTRUE if everything went OK
+  virtual Bool_t StageInput(TList *list) { return kTRUE; }
+  /// Replaces the input information in use by the staged one if any
+  ///
+  /// Should be invoked between events from the processing thread.
+  /// Default behavior: nothing to swap
+  virtual void SwapStagedInput() {}
+  /// Deletes the staged input information if any
+  ///
+  /// Default behavior: nothing to delete
+  virtual void DiscardStagedInput() {}
   /// Perform after calibration histograms attach actions
   /// It is used to inform the different correction step that
   /// all conditions for running the network are in place so
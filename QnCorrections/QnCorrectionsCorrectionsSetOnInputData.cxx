@@ -39,13 +39,29 @@ ClassImp(QnCorrectionsCorrectionsSetOnInputData);
 /// \endcond
 
 /// Default constructor
-QnCorrectionsCorrectionsSetOnInputData::QnCorrectionsCorrectionsSetOnInputData() : TList() {
+QnCorrectionsCorrectionsSetOnInputData::QnCorrectionsCorrectionsSetOnInputData() : TList(),
+    fNoOfDispatchedSteps(0),
+    fDispatchTable(NULL) {
 
 }
 
 /// Default destructor
 QnCorrectionsCorrectionsSetOnInputData::~QnCorrectionsCorrectionsSetOnInputData() {
+  if (fDispatchTable != NULL) delete [] fDispatchTable;
+}
 
+/// Freezes the correction steps in the dispatch table
+///
+/// To be called once the set of correction steps is complete,
+/// at framework initialization.
+void QnCorrectionsCorrectionsSetOnInputData::BuildDispatchTable() {
+  if (fDispatchTable != NULL) delete [] fDispatchTable;
+  fNoOfDispatchedSteps = GetEntries();
+  fDispatchTable = new QnCorrectionsCorrectionOnInputData *[fNoOfDispatchedSteps];
+  TObjLink *link = FirstLink();
+  for (Int_t ixStep = 0; ixStep < fNoOfDispatchedSteps; ixStep++, link = link->Next()) {
+    fDispatchTable[ixStep] = (QnCorrectionsCorrectionOnInputData *) link->GetObject();
+  }
 }
 
 /// Adds a new correction to the set.
@@ -40,13 +40,29 @@ ClassImp(QnCorrectionsCorrectionsSetOnQvector);
 /// \endcond
 
 /// Default constructor
-QnCorrectionsCorrectionsSetOnQvector::QnCorrectionsCorrectionsSetOnQvector() : TList() {
+QnCorrectionsCorrectionsSetOnQvector::QnCorrectionsCorrectionsSetOnQvector() : TList(),
+    fNoOfDispatchedSteps(0),
+    fDispatchTable(NULL) {
 
 }
 
 /// Default destructor
 QnCorrectionsCorrectionsSetOnQvector::~QnCorrectionsCorrectionsSetOnQvector() {
+  if (fDispatchTable != NULL) delete [] fDispatchTable;
+}
 
+/// Freezes the correction steps in the dispatch table
+///
+/// To be called once the set of correction steps is complete,
+/// at framework initialization.
+void QnCorrectionsCorrectionsSetOnQvector::BuildDispatchTable() {
+  if (fDispatchTable != NULL) delete [] fDispatchTable;
+  fNoOfDispatchedSteps = GetEntries();
+  fDispatchTable = new QnCorrectionsCorrectionOnQvector *[fNoOfDispatchedSteps];
+  TObjLink *link = FirstLink();
+  for (Int_t ixStep = 0; ixStep < fNoOfDispatchedSteps; ixStep++, link = link->Next()) {
+    fDispatchTable[ixStep] = (QnCorrectionsCorrectionOnQvector *) link->GetObject();
+  }
 }
 
 /// Adds a new correction to the set.
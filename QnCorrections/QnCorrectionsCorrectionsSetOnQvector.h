@@ -27,6 +27,9 @@
 /// Order matters so, the list must be built with the order in which
 /// corrections should be applied.
 ///
+/// Once the framework is initialized the correction steps are frozen
+/// in a dispatch table, a plain array the per event code walks linearly.
+///
 /// The correction steps are own by the object instance so they will
 /// be destroyed with it.
 ///
@@ -50,8 +53,21 @@ public:
   void FillOverallCorrectionsList(TList *correctionlist) const;
   const QnCorrectionsCorrectionOnQvector *GetPrevious(const QnCorrectionsCorrectionOnQvector *correction) const;
   Bool_t IsCorrectionStepBeingApplied(const char *name) const;
+  void BuildDispatchTable();
+  /// Gets the number of correction steps in the dispatch table
+  /// \return the number of correction steps frozen at framework initialization
+  Int_t GetNoOfDispatchedSteps() const { return fNoOfDispatchedSteps; }
+  /// Access the correction step at the passed position of the dispatch table
+  /// \param i position in the table (starting at zero)
+  /// \return the correction step object a position i
+  QnCorrectionsCorrectionOnQvector *GetDispatchedStep(Int_t i) const { return fDispatchTable[i]; }
+
+private:
+  Int_t fNoOfDispatchedSteps;                   //!<! the number of correction steps in the dispatch table
+  /// array, the correction steps in application order frozen at framework initialization
+  QnCorrectionsCorrectionOnQvector **fDispatchTable;  //!<!
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsCorrectionsSetOnQvector, 1);
+  ClassDef(QnCorrectionsCorrectionsSetOnQvector, 2);
 /// \endcond
 };
 
@@ -37,6 +37,9 @@ class QnCorrectionsCutAbove: public QnCorrectionsCutsBase {
   virtual ~QnCorrectionsCutAbove();
 
   virtual Bool_t IsSelected(const Float_t *variableContainer);
+  /// Gets the equivalent cut for the ROOT independent core engine
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(QnCorrectionsCoreCut::CUT_above, fVarId, fThreshold); }
  private:
   Float_t         fThreshold;   ///< The value that must be surpassed
 
@@ -37,6 +37,9 @@ class QnCorrectionsCutBelow: public QnCorrectionsCutsBase {
   virtual ~QnCorrectionsCutBelow();
 
   virtual Bool_t IsSelected(const Float_t *variableContainer);
+  /// Gets the equivalent cut for the ROOT independent core engine
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(QnCorrectionsCoreCut::CUT_below, fVarId, fThreshold); }
  private:
   Float_t         fThreshold;   ///< The upper, not reached, value
 
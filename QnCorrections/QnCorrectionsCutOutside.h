@@ -38,6 +38,9 @@ class QnCorrectionsCutOutside: public QnCorrectionsCutsBase {
   virtual ~QnCorrectionsCutOutside();
 
   virtual Bool_t IsSelected(const Float_t *variableContainer);
+  /// Gets the equivalent cut for the ROOT independent core engine
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(QnCorrectionsCoreCut::CUT_outside, fVarId, fMinThreshold, fMaxThreshold); }
  private:
   Float_t         fMinThreshold;   ///< The lower limit
   Float_t         fMaxThreshold;   ///< The upper limit
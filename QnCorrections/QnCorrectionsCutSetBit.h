@@ -39,6 +39,9 @@ class QnCorrectionsCutSetBit: public QnCorrectionsCutsBase {
   virtual ~QnCorrectionsCutSetBit();
 
   virtual Bool_t IsSelected(const Float_t *variableContainer);
+  /// Gets the equivalent cut for the ROOT independent core engine
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(fVarId, fBitMask, fExpectedResult); }
  private:
   UInt_t          fBitMask;   ///< The mask to apply to the variable value
   UInt_t          fExpectedResult; ///< The expected masked result to pass the cut
@@ -38,6 +38,9 @@ class QnCorrectionsCutValue: public QnCorrectionsCutsBase {
   virtual ~QnCorrectionsCutValue();
 
   virtual Bool_t IsSelected(const Float_t *variableContainer);
+  /// Gets the equivalent cut for the ROOT independent core engine
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(QnCorrectionsCoreCut::CUT_value, fVarId, fValue); }
  private:
   Float_t         fValue;   ///< The desired value
 
@@ -16,6 +16,8 @@
 
 #include <TObject.h>
 #include <TObjArray.h>
+#include "QnCorrectionsCoreCuts.h"
+#include "QnCorrectionsCoreVariablesBank.h"
 
 /// \class QnCorrectionsCutsBase
 /// \brief Base class for the Q vector correction cuts
@@ -39,6 +41,9 @@ class QnCorrectionsCutsBase: public TObject {
 
   /// Gets the variable Id the cut is applied to
   Int_t           GetVariableId() const { return fVarId; }
+  /// Registers the variable Id for its remapping into a dense variables bank
+  /// \param bank the variables bank remapper
+  void            RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) { bank.Register(fVarId); }
 
   /// Check if the actual variable value passes the cut
   ///
@@ -48,6 +53,15 @@ class QnCorrectionsCutsBase: public TObject {
   /// \param variableContainer the current variables content addressed by var Id
   /// \return kTRUE if the actual value passes the cut else kFALSE
   virtual Bool_t IsSelected(const Float_t *variableContainer) = 0;
+  /// Gets the equivalent cut for the ROOT independent core engine
+  ///
+  /// Default behavior. Cuts without core equivalent, as the user
+  /// defined ones, are reported as external ones and are evaluated
+  /// through IsSelected.
+  ///
+  /// \return the core engine cut
+  virtual QnCorrectionsCoreCut GetCoreCut() const
+  { return QnCorrectionsCoreCut(QnCorrectionsCoreCut::CUT_external, fVarId, 0.0); }
  protected:
   Int_t         fVarId;   ///< The external Id for the variable in the data bank
 
@@ -60,6 +60,8 @@ public:
   virtual QnCorrectionsCutsBase *At(Int_t i) const { return (QnCorrectionsCutsBase *) TObjArray::At(i); }
 
   Bool_t IsSelected(const Float_t *variableContainer);
+  Bool_t FillCoreCutsSet(QnCorrectionsCoreCutsSet &coreSet) const;
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
 
 /// \cond CLASSIMP
   ClassDef(QnCorrectionsCutsSet, 1);
@@ -80,4 +82,26 @@ inline Bool_t QnCorrectionsCutsSet::IsSelected(const Float_t *variableContainer)
   return kTRUE;
 }
 
+/// Fills the equivalent set of cuts for the ROOT independent core engine
+///
+/// The passed core set is cleared before incorporating the cuts
+/// \param coreSet the core engine set of cuts to fill
+/// \return kTRUE if the core set is equivalent, kFALSE if any of the cuts has no core equivalent
+inline Bool_t QnCorrectionsCutsSet::FillCoreCutsSet(QnCorrectionsCoreCutsSet &coreSet) const {
+  coreSet.Clear();
+  for (Int_t icut = 0; icut < GetEntriesFast(); icut++) {
+    coreSet.Add(At(icut)->GetCoreCut());
+  }
+  return coreSet.IsFlattenable();
+}
+
+/// Registers the variables Ids of the whole set of cuts for their
+/// remapping into a dense variables bank
+/// \param bank the variables bank remapper
+inline void QnCorrectionsCutsSet::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  for (Int_t icut = 0; icut < GetEntriesFast(); icut++) {
+    At(icut)->RegisterDataVariables(bank);
+  }
+}
+
 #endif // QNCORRECTIONS_CUTSSET_H
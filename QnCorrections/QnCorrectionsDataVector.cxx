@@ -45,6 +45,7 @@ QnCorrectionsDataVector::QnCorrectionsDataVector() : TObject() {
   fPhi = 0.0;
   fId = -1;
   fWeight = 1.0;
+  fBasisRow = -1;
 }
 
 /// Normal constructor
@@ -55,6 +56,7 @@ QnCorrectionsDataVector::QnCorrectionsDataVector(Int_t id, Float_t phi, Float_t
   fPhi = phi;
   fId = id;
   fWeight = weight;
+  fBasisRow = -1;
 }
 
 /// Default destructor
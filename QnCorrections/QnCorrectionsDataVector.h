@@ -56,16 +56,23 @@ public:
   /// Gets the equalized weight for the data vector
   /// \return defaults to weights
   virtual Float_t EqualizedWeight() { return fWeight; }
+  /// Sets the row of the data vector harmonic terms in the detector harmonic basis
+  /// \param row the harmonic basis row
+  void SetBasisRow(Int_t row) { fBasisRow = row; }
+  /// Gets the row of the data vector harmonic terms in the detector harmonic basis
+  /// \return the harmonic basis row, -1 if the terms were not evaluated
+  Int_t GetBasisRow() const { return fBasisRow; }
 
 protected:
   Float_t fPhi;                                   //!<! the azimuthal angle of the data vector
   Int_t   fId;                    //!<! the id associated with the data vector
   Float_t fWeight;                //!<! raw weight assigned to the data vector
+  Int_t   fBasisRow;              //!<! the row of the data vector in the detector harmonic basis
 
   static const Float_t fMinimumSignificantValue;  ///< the minimum value that will be considered as meaningful for processing
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsDataVector, 3);
+  ClassDef(QnCorrectionsDataVector, 4);
 /// \endcond
 };
 
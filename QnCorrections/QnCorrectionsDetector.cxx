@@ -43,11 +43,22 @@ ClassImp(QnCorrectionsDetector);
 /// Default constructor
 QnCorrectionsDetector::QnCorrectionsDetector() : TNamed(),
     fConfigurations(),
-    fDataVectorAcceptedConfigurations() {
+    fDataVectorConfigurations(),
+    fConfigurationFamilies(),
+    fConfigurationVariations(),
+    fHarmonicBasis() {
 
   fDetectorId = -1;
-  fDataVectorAcceptedConfigurations.SetOwner(kFALSE);
+  fDataVectorConfigurations.SetOwner(kFALSE);
+  fConfigurationFamilies.SetOwner(kTRUE);
+  fConfigurationVariations.SetOwner(kTRUE);
   fCorrectionsManager = NULL;
+  fNoOfConfigurations = 0;
+  fConfigurationsTable = NULL;
+  fNoOfDataVectorConfigurations = 0;
+  fDataVectorConfigurationsTable = NULL;
+  fNoOfDataVectorAcceptedConfigurations = 0;
+  fDataVectorAcceptedConfigurationsTable = NULL;
 }
 
 /// Normal constructor
@@ -56,24 +67,44 @@ QnCorrectionsDetector::QnCorrectionsDetector() : TNamed(),
 QnCorrectionsDetector::QnCorrectionsDetector(const char *name, Int_t id) :
     TNamed(name,name),
     fConfigurations(),
-    fDataVectorAcceptedConfigurations() {
+    fDataVectorConfigurations(),
+    fConfigurationFamilies(),
+    fConfigurationVariations(),
+    fHarmonicBasis() {
 
   fDetectorId = id;
-  fDataVectorAcceptedConfigurations.SetOwner(kFALSE);
+  fDataVectorConfigurations.SetOwner(kFALSE);
+  fConfigurationFamilies.SetOwner(kTRUE);
+  fConfigurationVariations.SetOwner(kTRUE);
   fCorrectionsManager = NULL;
+  fNoOfConfigurations = 0;
+  fConfigurationsTable = NULL;
+  fNoOfDataVectorConfigurations = 0;
+  fDataVectorConfigurationsTable = NULL;
+  fNoOfDataVectorAcceptedConfigurations = 0;
+  fDataVectorAcceptedConfigurationsTable = NULL;
 }
 
 /// Default destructor
-/// The detector class does not own anything
+/// The detector class does not own anything beyond its dispatch
+/// tables, the families of detector configurations and the sets of
+/// systematic variations, which take with them their slices and their
+/// variations
 QnCorrectionsDetector::~QnCorrectionsDetector() {
-
+  if (fConfigurationsTable != NULL) delete [] fConfigurationsTable;
+  if (fDataVectorConfigurationsTable != NULL) delete [] fDataVectorConfigurationsTable;
+  if (fDataVectorAcceptedConfigurationsTable != NULL) delete [] fDataVectorAcceptedConfigurationsTable;
 }
 
 /// Asks for support data structures creation
 ///
-/// The request is transmitted to the attached detector configurations
+/// The request is transmitted to the attached families of detector
+/// configurations and to the attached detector configurations
 void QnCorrectionsDetector::CreateSupportDataStructures() {
 
+  for (Int_t ixFamily = 0; ixFamily < fConfigurationFamilies.GetEntriesFast(); ixFamily++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksFamily *>(fConfigurationFamilies.At(ixFamily))->CreateSupportDataStructures();
+  }
   for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
     fConfigurations.At(ixConfiguration)->CreateSupportDataStructures();
   }
@@ -145,6 +176,40 @@ void QnCorrectionsDetector::AfterInputsAttachActions() {
   }
 }
 
+/// Asks for staging the input information of a new calibration
+///
+/// The request is transmitted to the attached detector configurations
+/// \param list list where the new input information should be found
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsDetector::StageCorrectionInputs(TList *list) {
+  Bool_t retValue = kTRUE;
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    Bool_t ret = fConfigurations.At(ixConfiguration)->StageCorrectionInputs(list);
+    retValue = retValue && ret;
+  }
+  return retValue;
+}
+
+/// Asks for replacing the input information in use by the staged one
+///
+/// The request is transmitted to the attached detector configurations
+void QnCorrectionsDetector::SwapStagedCorrectionInputs() {
+
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->SwapStagedCorrectionInputs();
+  }
+}
+
+/// Asks for deleting the staged input information
+///
+/// The request is transmitted to the attached detector configurations
+void QnCorrectionsDetector::DiscardStagedCorrectionInputs() {
+
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->DiscardStagedCorrectionInputs();
+  }
+}
+
 /// Stores the framework manager pointer and transmits it to the incorporated detector configurations if any
 ///
 /// \param manager the framework manager
@@ -156,6 +221,96 @@ void QnCorrectionsDetector::AttachCorrectionsManager(QnCorrectionsManager *manag
   }
 }
 
+/// Freezes the detector configurations in the dispatch tables walked by the per event code
+///
+/// The request is transmitted to the attached detector configurations for
+/// freezing their correction steps. To be called at framework initialization
+/// once the detector configurations are complete.
+void QnCorrectionsDetector::BuildDispatchTables() {
+  if (fConfigurationsTable != NULL) delete [] fConfigurationsTable;
+  fNoOfConfigurations = fConfigurations.GetEntriesFast();
+  fConfigurationsTable = new QnCorrectionsDetectorConfigurationBase *[fNoOfConfigurations];
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfConfigurations; ixConfiguration++) {
+    fConfigurationsTable[ixConfiguration] = fConfigurations.At(ixConfiguration);
+    fConfigurationsTable[ixConfiguration]->BuildDispatchTables();
+  }
+
+  if (fDataVectorConfigurationsTable != NULL) delete [] fDataVectorConfigurationsTable;
+  fNoOfDataVectorConfigurations = fDataVectorConfigurations.GetEntriesFast();
+  fDataVectorConfigurationsTable = new QnCorrectionsDetectorConfigurationBase *[fNoOfDataVectorConfigurations];
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfDataVectorConfigurations; ixConfiguration++) {
+    fDataVectorConfigurationsTable[ixConfiguration] = fDataVectorConfigurations.At(ixConfiguration);
+  }
+
+  /* each configuration accepts a data vector at most once */
+  if (fDataVectorAcceptedConfigurationsTable != NULL) delete [] fDataVectorAcceptedConfigurationsTable;
+  fNoOfDataVectorAcceptedConfigurations = 0;
+  fDataVectorAcceptedConfigurationsTable = new QnCorrectionsDetectorConfigurationBase *[fNoOfConfigurations];
+
+  /* the harmonic basis covers the harmonics of all the configurations, the Q2n vectors included */
+  Int_t highestTerm = 0;
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfConfigurations; ixConfiguration++) {
+    Int_t nNoOfHarmonics = fConfigurationsTable[ixConfiguration]->GetNoOfHarmonics();
+    Int_t *harmonicsMap = new Int_t[nNoOfHarmonics];
+    fConfigurationsTable[ixConfiguration]->GetHarmonicMap(harmonicsMap);
+    for (Int_t h = 0; h < nNoOfHarmonics; h++) {
+      if (highestTerm < 2 * harmonicsMap[h]) highestTerm = 2 * harmonicsMap[h];
+    }
+    delete [] harmonicsMap;
+    fConfigurationsTable[ixConfiguration]->SetHarmonicBasis(&fHarmonicBasis);
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->SetHarmonicBasis(&fHarmonicBasis);
+  }
+  fHarmonicBasis.SetHighestTerm(highestTerm);
+}
+
+/// Registers the variables Ids the detector configurations read from
+/// the variables bank for their remapping into a dense variables bank
+///
+/// The request is transmitted to the detector configurations and to
+/// the families and sets of variations of detector configurations.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetector::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->RegisterDataVariables(bank);
+  }
+  for (Int_t ixFamily = 0; ixFamily < fConfigurationFamilies.GetEntriesFast(); ixFamily++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksFamily *>(fConfigurationFamilies.At(ixFamily))->RegisterDataVariables(bank);
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->RegisterDataVariables(bank);
+  }
+}
+
+/// Preallocates the data vector banks for the passed number of data vectors
+///
+/// The request is transmitted to the detector configurations and to
+/// the sets of variations of detector configurations for their shared banks.
+/// \param nNoOfDataVectors the capacity of each data vector bank
+void QnCorrectionsDetector::PreallocateDataVectorBanks(Int_t nNoOfDataVectors) {
+  fHarmonicBasis.Reserve(nNoOfDataVectors);
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->PreallocateDataVectorBank(nNoOfDataVectors);
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->PreallocateSharedBank(nNoOfDataVectors);
+  }
+}
+
+/// Gets the number of data vectors dropped for exceeding the preallocated data vector banks
+/// \return the number of data vectors dropped by the detector configurations and sets of variations
+Long64_t QnCorrectionsDetector::GetNoOfDroppedDataVectors() const {
+  Long64_t nNoOfDropped = 0;
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    nNoOfDropped += fConfigurations.At(ixConfiguration)->GetNoOfDroppedDataVectors();
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    nNoOfDropped += static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->GetNoOfDroppedDataVectors();
+  }
+  return nNoOfDropped;
+}
+
 /// Adds a new detector configuration to the current detector
 ///
 /// Raise an execution error if the configuration detector reference
@@ -163,23 +318,79 @@ void QnCorrectionsDetector::AttachCorrectionsManager(QnCorrectionsManager *manag
 /// is already incorporated to the detector.
 /// \param detectorConfiguration pointer to the configuration to be added
 void QnCorrectionsDetector::AddDetectorConfiguration(QnCorrectionsDetectorConfigurationBase *detectorConfiguration) {
+  if (IncorporateDetectorConfiguration(detectorConfiguration)) {
+    fDataVectorConfigurations.Add(detectorConfiguration);
+  }
+}
+
+/// Adds a new family of detector configurations to the current detector
+///
+/// Each of the family slices is incorporated as a detector configuration
+/// of the detector but the data vectors reach them through the family.
+/// The detector takes ownership of the family.
+/// Raise an execution error if the family is already incorporated to the
+/// detector or if any of its slices cannot be incorporated.
+/// \param family pointer to the family to be added
+void QnCorrectionsDetector::AddDetectorConfigurationFamily(QnCorrectionsDetectorConfigurationTracksFamily *family) {
+  if (fConfigurationFamilies.FindObject(family->GetName())) {
+    QnCorrectionsFatal(Form("You are trying to add twice %s detector configurations family to detector Id %d. FIX IT, PLEASE.",
+        family->GetName(),
+        GetId()));
+    return;
+  }
+  for (Int_t slice = 0; slice < family->GetNoOfSlices(); slice++) {
+    if (!IncorporateDetectorConfiguration(family->GetSlice(slice))) return;
+  }
+  fConfigurationFamilies.Add(family);
+}
+
+/// Adds a new set of systematic variations of detector configurations to the current detector
+///
+/// Each of the variations is incorporated as a detector configuration
+/// of the detector but the data vectors reach them through the set shared bank.
+/// The detector takes ownership of the set.
+/// Raise an execution error if the set is already incorporated to the
+/// detector or if any of its variations cannot be incorporated.
+/// \param variations pointer to the set of variations to be added
+void QnCorrectionsDetector::AddDetectorConfigurationVariations(QnCorrectionsDetectorConfigurationTracksVariations *variations) {
+  if (fConfigurationVariations.FindObject(variations->GetName())) {
+    QnCorrectionsFatal(Form("You are trying to add twice %s detector configuration variations to detector Id %d. FIX IT, PLEASE.",
+        variations->GetName(),
+        GetId()));
+    return;
+  }
+  for (Int_t variation = 0; variation < variations->GetNoOfVariations(); variation++) {
+    if (!IncorporateDetectorConfiguration(variations->GetVariation(variation))) return;
+  }
+  fConfigurationVariations.Add(variations);
+}
+
+/// Incorporates a detector configuration to the set of detector configurations
+///
+/// Raise an execution error if the configuration detector reference
+/// is not empty and if the detector configuration
+/// is already incorporated to the detector.
+/// \param detectorConfiguration pointer to the configuration to be incorporated
+/// \return kTRUE if the detector configuration was incorporated
+Bool_t QnCorrectionsDetector::IncorporateDetectorConfiguration(QnCorrectionsDetectorConfigurationBase *detectorConfiguration) {
   if (detectorConfiguration->GetDetector() != NULL) {
     QnCorrectionsFatal(Form("You are adding %s detector configuration of detector Id %d to detector Id %d. FIX IT, PLEASE.",
         detectorConfiguration->GetName(),
         detectorConfiguration->GetDetector()->GetId(),
         GetId()));
-    return;
+    return kFALSE;
   }
 
   if (fConfigurations.FindObject(detectorConfiguration->GetName())) {
     QnCorrectionsFatal(Form("You are trying to add twice %s detector configuration to detector Id %d. FIX IT, PLEASE.",
         detectorConfiguration->GetName(),
         GetId()));
-    return;
+    return kFALSE;
   }
   detectorConfiguration->SetDetectorOwner(this);
   detectorConfiguration->AttachCorrectionsManager(fCorrectionsManager);
   fConfigurations.Add(detectorConfiguration);
+  return kTRUE;
 }
 
 /// Searches for a concrete detector configuration by name
@@ -210,6 +421,15 @@ void QnCorrectionsDetector::FillDetectorConfigurationNameList(TList *list) const
   }
 }
 
+/// Performs the fills the detector configurations keep buffered
+///
+/// The request is transmitted to the attached detector configurations
+void QnCorrectionsDetector::FlushFillBuffers() {
+  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
+    fConfigurations.At(ixConfiguration)->FlushFillBuffers();
+  }
+}
+
 /// Include the name of the input correction steps on each detector
 /// configuration into the passed list
 ///
@@ -17,6 +17,8 @@
 
 #include "QnCorrectionsDetectorConfigurationBase.h"
 #include "QnCorrectionsDetectorConfigurationsSet.h"
+#include "QnCorrectionsDetectorConfigurationTracksFamily.h"
+#include "QnCorrectionsDetectorConfigurationTracksVariations.h"
 
 class QnCorrectionsDetectorConfigurationsSet;
 class QnCorrectionsDetectorConfigurationBase;
@@ -37,6 +39,9 @@ class QnCorrectionsManager;
 /// as such it should distribute the different commands to the
 /// defined detector configurations.
 ///
+/// At framework initialization the detector configurations are frozen
+/// in dispatch tables, plain arrays the per event code walks linearly.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
@@ -59,6 +64,9 @@ public:
   Bool_t CreateNveQAHistograms(TList *list);
   Bool_t AttachCorrectionInputs(TList *list);
   virtual void AfterInputsAttachActions();
+  Bool_t StageCorrectionInputs(TList *list);
+  void SwapStagedCorrectionInputs();
+  void DiscardStagedCorrectionInputs();
   Bool_t ProcessCorrections(const Float_t *variableContainer);
   Bool_t ProcessDataCollection(const Float_t *variableContainer);
   void IncludeQnVectors(TList *list);
@@ -67,10 +75,12 @@ public:
   /// \param index the position in the list of accepted data vector configuration
   /// \return the configuration name
   const char *GetAcceptedDataDetectorConfigurationName(Int_t index) const
-  { return fDataVectorAcceptedConfigurations.At(index)->GetName(); }
+  { return fDataVectorAcceptedConfigurationsTable[index]->GetName(); }
 
   void AttachCorrectionsManager(QnCorrectionsManager *manager);
   void AddDetectorConfiguration(QnCorrectionsDetectorConfigurationBase *detectorConfiguration);
+  void AddDetectorConfigurationFamily(QnCorrectionsDetectorConfigurationTracksFamily *family);
+  void AddDetectorConfigurationVariations(QnCorrectionsDetectorConfigurationTracksVariations *variations);
   QnCorrectionsDetectorConfigurationBase *FindDetectorConfiguration(const char *name);
   void FillDetectorConfigurationNameList(TList *list) const;
   void FillOverallInputCorrectionStepList(TList *list) const;
@@ -80,12 +90,39 @@ public:
   Int_t AddDataVector(const Float_t *variableContainer, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1);
 
   virtual void ClearDetector();
+  void FlushFillBuffers();
+  void BuildDispatchTables();
+  void BuildVariationsQnVectors();
+  void PreallocateDataVectorBanks(Int_t nNoOfDataVectors);
+  Long64_t GetNoOfDroppedDataVectors() const;
+  /// Gets the number of detector configurations in the dispatch table
+  /// \return the number of frozen detector configurations
+  Int_t GetNoOfDispatchedConfigurations() const { return fNoOfConfigurations; }
+  /// Gets the detector configuration at the passed dispatch table position
+  /// \param i the position in the dispatch table
+  /// \return the detector configuration
+  QnCorrectionsDetectorConfigurationBase *GetDispatchedConfiguration(Int_t i) const { return fConfigurationsTable[i]; }
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
 
 private:
+  Bool_t IncorporateDetectorConfiguration(QnCorrectionsDetectorConfigurationBase *detectorConfiguration);
+
   Int_t fDetectorId;            ///< detector Id
   QnCorrectionsDetectorConfigurationsSet fConfigurations;  ///< the set of configurations defined for this detector
-  QnCorrectionsDetectorConfigurationsSet fDataVectorAcceptedConfigurations; ///< the set of configurations that accepted a data vector
+  QnCorrectionsDetectorConfigurationsSet fDataVectorConfigurations; ///< the configurations which individually check data vectors
+  TObjArray fConfigurationFamilies; ///< the families of configurations defined for this detector, owned by it
+  TObjArray fConfigurationVariations; ///< the sets of systematic variations of configurations defined for this detector, owned by it
   QnCorrectionsManager *fCorrectionsManager; ///< the framework correction manager
+  Int_t fNoOfConfigurations;    //!<! the number of configurations in the configurations dispatch table
+  /// array, the detector configurations frozen at framework initialization
+  QnCorrectionsDetectorConfigurationBase **fConfigurationsTable; //!<!
+  Int_t fNoOfDataVectorConfigurations; //!<! the number of configurations in the data vector configurations dispatch table
+  /// array, the configurations which individually check data vectors frozen at framework initialization
+  QnCorrectionsDetectorConfigurationBase **fDataVectorConfigurationsTable; //!<!
+  Int_t fNoOfDataVectorAcceptedConfigurations; //!<! the number of configurations that accepted the last data vector
+  /// array, the configurations that accepted the last data vector, sized for all the configurations
+  QnCorrectionsDetectorConfigurationBase **fDataVectorAcceptedConfigurationsTable; //!<!
+  QnCorrectionsCoreHarmonicBasis fHarmonicBasis; //!<! the harmonic terms of the current event accepted data vectors
 
 private:
   /// Copy constructor
@@ -96,7 +133,7 @@ private:
   QnCorrectionsDetector& operator= (const QnCorrectionsDetector &);
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsDetector, 2);
+  ClassDef(QnCorrectionsDetector, 7);
 /// \endcond
 };
 
@@ -104,31 +141,76 @@ private:
 /// The request is transmitted to the attached detector configurations.
 /// The current content of the variable bank is passed in order to check
 /// for optional cuts tha define the detector configurations.
+/// Configurations belonging to a family get the data vector through
+/// the family which routes it to the proper one. Configurations belonging
+/// to a set of systematic variations get it through the set shared bank.
+///
+/// If any configuration accepts the data vector its harmonic terms
+/// are evaluated once in the detector harmonic basis and the stored
+/// data vectors are tagged with their row so that the configurations
+/// build their Q vectors without evaluating them again.
 /// \param variableContainer pointer to the variable content bank
 /// \param phi azimuthal angle
 /// \param weight the weight of the data vector
 /// \param channelId the channel Id that originates the data vector
 /// \return the number of detector configurations that accepted and stored the data vector
 inline Int_t QnCorrectionsDetector::AddDataVector(const Float_t *variableContainer, Double_t phi, Double_t weight, Int_t channelId) {
-  fDataVectorAcceptedConfigurations.Clear();
-  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
-    Bool_t ret = fConfigurations.At(ixConfiguration)->AddDataVector(variableContainer, phi, weight, channelId);
+  /* the row the data vector harmonic terms will take if accepted */
+  Int_t basisRow = fHarmonicBasis.GetNoOfRows();
+
+  fNoOfDataVectorAcceptedConfigurations = 0;
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfDataVectorConfigurations; ixConfiguration++) {
+    Bool_t ret = fDataVectorConfigurationsTable[ixConfiguration]->AddDataVector(variableContainer, phi, weight, channelId);
     if (ret) {
-      fDataVectorAcceptedConfigurations.Add(fConfigurations.At(ixConfiguration));
+      fDataVectorConfigurationsTable[ixConfiguration]->SetLastDataVectorBasisRow(basisRow);
+      fDataVectorAcceptedConfigurationsTable[fNoOfDataVectorAcceptedConfigurations++] = fDataVectorConfigurationsTable[ixConfiguration];
+    }
+  }
+  for (Int_t ixFamily = 0; ixFamily < fConfigurationFamilies.GetEntriesFast(); ixFamily++) {
+    QnCorrectionsDetectorConfigurationTracks *slice =
+        static_cast<QnCorrectionsDetectorConfigurationTracksFamily *>(fConfigurationFamilies.At(ixFamily))->AddDataVector(variableContainer, phi, weight, channelId);
+    if (slice != NULL) {
+      slice->SetLastDataVectorBasisRow(basisRow);
+      fDataVectorAcceptedConfigurationsTable[fNoOfDataVectorAcceptedConfigurations++] = slice;
+    }
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    QnCorrectionsDetectorConfigurationTracksVariations *variations =
+        static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations));
+    ULong64_t mask = variations->AddDataVector(variableContainer, phi, weight, channelId);
+    if (mask != 0) variations->SetLastBasisRow(basisRow);
+    for (Int_t variation = 0; mask != 0; variation++, mask >>= 1) {
+      if ((mask & 1) != 0) {
+        fDataVectorAcceptedConfigurationsTable[fNoOfDataVectorAcceptedConfigurations++] = variations->GetVariation(variation);
+      }
     }
   }
-  return fDataVectorAcceptedConfigurations.GetEntries();
+
+  /* evaluated for the azimuthal angle as the data vectors store it */
+  if (0 < fNoOfDataVectorAcceptedConfigurations) fHarmonicBasis.AddRow(Float_t(phi));
+  return fNoOfDataVectorAcceptedConfigurations;
+}
+
+/// Builds in one pass the Qn vectors of each set of systematic variations
+///
+/// Must precede the processing of the detector configurations
+inline void QnCorrectionsDetector::BuildVariationsQnVectors() {
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->BuildQnVectors();
+  }
 }
 
 /// Ask for processing corrections for the involved detector
 ///
-/// The request is transmitted to the attached detector configurations
+/// The Qn vectors of the sets of systematic variations are built in
+/// one pass and then the request is transmitted to the attached detector configurations
 /// \return kTRUE if everything went OK
 inline Bool_t QnCorrectionsDetector::ProcessCorrections(const Float_t *variableContainer) {
   Bool_t retValue = kTRUE;
 
-  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
-    Bool_t ret = fConfigurations.At(ixConfiguration)->ProcessCorrections(variableContainer);
+  BuildVariationsQnVectors();
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfConfigurations; ixConfiguration++) {
+    Bool_t ret = fConfigurationsTable[ixConfiguration]->ProcessCorrections(variableContainer);
     retValue = retValue && ret;
   }
   return retValue;
@@ -141,8 +223,8 @@ inline Bool_t QnCorrectionsDetector::ProcessCorrections(const Float_t *variableC
 inline Bool_t QnCorrectionsDetector::ProcessDataCollection(const Float_t *variableContainer) {
   Bool_t retValue = kTRUE;
 
-  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
-    Bool_t ret = fConfigurations.At(ixConfiguration)->ProcessDataCollection(variableContainer);
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfConfigurations; ixConfiguration++) {
+    Bool_t ret = fConfigurationsTable[ixConfiguration]->ProcessDataCollection(variableContainer);
     retValue = retValue && ret;
   }
   return retValue;
@@ -150,12 +232,18 @@ inline Bool_t QnCorrectionsDetector::ProcessDataCollection(const Float_t *variab
 
 /// Clean the detector to accept a new event
 ///
-/// Transfers the order to the detector configurations
+/// Transfers the order to the detector configurations and
+/// to the sets of systematic variations shared banks, and
+/// empties the harmonic basis keeping its storage
 inline void QnCorrectionsDetector::ClearDetector() {
   /* transfer the order to the Q vector corrections */
-  for (Int_t ixConfiguration = 0; ixConfiguration < fConfigurations.GetEntriesFast(); ixConfiguration++) {
-    fConfigurations.At(ixConfiguration)->ClearConfiguration();
+  for (Int_t ixConfiguration = 0; ixConfiguration < fNoOfConfigurations; ixConfiguration++) {
+    fConfigurationsTable[ixConfiguration]->ClearConfiguration();
+  }
+  for (Int_t ixVariations = 0; ixVariations < fConfigurationVariations.GetEntriesFast(); ixVariations++) {
+    static_cast<QnCorrectionsDetectorConfigurationTracksVariations *>(fConfigurationVariations.At(ixVariations))->ClearVariations();
   }
+  fHarmonicBasis.Clear();
 }
 
 #endif // QNCORRECTIONS_DETECTOR_H
@@ -33,6 +33,7 @@
 /// \brief Implementation of the base detector configuration class within Q vector correction framework
 
 #include "QnCorrectionsDetectorConfigurationBase.h"
+#include "QnCorrectionsManager.h"
 #include "QnCorrectionsLog.h"
 
 /// \cond CLASSIMP
@@ -52,8 +53,15 @@ QnCorrectionsDetectorConfigurationBase::QnCorrectionsDetectorConfigurationBase()
   fCorrectionsManager = NULL;
   fCuts = NULL;
   fDataVectorBank = NULL;
+  fDataVectorBankCapacity = kMaxInt;
+  fNoOfDroppedDataVectors = 0;
   fQnNormalizationMethod = QnCorrectionsQnVector::QVNORM_noCalibration;
   fEventClassVariables = NULL;
+  fHotDataArena = NULL;
+  fHotCuts = NULL;
+  fNoOfHotCuts = 0;
+  fHotCutsFlattened = kFALSE;
+  fHarmonicBasis = NULL;
   fPlainQ2nVector.SetHarmonicMultiplier(2);
   fCorrectedQ2nVector.SetHarmonicMultiplier(2);
   fTempQ2nVector.SetHarmonicMultiplier(2);
@@ -81,8 +89,15 @@ QnCorrectionsDetectorConfigurationBase::QnCorrectionsDetectorConfigurationBase(c
   fCorrectionsManager = NULL;
   fCuts = NULL;
   fDataVectorBank = NULL;
+  fDataVectorBankCapacity = kMaxInt;
+  fNoOfDroppedDataVectors = 0;
   fQnNormalizationMethod = QnCorrectionsQnVector::QVNORM_noCalibration;
   fEventClassVariables = eventClassesVariables;
+  fHotDataArena = NULL;
+  fHotCuts = NULL;
+  fNoOfHotCuts = 0;
+  fHotCutsFlattened = kFALSE;
+  fHarmonicBasis = NULL;
   fPlainQ2nVector.SetHarmonicMultiplier(2);
   fCorrectedQ2nVector.SetHarmonicMultiplier(2);
   fTempQ2nVector.SetHarmonicMultiplier(2);
@@ -90,7 +105,12 @@ QnCorrectionsDetectorConfigurationBase::QnCorrectionsDetectorConfigurationBase(c
 
 /// Default destructor
 /// Releases the memory which was taken or passed
+///
+/// The hot data arena takes with it the correction steps Qn vectors
 QnCorrectionsDetectorConfigurationBase::~QnCorrectionsDetectorConfigurationBase() {
+  if (fHotDataArena != NULL) {
+    delete fHotDataArena;
+  }
   if (fDataVectorBank != NULL) {
     delete fDataVectorBank;
   }
@@ -99,6 +119,20 @@ QnCorrectionsDetectorConfigurationBase::~QnCorrectionsDetectorConfigurationBase(
   }
 }
 
+/// Sets the set of cuts for the detector configuration
+///
+/// Once the hot data is laid out the cuts have been flattened into it,
+/// so a new set of cuts would not be evaluated and it is refused.
+/// \param cuts the set of cuts
+void QnCorrectionsDetectorConfigurationBase::SetCuts(QnCorrectionsCutsSet *cuts) {
+  if (fHotDataArena != NULL) {
+    QnCorrectionsFatal(Form("Detector configuration %s cuts are being set after its hot data was laid out. " \
+        "The cuts must be set before the framework initialization. FIX IT, PLEASE.", GetName()));
+    return;
+  }
+  fCuts = cuts;
+}
+
 /// Incorporates the passed correction to the set of Q vector corrections
 /// \param correctionOnQn the correction to add
 void QnCorrectionsDetectorConfigurationBase::AddCorrectionOnQnVector(QnCorrectionsCorrectionOnQvector *correctionOnQn) {
@@ -131,6 +165,73 @@ const QnCorrectionsQnVector *QnCorrectionsDetectorConfigurationBase::GetPrevious
     return &fPlainQnVector;
 }
 
+/// Get the histograms context of the framework manager
+///
+/// The histograms of the detector configuration and of its correction
+/// steps are filled with the fill modes of the framework manager.
+/// \return the histograms context the histograms should be created with
+QnCorrectionsHistogramsContext *QnCorrectionsDetectorConfigurationBase::GetHistogramsContext() const {
+  return fCorrectionsManager->GetHistogramsContext();
+}
+
+/// Include the correction steps partially corrected Qn vectors into the passed list
+///
+/// The correction steps transform in place the current Qn vector and
+/// only keep a snapshot of their corrected Qn vector when it will be
+/// read afterwards. Here is decided which snapshots are needed: the
+/// ones included in the list, if the framework manager is providing
+/// intermediate Qn vectors, and the ones that are the input of a
+/// subsequent correction step collecting data.
+/// \param list list where the corrected Qn vectors should be added
+void QnCorrectionsDetectorConfigurationBase::IncludeCorrectionStepsQnVectors(TList *list) {
+
+  Bool_t provideIntermediate =
+      (fCorrectionsManager == NULL) || fCorrectionsManager->GetShouldProvideIntermediateQnVectors();
+
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->SetKeepCorrectedQnVector(kFALSE);
+    if (provideIntermediate)
+      fQnVectorCorrections.At(ixCorrection)->IncludeCorrectedQnVector(list);
+  }
+  for (Int_t ixCorrection = 1; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    if (fQnVectorCorrections.At(ixCorrection)->IsCollectingData())
+      fQnVectorCorrections.At(ixCorrection - 1)->SetKeepCorrectedQnVector();
+  }
+}
+
+/// Asks for staging the input information of a new calibration
+///
+/// The detector configuration list is extracted from the passed list and
+/// the request is transmitted to the Q vector corrections with the found list.
+/// \param list list where the new input information should be found
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsDetectorConfigurationBase::StageCorrectionInputs(TList *list) {
+  TList *detectorConfigurationList = (TList *) list->FindObject(this->GetName());
+  Bool_t retValue = kTRUE;
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    retValue = fQnVectorCorrections.At(ixCorrection)->StageInput(detectorConfigurationList) && retValue;
+  }
+  return retValue;
+}
+
+/// Asks for replacing the input information in use by the staged one
+///
+/// The request is transmitted to the Q vector corrections
+void QnCorrectionsDetectorConfigurationBase::SwapStagedCorrectionInputs() {
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->SwapStagedInput();
+  }
+}
+
+/// Asks for deleting the staged input information
+///
+/// The request is transmitted to the Q vector corrections
+void QnCorrectionsDetectorConfigurationBase::DiscardStagedCorrectionInputs() {
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
+    fQnVectorCorrections.At(ixCorrection)->DiscardStagedInput();
+  }
+}
+
 /// Check if a concrete correction step is bein applied on this detector configuration
 /// It is not enough having the correction step configured or collecting data. To
 /// get an affirmative answer the correction step must be being applied.
@@ -187,3 +288,88 @@ Bool_t QnCorrectionsDetectorConfigurationBase::IsSelected(const Float_t *variabl
   return kFALSE;
 }
 
+/// Registers the variables Ids the detector configuration reads from
+/// the variables bank for their remapping into a dense variables bank
+///
+/// The cuts and the event class variables are registered.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetectorConfigurationBase::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  if (fCuts != NULL) fCuts->RegisterDataVariables(bank);
+  if (fEventClassVariables != NULL) fEventClassVariables->RegisterDataVariables(bank);
+}
+
+/// Preallocates the data vector bank for the passed number of data vectors
+///
+/// The data vectors are constructed in advance and the bank is
+/// bounded to them so that no allocation happens while storing
+/// the data vectors of an event. The data vectors which do not
+/// fit are dropped and accounted. Configurations sharing the data
+/// vector bank of other ones do not own any bank to preallocate.
+/// \param nNoOfDataVectors the capacity of the data vector bank
+void QnCorrectionsDetectorConfigurationBase::PreallocateDataVectorBank(Int_t nNoOfDataVectors) {
+  if (fDataVectorBank == NULL) return;
+
+  fDataVectorBank->ExpandCreate(nNoOfDataVectors);
+  fDataVectorBank->Clear("C");
+  fDataVectorBankCapacity = nNoOfDataVectors;
+}
+
+/// Rejects the request of the input data bank of a detector
+/// configuration without a data vectors bank of its own
+///
+/// Raise an execution error. The data vectors of the detector
+/// configurations sharing the bank of other configuration, as the
+/// systematic variations ones, are only reachable through the bank owner.
+void QnCorrectionsDetectorConfigurationBase::RejectInputDataBankRequest() const {
+  QnCorrectionsFatal(Form("Detector configuration %s has no data vectors bank of its own or it is not yet created. FIX IT, PLEASE.",
+      GetName()));
+}
+
+/// Lays out the per event hot data of the detector configuration
+///
+/// A fresh arena is started and the detector configuration cuts, already
+/// with their final variables Ids, are flattened at its beginning, as they
+/// are the first thing the per event processing reads. If any of the cuts
+/// has no core equivalent nothing is flattened and the cuts set is evaluated
+/// instead. To be called when
+/// the support data structures are created and before the correction steps
+/// create theirs, so that their Qn vectors follow in the arena in the order
+/// of the steps execution.
+void QnCorrectionsDetectorConfigurationBase::LayOutHotData() {
+  if (fHotDataArena != NULL) delete fHotDataArena;
+  fHotDataArena = new QnCorrectionsCoreArena();
+  fHotCuts = NULL;
+  fNoOfHotCuts = 0;
+  fHotCutsFlattened = kTRUE;
+
+  if (fCuts != NULL) {
+    QnCorrectionsCoreCutsSet coreCuts;
+    fHotCutsFlattened = fCuts->FillCoreCutsSet(coreCuts);
+    if (fHotCutsFlattened) {
+      fNoOfHotCuts = coreCuts.GetEntries();
+      if (0 < fNoOfHotCuts) {
+        fHotCuts = fHotDataArena->NewArrayCopy(&coreCuts.At(0), fNoOfHotCuts);
+      }
+    }
+  }
+}
+
+/// Creates a Qn vector for a correction step in the hot data arena
+///
+/// The Qn vector supports the detector configuration harmonics and
+/// is adjacent to the previously laid out hot data. It is owned by
+/// the detector configuration and should not be deleted by the step.
+/// \param name the name of the new Qn vector
+/// \return the new Qn vector
+QnCorrectionsQnVector *QnCorrectionsDetectorConfigurationBase::NewCorrectionStepQnVector(const char *name) {
+  if (fHotDataArena == NULL) fHotDataArena = new QnCorrectionsCoreArena();
+
+  Int_t nNoOfHarmonics = GetNoOfHarmonics();
+  Int_t *harmonicsMap = new Int_t[nNoOfHarmonics];
+  GetHarmonicMap(harmonicsMap);
+  QnCorrectionsQnVector *qnVector =
+      new (fHotDataArena->Allocate(sizeof(QnCorrectionsQnVector))) QnCorrectionsQnVector(name, nNoOfHarmonics, harmonicsMap);
+  fHotDataArena->Adopt(qnVector);
+  delete [] harmonicsMap;
+  return qnVector;
+}
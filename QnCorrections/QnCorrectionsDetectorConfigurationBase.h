@@ -20,6 +20,9 @@
 #include <TObjArray.h>
 #include <TClonesArray.h>
 #include <TH3.h>
+#include "QnCorrectionsCoreArena.h"
+#include "QnCorrectionsCoreHarmonicBasis.h"
+#include "QnCorrectionsDataVector.h"
 #include "QnCorrectionsCutsSet.h"
 #include "QnCorrectionsCorrectionsSetOnInputData.h"
 #include "QnCorrectionsCorrectionsSetOnQvector.h"
@@ -30,6 +33,7 @@
 class QnCorrectionsDetectorConfigurationsSet;
 class QnCorrectionsDetector;
 class QnCorrectionsManager;
+class QnCorrectionsHistogramsContext;
 
 /// \class QnCorrectionsDetectorConfigurationBase
 /// \brief The base of a concrete detector configuration within Q vector correction framework
@@ -71,10 +75,7 @@ public:
       Int_t *harmonicMap = NULL);
   virtual ~QnCorrectionsDetectorConfigurationBase();
 
-  /// Sets the set of cuts for the detector configuration
-  /// \param cuts the set of cuts
-  void SetCuts(QnCorrectionsCutsSet *cuts)
-  { fCuts = cuts; }
+  void SetCuts(QnCorrectionsCutsSet *cuts);
   /// Sets the normalization method for Q vectors
   /// \param method the Qn vector normalizatio method
   void SetQVectorNormalizationMethod(QnCorrectionsQnVector::QnVectorNormalizationMethod method)
@@ -95,10 +96,12 @@ public:
   virtual void AttachCorrectionsManager(QnCorrectionsManager *manager) = 0;
 public:
   /// Get the input data bank.
-  /// Makes it available for input corrections steps.
+  /// Makes it available for input corrections steps. Detector configurations
+  /// sharing the data vectors bank of other configuration, as the systematic
+  /// variations ones, have no bank of their own and the request is rejected.
   /// \return pointer to the input data bank
   TClonesArray *GetInputDataBank()
-  { return fDataVectorBank; }
+  { if (fDataVectorBank == NULL) RejectInputDataBankRequest(); return fDataVectorBank; }
   /// Get the event class variables set
   /// Makes it available for corrections steps
   /// \return pointer to the event class variables set
@@ -135,6 +138,14 @@ public:
   /// \param changename kTRUE by default to keep track of the subsequent Qn vector corrections
   void UpdateCurrentQnVector(QnCorrectionsQnVector *newQnVector, Bool_t changename = kTRUE)
   { fCorrectedQnVector.Set(newQnVector, changename); }
+  /// Tags the current Qn vector as corrected by a correction step
+  ///
+  /// The correction steps transform the current Qn vector in place.
+  /// To keep track of the subsequent Qn vector corrections the
+  /// current Qn vector takes the name of the step corrected Qn vector.
+  /// \param stepQnVector the correction step corrected Qn vector
+  void TagCurrentQnVector(const QnCorrectionsQnVector *stepQnVector)
+  { fCorrectedQnVector.SetName(stepQnVector->GetName()); fCorrectedQnVector.SetTitle(stepQnVector->GetTitle()); }
   /// Update the current Q2n vector
   /// Update towards what is the latest values of the Q2n vector after executing a
   /// correction step to make it available to further steps.
@@ -153,6 +164,7 @@ public:
   /// Get the pointer to the framework manager
   /// \return the stored pointer to the corrections framework
   QnCorrectionsManager *GetCorrectionsManager() const { return fCorrectionsManager; }
+  QnCorrectionsHistogramsContext *GetHistogramsContext() const;
   /// Get if the detector configuration is own by a tracking detector
   /// Pure virtual function
   /// \return TRUE if it is a tracking detector configuration
@@ -202,6 +214,9 @@ public:
   ///
   /// Pure virtual function
   virtual void AfterInputsAttachActions() = 0;
+  virtual Bool_t StageCorrectionInputs(TList *list);
+  virtual void SwapStagedCorrectionInputs();
+  virtual void DiscardStagedCorrectionInputs();
   /// Ask for processing corrections for the involved detector configuration
   ///
   /// Pure virtual function.
@@ -262,6 +277,33 @@ public:
   /// Clean the configuration to accept a new event
   /// Pure virtual function
   virtual void ClearConfiguration() = 0;
+  /// Performs the fills the configuration keeps buffered
+  ///
+  /// Default behavior: nothing is buffered
+  virtual void FlushFillBuffers() {}
+  /// Freezes the correction steps in the dispatch tables walked by the per event code
+  ///
+  /// To be called at framework initialization
+  virtual void BuildDispatchTables() { fQnVectorCorrections.BuildDispatchTable(); }
+  virtual void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+  virtual void PreallocateDataVectorBank(Int_t nNoOfDataVectors);
+  /// Gets the number of data vectors dropped for exceeding the preallocated data vector bank
+  /// \return the number of dropped data vectors
+  Long64_t GetNoOfDroppedDataVectors() const { return fNoOfDroppedDataVectors; }
+  QnCorrectionsQnVector *NewCorrectionStepQnVector(const char *name);
+  /// Gets the size of the per event hot data laid out in the detector configuration arena
+  /// \return the number of bytes of hot data
+  Long64_t GetHotDataSize() const { return ((fHotDataArena != NULL) ? Long64_t(fHotDataArena->GetNoOfBytes()) : 0); }
+  /// Sets the harmonic basis where the detector keeps the harmonic terms of the current data vectors
+  /// \param basis the detector harmonic basis
+  void SetHarmonicBasis(const QnCorrectionsCoreHarmonicBasis *basis) { fHarmonicBasis = basis; }
+  void SetLastDataVectorBasisRow(Int_t row);
+
+protected:
+  void IncludeCorrectionStepsQnVectors(TList *list);
+  void RejectInputDataBankRequest() const;
+  virtual void LayOutHotData();
+  Bool_t PassesCuts(const Float_t *variableContainer) const;
 
 private:
   QnCorrectionsDetector *fDetector;    ///< pointer to the detector that owns the configuration
@@ -273,6 +315,8 @@ protected:
 /// The default initial size of data vectors banks
 #define INITIALDATAVECTORBANKSIZE 100000
   TClonesArray *fDataVectorBank;        //!<! input data for the current process / event
+  Int_t fDataVectorBankCapacity;        //!<! the data vectors the bank holds, only bounded once preallocated
+  Long64_t fNoOfDroppedDataVectors;     //!<! the data vectors dropped for exceeding the bank capacity
   QnCorrectionsQnVector fPlainQnVector;     ///< Qn vector from the post processed input data
   QnCorrectionsQnVector fPlainQ2nVector;     ///< Q2n vector from the post processed input data
   QnCorrectionsQnVector fCorrectedQnVector; ///< Qn vector after subsequent correction steps
@@ -283,6 +327,11 @@ protected:
   QnCorrectionsCorrectionsSetOnQvector fQnVectorCorrections; ///< set of corrections to apply on Q vectors
   /// set of variables that define event classes
   QnCorrectionsEventClassVariablesSet    *fEventClassVariables; //->
+  QnCorrectionsCoreArena *fHotDataArena; //!<! contiguous storage of the per event hot data in access order
+  const QnCorrectionsCoreCut *fHotCuts;  //!<! the set of cuts flattened in the hot data arena
+  Int_t fNoOfHotCuts;                    //!<! the number of flattened cuts
+  Bool_t fHotCutsFlattened;              //!<! the flattened cuts stand for the whole set of cuts
+  const QnCorrectionsCoreHarmonicBasis *fHarmonicBasis; //!<! the detector harmonic basis of the current data vectors
 
 private:
   /// Copy constructor
@@ -293,8 +342,36 @@ private:
   QnCorrectionsDetectorConfigurationBase& operator= (const QnCorrectionsDetectorConfigurationBase &);
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsDetectorConfigurationBase, 3);
+  ClassDef(QnCorrectionsDetectorConfigurationBase, 4);
 /// \endcond
 };
 
+/// Tags the data vector just stored with its row in the detector harmonic basis
+///
+/// Nothing is done if the detector configuration does not own a data vector bank.
+/// \param row the harmonic basis row of the data vector
+inline void QnCorrectionsDetectorConfigurationBase::SetLastDataVectorBasisRow(Int_t row) {
+  if (fDataVectorBank != NULL)
+    static_cast<QnCorrectionsDataVector *>(fDataVectorBank->At(fDataVectorBank->GetEntriesFast() - 1))->SetBasisRow(row);
+}
+
+/// Checks if the current content of the variable bank passes the
+/// detector configuration cuts
+///
+/// The flattened cuts in the hot data arena are the ones evaluated. If
+/// they do not stand for the whole set of cuts, the set of cuts is
+/// evaluated instead.
+/// \param variableContainer pointer to the variable content bank
+/// \return kTRUE if the current content passes the whole set of cuts
+inline Bool_t QnCorrectionsDetectorConfigurationBase::PassesCuts(const Float_t *variableContainer) const {
+  if (!fHotCutsFlattened)
+    return ((fCuts != NULL) ? fCuts->IsSelected(variableContainer) : kTRUE);
+  for (Int_t icut = 0; icut < fNoOfHotCuts; icut++) {
+    if (!fHotCuts[icut].IsSelected(variableContainer)) {
+      return kFALSE;
+    }
+  }
+  return kTRUE;
+}
+
 #endif // QNCORRECTIONS_DETECTORCONFIGBASE_H
@@ -46,13 +46,15 @@ const char *QnCorrectionsDetectorConfigurationChannels::szQAQnAverageHistogramNa
 
 /// Default constructor
 QnCorrectionsDetectorConfigurationChannels::QnCorrectionsDetectorConfigurationChannels() :
-    QnCorrectionsDetectorConfigurationBase(), fRawQnVector(), fInputDataCorrections() {
+    QnCorrectionsDetectorConfigurationBase(), fRawQnVector(), fInputDataCorrections(), fQAMultiplicityFillBuffer() {
 
   fNoOfChannels = 0;
   fUsedChannel = NULL;
   fChannelMap = NULL;
   fChannelGroup = NULL;
   fHardCodedGroupWeights = NULL;
+  fHotUsedChannel = NULL;
+  fHotChannelMap = NULL;
   /* QA section */
   fQACentralityVarId = -1;
   fQAnBinsMultiplicity = 100;
@@ -77,12 +79,15 @@ QnCorrectionsDetectorConfigurationChannels::QnCorrectionsDetectorConfigurationCh
       Int_t *harmonicMap) :
           QnCorrectionsDetectorConfigurationBase(name, eventClassesVariables, nNoOfHarmonics, harmonicMap),
           fRawQnVector(szRawQnVectorName, nNoOfHarmonics, harmonicMap),
-          fInputDataCorrections() {
+          fInputDataCorrections(),
+          fQAMultiplicityFillBuffer() {
   fNoOfChannels = nNoOfChannels;
   fUsedChannel = NULL;
   fChannelMap = NULL;
   fChannelGroup = NULL;
   fHardCodedGroupWeights = NULL;
+  fHotUsedChannel = NULL;
+  fHotChannelMap = NULL;
   /* QA section */
   fQACentralityVarId = -1;
   fQAnBinsMultiplicity = 100;
@@ -191,6 +196,9 @@ void QnCorrectionsDetectorConfigurationChannels::CreateSupportDataStructures() {
   /* this is executed in the remote node so, allocate the data bank */
   fDataVectorBank = new TClonesArray("QnCorrectionsDataVectorChannelized", INITIALDATAVECTORBANKSIZE);
 
+  /* the hot data goes first so that the correction steps Qn vectors follow it */
+  LayOutHotData();
+
   for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
     fInputDataCorrections.At(ixCorrection)->CreateSupportDataStructures();
   }
@@ -200,6 +208,22 @@ void QnCorrectionsDetectorConfigurationChannels::CreateSupportDataStructures() {
   }
 }
 
+/// Lays out the per event hot data of the detector configuration
+///
+/// On top of the base hot data, the used channels mask, read for each
+/// data vector, and the channels map, read for the QA of each data vector,
+/// are copied to the hot data arena.
+void QnCorrectionsDetectorConfigurationChannels::LayOutHotData() {
+  QnCorrectionsDetectorConfigurationBase::LayOutHotData();
+
+  fHotUsedChannel = NULL;
+  fHotChannelMap = NULL;
+  if (fUsedChannel != NULL) {
+    fHotUsedChannel = fHotDataArena->NewArrayCopy(fUsedChannel, fNoOfChannels);
+    fHotChannelMap = fHotDataArena->NewArrayCopy(fChannelMap, fNoOfChannels);
+  }
+}
+
 /// Asks for support histograms creation
 ///
 /// A new histograms list is created for the detector and incorporated
@@ -324,6 +348,8 @@ Bool_t QnCorrectionsDetectorConfigurationChannels::CreateQAHistograms(TList *lis
 
     detectorConfigurationList->Add(fQAMultiplicityBefore3D);
     detectorConfigurationList->Add(fQAMultiplicityAfter3D);
+    /* the multiplicity histograms use the same fill buffer size than the framework histograms */
+    fQAMultiplicityFillBuffer.SetCapacity(GetHistogramsContext()->GetDefaultFillBufferSize());
   }
 
   /* now propagate it to the input data corrections */
@@ -337,6 +363,7 @@ Bool_t QnCorrectionsDetectorConfigurationChannels::CreateQAHistograms(TList *lis
       Form("%s %s", szQAQnAverageHistogramName, this->GetName()),
       Form("%s %s", szQAQnAverageHistogramName, this->GetName()),
       this->GetEventClassVariablesSet());
+  fQAQnAverageHistogram->SetHistogramsContext(GetHistogramsContext());
 
   /* get information about the configured harmonics to pass it for histogram creation */
   Int_t nNoOfHarmonics = this->GetNoOfHarmonics();
@@ -435,6 +462,50 @@ void QnCorrectionsDetectorConfigurationChannels::AfterInputsAttachActions() {
   }
 }
 
+/// Asks for staging the input information of a new calibration
+///
+/// The detector configuration list is extracted from the passed list and
+/// the request is transmitted to the input data corrections and then
+/// propagated to the Q vector corrections
+/// \param list list where the new input information should be found
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsDetectorConfigurationChannels::StageCorrectionInputs(TList *list) {
+  TList *detectorConfigurationList = (TList *) list->FindObject(this->GetName());
+  Bool_t retValue = kTRUE;
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    retValue = fInputDataCorrections.At(ixCorrection)->StageInput(detectorConfigurationList) && retValue;
+  }
+
+  /* now propagate it to Q vector corrections */
+  return QnCorrectionsDetectorConfigurationBase::StageCorrectionInputs(list) && retValue;
+}
+
+/// Asks for replacing the input information in use by the staged one
+///
+/// The request is transmitted to the input data corrections
+/// and then propagated to the Q vector corrections
+void QnCorrectionsDetectorConfigurationChannels::SwapStagedCorrectionInputs() {
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    fInputDataCorrections.At(ixCorrection)->SwapStagedInput();
+  }
+
+  /* now propagate it to Q vector corrections */
+  QnCorrectionsDetectorConfigurationBase::SwapStagedCorrectionInputs();
+}
+
+/// Asks for deleting the staged input information
+///
+/// The request is transmitted to the input data corrections
+/// and then propagated to the Q vector corrections
+void QnCorrectionsDetectorConfigurationChannels::DiscardStagedCorrectionInputs() {
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
+    fInputDataCorrections.At(ixCorrection)->DiscardStagedInput();
+  }
+
+  /* now propagate it to Q vector corrections */
+  QnCorrectionsDetectorConfigurationBase::DiscardStagedCorrectionInputs();
+}
+
 /// Incorporates the passed correction to the set of input data corrections
 /// \param correctionOnInputData the correction to add
 void QnCorrectionsDetectorConfigurationChannels::AddCorrectionOnInputData(QnCorrectionsCorrectionOnInputData *correctionOnInputData) {
@@ -450,8 +521,17 @@ void QnCorrectionsDetectorConfigurationChannels::FillQAHistograms(const Float_t
     for(Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++){
       QnCorrectionsDataVectorChannelized *dataVector =
           static_cast<QnCorrectionsDataVectorChannelized *>(fDataVectorBank->At(ixData));
-      fQAMultiplicityBefore3D->Fill(variableContainer[fQACentralityVarId], fChannelMap[dataVector->GetId()], dataVector->Weight());
-      fQAMultiplicityAfter3D->Fill(variableContainer[fQACentralityVarId], fChannelMap[dataVector->GetId()], dataVector->EqualizedWeight());
+      if (fQAMultiplicityFillBuffer.IsEnabled()) {
+        fQAMultiplicityFillBuffer.Add(0,
+            fQAMultiplicityBefore3D->FindFixBin(variableContainer[fQACentralityVarId], fHotChannelMap[dataVector->GetId()], dataVector->Weight()), 1.0);
+        if (fQAMultiplicityFillBuffer.Add(1,
+            fQAMultiplicityAfter3D->FindFixBin(variableContainer[fQACentralityVarId], fHotChannelMap[dataVector->GetId()], dataVector->EqualizedWeight()), 1.0))
+          FlushFillBuffers();
+      }
+      else {
+        fQAMultiplicityBefore3D->Fill(variableContainer[fQACentralityVarId], fHotChannelMap[dataVector->GetId()], dataVector->Weight());
+        fQAMultiplicityAfter3D->Fill(variableContainer[fQACentralityVarId], fHotChannelMap[dataVector->GetId()], dataVector->EqualizedWeight());
+      }
     }
   }
   if (fQAQnAverageHistogram != NULL) {
@@ -464,6 +544,51 @@ void QnCorrectionsDetectorConfigurationChannels::FillQAHistograms(const Float_t
   }
 }
 
+/// Freezes the correction steps in the dispatch tables walked by the per event code
+///
+/// Both the corrections on input data and on the Qn vector.
+/// To be called at framework initialization
+void QnCorrectionsDetectorConfigurationChannels::BuildDispatchTables() {
+  fInputDataCorrections.BuildDispatchTable();
+  fQnVectorCorrections.BuildDispatchTable();
+}
+
+/// Registers the variables Ids the detector configuration reads from
+/// the variables bank for their remapping into a dense variables bank
+///
+/// On top of the base ones, the QA centrality variable is registered.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetectorConfigurationChannels::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  QnCorrectionsDetectorConfigurationBase::RegisterDataVariables(bank);
+  bank.Register(fQACentralityVarId);
+}
+
+/// Performs the buffered fills of the QA multiplicity histograms
+///
+/// The buffered fills are coalesced by histogram bin and each bin
+/// content is updated once with its number of fills. As the fills
+/// have unit weight the result is exactly the one of immediate fills.
+/// The histograms statistics are then computed from the bins content.
+void QnCorrectionsDetectorConfigurationChannels::FlushFillBuffers() {
+  Int_t nEntries = fQAMultiplicityFillBuffer.Coalesce();
+  if (nEntries == 0) return;
+
+  TH3F *histograms[2] = {fQAMultiplicityBefore3D, fQAMultiplicityAfter3D};
+  Int_t nFills[2] = {0, 0};
+  for (Int_t entry = 0; entry < nEntries; entry++) {
+    TH3F *histogram = histograms[fQAMultiplicityFillBuffer.GetTarget(entry)];
+    Int_t bin = Int_t(fQAMultiplicityFillBuffer.GetBin(entry));
+    histogram->AddBinContent(bin, fQAMultiplicityFillBuffer.GetSumValues(entry));
+    if (histogram->GetSumw2N() != 0)
+      histogram->GetSumw2()->fArray[bin] += fQAMultiplicityFillBuffer.GetSumValues2(entry);
+    nFills[fQAMultiplicityFillBuffer.GetTarget(entry)] += fQAMultiplicityFillBuffer.GetNoOfFills(entry);
+  }
+  for (Int_t target = 0; target < 2; target++) {
+    histograms[target]->SetEntries(histograms[target]->GetEntries() + nFills[target]);
+  }
+  fQAMultiplicityFillBuffer.Clear();
+}
+
 /// Include the the list of Qn vector associated to the detector configuration
 /// into the passed list
 ///
@@ -473,7 +598,8 @@ void QnCorrectionsDetectorConfigurationChannels::FillQAHistograms(const Float_t
 /// Always includes first the fully corrected Qn vector,
 /// and then includes the raw Qn vector and the plain Qn vector and then
 /// asks to the different correction
-/// steps to include their partially corrected Qn vectors.
+/// steps to include their partially corrected Qn vectors, if the framework
+/// manager is providing intermediate Qn vectors.
 ///
 /// The check if we are already there is because it could be late information
 /// about the process name and then the correction histograms could still not
@@ -499,9 +625,7 @@ inline void QnCorrectionsDetectorConfigurationChannels::IncludeQnVectors(TList *
   detectorConfigurationList->Add(&fCorrectedQnVector);
   detectorConfigurationList->Add(&fRawQnVector);
   detectorConfigurationList->Add(&fPlainQnVector);
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    fQnVectorCorrections.At(ixCorrection)->IncludeCorrectedQnVector(detectorConfigurationList);
-  }
+  IncludeCorrectionStepsQnVectors(detectorConfigurationList);
   if (!bAlreadyThere)
     list->Add(detectorConfigurationList);
 }
@@ -18,6 +18,7 @@
 #include "QnCorrectionsCorrectionsSetOnInputData.h"
 #include "QnCorrectionsDataVectorChannelized.h"
 #include "QnCorrectionsDetectorConfigurationBase.h"
+#include "QnCorrectionsCoreFillBuffer.h"
 
 class QnCorrectionsProfileComponents;
 
@@ -94,6 +95,9 @@ public:
   { QnCorrectionsDetectorConfigurationBase::ActivateHarmonic(harmonic); fRawQnVector.ActivateHarmonic(harmonic); }
   virtual Bool_t AttachCorrectionInputs(TList *list);
   virtual void AfterInputsAttachActions();
+  virtual Bool_t StageCorrectionInputs(TList *list);
+  virtual void SwapStagedCorrectionInputs();
+  virtual void DiscardStagedCorrectionInputs();
   virtual Bool_t ProcessCorrections(const Float_t *variableContainer);
   virtual Bool_t ProcessDataCollection(const Float_t *variableContainer);
 
@@ -114,12 +118,18 @@ public:
   /// \param nChannel the interested external channel number
   /// \return kTRUE if the current content applies to the configuration
   virtual Bool_t IsSelected(const Float_t *variableContainer, Int_t nChannel)
-    { return ((fUsedChannel[nChannel]) ? ((fCuts != NULL) ? fCuts->IsSelected(variableContainer) : kTRUE) : kFALSE); }
+    { return ((fHotUsedChannel[nChannel]) ? PassesCuts(variableContainer) : kFALSE); }
   /// wrong call for this class invoke base class behavior
   virtual Bool_t IsSelected(const Float_t *variableContainer)
   { return QnCorrectionsDetectorConfigurationBase::IsSelected(variableContainer); }
 
   virtual void ClearConfiguration();
+  virtual void FlushFillBuffers();
+  virtual void BuildDispatchTables();
+  virtual void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+
+protected:
+  virtual void LayOutHotData();
 
 private:
   static const char *szRawQnVectorName;   ///< the name of the raw Qn vector from raw data without input data corrections
@@ -133,6 +143,8 @@ private:
   Int_t *fChannelGroup;                   //[fNoOfChannels]
   /// array, group hard coded weight
   Float_t *fHardCodedGroupWeights;         //[fNoOfChannels]
+  const Bool_t *fHotUsedChannel;          //!<! the used channels mask in the hot data arena
+  const Int_t *fHotChannelMap;            //!<! the external to internal channel map in the hot data arena
   QnCorrectionsCorrectionsSetOnInputData fInputDataCorrections; ///< set of corrections to apply on input data vectors
 
   /* QA section */
@@ -145,6 +157,7 @@ private:
   Float_t fQAMultiplicityMax; ///< maximum multiplicity value
   TH3F *fQAMultiplicityBefore3D; //!<! 3D channel multiplicity histogram before input equalization
   TH3F *fQAMultiplicityAfter3D;  //!<! 3D channel multiplicity histogram after input equalization
+  QnCorrectionsCoreFillBuffer fQAMultiplicityFillBuffer; //!<! the fill buffer for the 3D channel multiplicity histograms
   QnCorrectionsProfileComponents *fQAQnAverageHistogram; //!<! the plain average Qn components QA histogram
 
 private:
@@ -156,7 +169,7 @@ private:
   QnCorrectionsDetectorConfigurationChannels& operator= (const QnCorrectionsDetectorConfigurationChannels &);
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsDetectorConfigurationChannels, 2);
+  ClassDef(QnCorrectionsDetectorConfigurationChannels, 3);
 /// \endcond
 };
 
@@ -173,6 +186,11 @@ private:
 inline Bool_t QnCorrectionsDetectorConfigurationChannels::AddDataVector(
     const Float_t *variableContainer, Double_t phi, Double_t weight, Int_t channelId) {
   if (IsSelected(variableContainer, channelId)) {
+    if (!(fDataVectorBank->GetEntriesFast() < fDataVectorBankCapacity)) {
+      /* the preallocated bank is full */
+      fNoOfDroppedDataVectors++;
+      return kFALSE;
+    }
     /// add the data vector to the bank
     new (fDataVectorBank->ConstructedAt(fDataVectorBank->GetEntriesFast()))
       QnCorrectionsDataVectorChannelized(channelId, phi, weight);
@@ -185,12 +203,19 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::AddDataVector(
 /// data corrections but considering the chosen calibration method.
 /// This is a channelized configuration so this Q vector will NOT be
 /// the one to be used for subsequent Q vector corrections.
+///
+/// The harmonic terms of the data vectors are taken from the detector
+/// harmonic basis when they were evaluated there.
 inline void QnCorrectionsDetectorConfigurationChannels::BuildRawQnVector() {
   fTempQnVector.Reset();
 
   for(Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++){
     QnCorrectionsDataVectorChannelized *dataVector = static_cast<QnCorrectionsDataVectorChannelized *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
+    Int_t row = dataVector->GetBasisRow();
+    if (row < 0)
+      fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
+    else
+      fTempQnVector.AddFromBasis(fHarmonicBasis->GetCos(row), fHarmonicBasis->GetSin(row), dataVector->Weight());
   }
   fTempQnVector.CheckQuality();
   fTempQnVector.Normalize(fQnNormalizationMethod);
@@ -201,14 +226,24 @@ inline void QnCorrectionsDetectorConfigurationChannels::BuildRawQnVector() {
 /// and considering the chosen calibration method.
 /// The built Q vector is the one to be used for
 /// subsequent Q vector corrections.
+///
+/// The harmonic terms of the data vectors are taken from the detector
+/// harmonic basis when they were evaluated there.
 inline void QnCorrectionsDetectorConfigurationChannels::BuildQnVector() {
   fTempQnVector.Reset();
   fTempQ2nVector.Reset();
 
   for(Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++){
     QnCorrectionsDataVectorChannelized *dataVector = static_cast<QnCorrectionsDataVectorChannelized *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
-    fTempQ2nVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
+    Int_t row = dataVector->GetBasisRow();
+    if (row < 0) {
+      fTempQnVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
+      fTempQ2nVector.Add(dataVector->Phi(), dataVector->EqualizedWeight());
+    }
+    else {
+      fTempQnVector.AddFromBasis(fHarmonicBasis->GetCos(row), fHarmonicBasis->GetSin(row), dataVector->EqualizedWeight());
+      fTempQ2nVector.AddFromBasis(fHarmonicBasis->GetCos(row), fHarmonicBasis->GetSin(row), dataVector->EqualizedWeight());
+    }
   }
   fTempQnVector.CheckQuality();
   fTempQ2nVector.CheckQuality();
@@ -233,8 +268,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessCorrections(con
   BuildRawQnVector();
 
   /* then we transfer the request to the input data correction steps */
-  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
-    if (fInputDataCorrections.At(ixCorrection)->ProcessCorrections(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fInputDataCorrections.GetDispatchedStep(ixCorrection)->ProcessCorrections(variableContainer))
       continue;
     else
       return kFALSE;
@@ -244,8 +279,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessCorrections(con
   BuildQnVector();
 
   /* now let's propagate it to Q vector corrections */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    if (fQnVectorCorrections.At(ixCorrection)->ProcessCorrections(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ProcessCorrections(variableContainer))
       continue;
     else
       return kFALSE;
@@ -263,8 +298,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessCorrections(con
 inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessDataCollection(const Float_t *variableContainer) {
 
   /* we transfer the request to the input data correction steps */
-  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
-    if (fInputDataCorrections.At(ixCorrection)->ProcessDataCollection(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fInputDataCorrections.GetDispatchedStep(ixCorrection)->ProcessDataCollection(variableContainer))
       continue;
     else
       return kFALSE;
@@ -274,8 +309,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessDataCollection(
   FillQAHistograms(variableContainer);
 
   /* now let's propagate it to Q vector corrections */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    if (fQnVectorCorrections.At(ixCorrection)->ProcessDataCollection(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ProcessDataCollection(variableContainer))
       continue;
     else
       return kFALSE;
@@ -292,12 +327,12 @@ inline Bool_t QnCorrectionsDetectorConfigurationChannels::ProcessDataCollection(
 /// for accepting the next event.
 inline void QnCorrectionsDetectorConfigurationChannels::ClearConfiguration() {
   /* transfer the order to the Q vector corrections */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    fQnVectorCorrections.At(ixCorrection)->ClearCorrectionStep();
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ClearCorrectionStep();
   }
   /* transfer the order to the data vector corrections */
-  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetEntries(); ixCorrection++) {
-    fInputDataCorrections.At(ixCorrection)->ClearCorrectionStep();
+  for (Int_t ixCorrection = 0; ixCorrection < fInputDataCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    fInputDataCorrections.GetDispatchedStep(ixCorrection)->ClearCorrectionStep();
   }
   /* clean the raw Q vector */
   fRawQnVector.Reset();
@@ -32,6 +32,7 @@
 /// \file QnCorrectionsDetectorConfigurationTracks.cxx
 /// \brief Implementation of the track detector configuration class
 
+#include <TH1.h>
 #include "QnCorrectionsProfileComponents.h"
 #include "QnCorrectionsDetectorConfigurationTracks.h"
 #include "QnCorrectionsLog.h"
@@ -41,11 +42,20 @@ ClassImp(QnCorrectionsDetectorConfigurationTracks);
 /// \endcond
 
 const char *QnCorrectionsDetectorConfigurationTracks::szQAQnAverageHistogramName = "Plain Qn avg ";
+const Int_t QnCorrectionsDetectorConfigurationTracks::nWeightsMapPhiAxis = -1;
+const Int_t QnCorrectionsDetectorConfigurationTracks::nWeightsMapNoAxis = -2;
 
 /// Default constructor
-QnCorrectionsDetectorConfigurationTracks::QnCorrectionsDetectorConfigurationTracks() : QnCorrectionsDetectorConfigurationBase() {
+QnCorrectionsDetectorConfigurationTracks::QnCorrectionsDetectorConfigurationTracks() : QnCorrectionsDetectorConfigurationBase(),
+    fRecordedVariablesIds(),
+    fRecordedVariables(),
+    fWeightsMapBinning(),
+    fWeightsMap() {
 
   fQAQnAverageHistogram = NULL;
+  fSharedDataBank = kFALSE;
+  fWeightsMapHistogram = NULL;
+  for (Int_t axis = 0; axis < 3; axis++) fWeightsMapVarIds[axis] = nWeightsMapNoAxis;
 }
 
 /// Normal constructor
@@ -58,9 +68,16 @@ QnCorrectionsDetectorConfigurationTracks::QnCorrectionsDetectorConfigurationTrac
       QnCorrectionsEventClassVariablesSet *eventClassesVariables,
       Int_t nNoOfHarmonics,
       Int_t *harmonicMap) :
-          QnCorrectionsDetectorConfigurationBase(name, eventClassesVariables, nNoOfHarmonics, harmonicMap) {
+          QnCorrectionsDetectorConfigurationBase(name, eventClassesVariables, nNoOfHarmonics, harmonicMap),
+          fRecordedVariablesIds(),
+          fRecordedVariables(),
+          fWeightsMapBinning(),
+          fWeightsMap() {
 
   fQAQnAverageHistogram = NULL;
+  fSharedDataBank = kFALSE;
+  fWeightsMapHistogram = NULL;
+  for (Int_t axis = 0; axis < 3; axis++) fWeightsMapVarIds[axis] = nWeightsMapNoAxis;
 }
 
 /// Default destructor
@@ -71,6 +88,105 @@ QnCorrectionsDetectorConfigurationTracks::~QnCorrectionsDetectorConfigurationTra
     delete fQAQnAverageHistogram;
 }
 
+/// Requests the recording of a variable for each stored data vector
+///
+/// The variables values are taken from the variables bank when the
+/// data vector is accepted and kept for the current event. Only the
+/// data vectors stored in the own data vectors bank are recorded.
+/// A variable already requested is not recorded twice.
+/// \param varId the variable id
+/// \return the variable position within the data vector recorded values
+Int_t QnCorrectionsDetectorConfigurationTracks::RecordDataVectorsVariable(Int_t varId) {
+  for (size_t ixVariable = 0; ixVariable < fRecordedVariablesIds.size(); ixVariable++) {
+    if (fRecordedVariablesIds[ixVariable] == varId) return Int_t(ixVariable);
+  }
+  fRecordedVariablesIds.push_back(varId);
+  return Int_t(fRecordedVariablesIds.size() - 1);
+}
+
+/// Sets the tracks weights map
+///
+/// Each axis of the passed histogram, one to three dimensional, is
+/// associated, in order, to the passed variable ids. The id
+/// nWeightsMapPhiAxis associates the axis to the data vector azimuthal
+/// angle. The weight of each accepted data vector is then multiplied by
+/// the histogram content at the bin the track falls in, under and
+/// overflow bins included. The histogram is not owned and its content
+/// is taken at framework initialization. Raise an execution error if
+/// an axis of the histogram is left without variable. For configurations
+/// sharing the data vectors bank of other configuration the bank owner
+/// applies it when storing the data vectors.
+/// \param weights the histogram with the tracks weights
+/// \param xVarId the variable id for the first axis
+/// \param yVarId the variable id for the second axis
+/// \param zVarId the variable id for the third axis
+void QnCorrectionsDetectorConfigurationTracks::SetTracksWeightsMap(TH1 *weights, Int_t xVarId, Int_t yVarId, Int_t zVarId) {
+  Int_t varIds[3] = {xVarId, yVarId, zVarId};
+  for (Int_t axis = 0; axis < weights->GetDimension(); axis++) {
+    if (varIds[axis] == nWeightsMapNoAxis) {
+      QnCorrectionsFatal(Form("The axis %d of the tracks weights map %s for the detector configuration %s has no variable. FIX IT, PLEASE.",
+          axis, weights->GetName(), GetName()));
+      return;
+    }
+  }
+  fWeightsMapHistogram = weights;
+  for (Int_t axis = 0; axis < 3; axis++) {
+    fWeightsMapVarIds[axis] = (axis < weights->GetDimension()) ? varIds[axis] : nWeightsMapNoAxis;
+  }
+}
+
+/// Flattens the tracks weights map into a dense array
+///
+/// The bin locator reproduces the histogram axes so that, for any
+/// track, the located dense entry holds the histogram content of the
+/// bin the histogram itself would locate.
+void QnCorrectionsDetectorConfigurationTracks::BuildTracksWeightsMap() {
+  fWeightsMapBinning.Clear();
+  fWeightsMap.clear();
+  if (fWeightsMapHistogram == NULL) return;
+
+  Int_t nDimensions = fWeightsMapHistogram->GetDimension();
+  TAxis *axes[3] = {fWeightsMapHistogram->GetXaxis(), fWeightsMapHistogram->GetYaxis(), fWeightsMapHistogram->GetZaxis()};
+  for (Int_t axis = 0; axis < nDimensions; axis++) {
+    /* the azimuthal angle axes take the extra value */
+    Int_t varId = (fWeightsMapVarIds[axis] == nWeightsMapPhiAxis) ? -1 : fWeightsMapVarIds[axis];
+    if (axes[axis]->GetXbins()->GetSize() != 0)
+      fWeightsMapBinning.AddAxis(varId, axes[axis]->GetNbins(), axes[axis]->GetXbins()->GetArray());
+    else
+      fWeightsMapBinning.AddAxis(varId, axes[axis]->GetNbins(), axes[axis]->GetXmin(), axes[axis]->GetXmax());
+  }
+
+  fWeightsMap.resize(fWeightsMapBinning.GetNLinearBins());
+  Int_t coordinates[3] = {0, 0, 0};
+  for (Long64_t bin = 0; bin < fWeightsMapBinning.GetNLinearBins(); bin++) {
+    fWeightsMapBinning.GetCoordinates(bin, coordinates);
+    fWeightsMap[bin] = fWeightsMapHistogram->GetBinContent(fWeightsMapHistogram->GetBin(coordinates[0], coordinates[1], coordinates[2]));
+  }
+}
+
+/// Preallocates the data vector bank for the passed number of data vectors
+///
+/// The storage of the variables recorded with each data vector is
+/// reserved as well, so it should be invoked once the recorded
+/// variables are known.
+/// \param nNoOfDataVectors the capacity of the data vector bank
+void QnCorrectionsDetectorConfigurationTracks::PreallocateDataVectorBank(Int_t nNoOfDataVectors) {
+  QnCorrectionsDetectorConfigurationBase::PreallocateDataVectorBank(nNoOfDataVectors);
+  fRecordedVariables.reserve(size_t(nNoOfDataVectors) * fRecordedVariablesIds.size());
+}
+
+/// Registers the variables Ids the detector configuration reads from
+/// the variables bank for their remapping into a dense variables bank
+///
+/// The tracks weights map variables are included.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetectorConfigurationTracks::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  QnCorrectionsDetectorConfigurationBase::RegisterDataVariables(bank);
+  for (Int_t axis = 0; axis < 3; axis++) {
+    if (!(fWeightsMapVarIds[axis] < 0)) bank.Register(fWeightsMapVarIds[axis]);
+  }
+}
+
 /// Stores the framework manager pointer
 /// Orders the base class to store the correction manager and informs
 /// the Qn vector corrections they are now attached to the framework
@@ -87,12 +203,19 @@ void QnCorrectionsDetectorConfigurationTracks::AttachCorrectionsManager(QnCorrec
 
 /// Asks for support data structures creation
 ///
-/// The input data vector bank is allocated and the request is
-/// transmitted to the Q vector corrections.
+/// The input data vector bank is allocated, if not shared with other
+/// configurations, and the request is transmitted to the Q vector corrections.
 void QnCorrectionsDetectorConfigurationTracks::CreateSupportDataStructures() {
 
   /* this is executed in the remote node so, allocate the data bank */
-  fDataVectorBank = new TClonesArray("QnCorrectionsDataVector", INITIALDATAVECTORBANKSIZE);
+  if (!fSharedDataBank)
+    fDataVectorBank = new TClonesArray("QnCorrectionsDataVector", INITIALDATAVECTORBANKSIZE);
+
+  /* the hot data goes first so that the correction steps Qn vectors follow it */
+  LayOutHotData();
+
+  /* and flatten the tracks weights map, the variables are already in their final place */
+  BuildTracksWeightsMap();
 
   for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
     fQnVectorCorrections.At(ixCorrection)->CreateSupportDataStructures();
@@ -144,6 +267,7 @@ Bool_t QnCorrectionsDetectorConfigurationTracks::CreateQAHistograms(TList *list)
       Form("%s %s", szQAQnAverageHistogramName, this->GetName()),
       Form("%s %s", szQAQnAverageHistogramName, this->GetName()),
       this->GetEventClassVariablesSet());
+  fQAQnAverageHistogram->SetHistogramsContext(GetHistogramsContext());
 
   /* get information about the configured harmonics to pass it for histogram creation */
   Int_t nNoOfHarmonics = this->GetNoOfHarmonics();
@@ -245,7 +369,8 @@ void QnCorrectionsDetectorConfigurationTracks::FillQAHistograms(const Float_t *v
 ///
 /// Always includes first the fully corrected Qn vector,
 /// and then includes the plain Qn vector and asks to the different correction
-/// steps to include their partially corrected Qn vectors.
+/// steps to include their partially corrected Qn vectors, if the framework
+/// manager is providing intermediate Qn vectors.
 /// The check if we are already there is because it could be late information
 /// about the process name and then the correction histograms could still not
 /// be attached and the constructed list does not contain the final Qn vectors.
@@ -269,9 +394,7 @@ void QnCorrectionsDetectorConfigurationTracks::IncludeQnVectors(TList *list) {
 
   detectorConfigurationList->Add(&fCorrectedQnVector);
   detectorConfigurationList->Add(&fPlainQnVector);
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    fQnVectorCorrections.At(ixCorrection)->IncludeCorrectedQnVector(detectorConfigurationList);
-  }
+  IncludeCorrectionStepsQnVectors(detectorConfigurationList);
   if (!bAlreadyThere)
     list->Add(detectorConfigurationList);
 }
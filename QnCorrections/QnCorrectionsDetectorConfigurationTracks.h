@@ -15,9 +15,12 @@
 /// \brief Track detector configuration class for Q vector correction framework
 ///
 
+#include <vector>
 #include "QnCorrectionsDataVector.h"
 #include "QnCorrectionsDetectorConfigurationBase.h"
+#include "QnCorrectionsCoreEventClassBinning.h"
 
+class TH1;
 class QnCorrectionsProfileComponents;
 
 /// \class QnCorrectionsDetectorConfigurationTracks
@@ -28,6 +31,13 @@ class QnCorrectionsProfileComponents;
 /// potential weight. Apart from that no other input data calibration is
 /// available.
 ///
+/// A tracks weights map, as the ones for non uniform azimuthal acceptance
+/// or for efficiency corrections, can be attached to the configuration.
+/// Its axes are associated to track variables or to the data vector
+/// azimuthal angle. At initialization it is flattened into a dense
+/// array addressed by a bin locator with precomputed strides, and the
+/// weight of each accepted data vector is multiplied by its map value.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
@@ -38,6 +48,7 @@ class QnCorrectionsDetectorConfigurationTracks :
 public:
   friend class QnCorrectionsCorrectionStepBase;
   friend class QnCorrectionsDetector;
+  friend class QnCorrectionsDetectorConfigurationTracksVariations;
   QnCorrectionsDetectorConfigurationTracks();
   QnCorrectionsDetectorConfigurationTracks(const char *name,
       QnCorrectionsEventClassVariablesSet *eventClassesVariables,
@@ -62,6 +73,7 @@ public:
   virtual Bool_t ProcessCorrections(const Float_t *variableContainer);
   virtual Bool_t ProcessDataCollection(const Float_t *variableContainer);
   virtual Bool_t AddDataVector(const Float_t *variableContainer, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1);
+  Bool_t StoreDataVector(Double_t phi, Double_t weight = 1.0, Int_t id = -1);
 
   virtual void BuildQnVector();
   virtual void IncludeQnVectors(TList *list);
@@ -74,27 +86,70 @@ public:
   /// \param variableContainer pointer to the variable content bank
   /// \return kTRUE if the current content applies to the configuration
   virtual Bool_t IsSelected(const Float_t *variableContainer)
-    { return ((fCuts != NULL) ? fCuts->IsSelected(variableContainer) : kTRUE); }
+    { return PassesCuts(variableContainer); }
   /// wrong call for this class invoke base class behavior
   virtual Bool_t IsSelected(const Float_t *variableContainer, Int_t nChannel)
   { return QnCorrectionsDetectorConfigurationBase::IsSelected(variableContainer,nChannel); }
 
   virtual void ClearConfiguration();
+  virtual void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+  virtual void PreallocateDataVectorBank(Int_t nNoOfDataVectors);
+
+  void SetTracksWeightsMap(TH1 *weights, Int_t xVarId, Int_t yVarId = nWeightsMapNoAxis, Int_t zVarId = nWeightsMapNoAxis);
+  Double_t GetTracksWeight(const Float_t *variableContainer, Double_t phi) const;
+  /// Checks if a tracks weights map is in use
+  /// \return kTRUE once a tracks weights map has been flattened
+  Bool_t HasTracksWeightsMap() const { return !fWeightsMap.empty(); }
+
+  /// Sets whether the data vectors are kept in a bank shared with other configurations
+  ///
+  /// In that case the owner of the shared bank accumulates the configuration
+  /// Qn vectors and the configuration only finishes their build.
+  /// \param shared kTRUE if the data vectors bank is shared
+  void SetSharedDataBank(Bool_t shared = kTRUE) { fSharedDataBank = shared; }
+  /// Gets whether the data vectors are kept in a bank shared with other configurations
+  /// \return kTRUE if the data vectors bank is shared
+  Bool_t GetSharedDataBank() const { return fSharedDataBank; }
+
+  Int_t RecordDataVectorsVariable(Int_t varId);
+  void RecordDataVectorVariables(const Float_t *variableContainer);
+  /// Gets the number of variables recorded for each data vector
+  /// \return the number of recorded variables
+  Int_t GetNoOfRecordedVariables() const { return Int_t(fRecordedVariablesIds.size()); }
+  /// Gets the values of the recorded variables for the passed data vector
+  /// \param ixDataVector the position of the data vector in the data vectors bank
+  /// \return the recorded values in recording order
+  const Float_t *GetRecordedVariables(Int_t ixDataVector) const
+  { return &fRecordedVariables[ixDataVector * fRecordedVariablesIds.size()]; }
+
+  static const Int_t nWeightsMapPhiAxis;  ///< the variable id that associates a weights map axis to the azimuthal angle
+  static const Int_t nWeightsMapNoAxis;   ///< the variable id for the weights map axes not in use
 
 private:
+  void BuildTracksWeightsMap();
+
+  Bool_t fSharedDataBank;        ///< the data vectors are kept in a bank shared with other configurations
+  TH1 *fWeightsMapHistogram;     //!<! the tracks weights map as provided, not owned
+  /// array, the variable ids associated to the weights map axes
+  Int_t fWeightsMapVarIds[3];    //!<!
+  QnCorrectionsCoreEventClassBinning fWeightsMapBinning; //!<! the weights map bin locator
+  std::vector<Float_t> fWeightsMap; //!<! the flattened tracks weights map
+  std::vector<Int_t> fRecordedVariablesIds; //!<! the ids of the variables recorded for each data vector
+  std::vector<Float_t> fRecordedVariables;  //!<! the recorded variables values of the current event data vectors
   /* QA section */
   void FillQAHistograms(const Float_t *variableContainer);
   static const char *szQAQnAverageHistogramName; ///< name and title for plain Qn vector components average QA histograms
   QnCorrectionsProfileComponents *fQAQnAverageHistogram; //!<! the plain average Qn components QA histogram
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsDetectorConfigurationTracks, 2);
+  ClassDef(QnCorrectionsDetectorConfigurationTracks, 5);
 /// \endcond
 };
 
 /// New data vector for the detector configuration.
 /// A check is made to see if the current variable bank content passes
-/// the associated cuts. If so, the data vector is stored.
+/// the associated cuts. If so, the data vector is stored with its
+/// weight multiplied by the tracks weights map value, if any.
 /// \param variableContainer pointer to the variable content bank
 /// \param phi azimuthal angle
 /// \param weight the weight associated to the data vector. For track detector is usually one.
@@ -103,14 +158,54 @@ private:
 inline Bool_t QnCorrectionsDetectorConfigurationTracks::AddDataVector(
     const Float_t *variableContainer, Double_t phi, Double_t weight, Int_t id) {
   if (IsSelected(variableContainer)) {
-    /// add the data vector to the bank
-    new (fDataVectorBank->ConstructedAt(fDataVectorBank->GetEntriesFast()))
-        QnCorrectionsDataVector(id, phi, weight);
-    return kTRUE;
+    if (StoreDataVector(phi, weight * GetTracksWeight(variableContainer, phi), id)) {
+      RecordDataVectorVariables(variableContainer);
+      return kTRUE;
+    }
   }
   return kFALSE;
 }
 
+/// Stores a new data vector already accepted for the detector configuration
+///
+/// No cuts check is made. Used by the families of track detector
+/// configurations which have already routed the data vector.
+/// \param phi azimuthal angle
+/// \param weight the weight associated to the data vector
+/// \param id the Id associated to the data vector
+/// \return kTRUE if the data vector was stored, kFALSE if the preallocated bank is full
+inline Bool_t QnCorrectionsDetectorConfigurationTracks::StoreDataVector(Double_t phi, Double_t weight, Int_t id) {
+  if (!(fDataVectorBank->GetEntriesFast() < fDataVectorBankCapacity)) {
+    fNoOfDroppedDataVectors++;
+    return kFALSE;
+  }
+  /// add the data vector to the bank
+  new (fDataVectorBank->ConstructedAt(fDataVectorBank->GetEntriesFast()))
+      QnCorrectionsDataVector(id, phi, weight);
+  return kTRUE;
+}
+
+/// Gets the tracks weights map value for the current track
+///
+/// The axes associated to the azimuthal angle take the passed one.
+/// \param variableContainer pointer to the variable content bank
+/// \param phi the track azimuthal angle
+/// \return the weights map value, one if there is no weights map
+inline Double_t QnCorrectionsDetectorConfigurationTracks::GetTracksWeight(const Float_t *variableContainer, Double_t phi) const {
+  if (fWeightsMap.empty()) return 1.0;
+  return fWeightsMap[fWeightsMapBinning.GetBin(variableContainer, phi)];
+}
+
+/// Records the requested variables values for the data vector just stored
+///
+/// Nothing is done if no variable recording was requested.
+/// \param variableContainer pointer to the variable content bank
+inline void QnCorrectionsDetectorConfigurationTracks::RecordDataVectorVariables(const Float_t *variableContainer) {
+  for (size_t ixVariable = 0; ixVariable < fRecordedVariablesIds.size(); ixVariable++) {
+    fRecordedVariables.push_back(variableContainer[fRecordedVariablesIds[ixVariable]]);
+  }
+}
+
 /// Clean the configuration to accept a new event
 ///
 /// Transfers the order to the Q vector correction steps and
@@ -118,16 +213,18 @@ inline Bool_t QnCorrectionsDetectorConfigurationTracks::AddDataVector(
 /// for accepting the next event.
 inline void QnCorrectionsDetectorConfigurationTracks::ClearConfiguration() {
   /* transfer the order to the Q vector corrections */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    fQnVectorCorrections.At(ixCorrection)->ClearCorrectionStep();
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ClearCorrectionStep();
   }
   /* clean the own Q vectors */
   fPlainQnVector.Reset();
   fPlainQ2nVector.Reset();
   fCorrectedQnVector.Reset();
   fCorrectedQ2nVector.Reset();
-  /* and now clear the the input data bank */
-  fDataVectorBank->Clear("C");
+  /* and now clear the the input data bank if we own it */
+  if (fDataVectorBank != NULL)
+    fDataVectorBank->Clear("C");
+  fRecordedVariables.clear();
 }
 
 /// Builds Qn vectors before Q vector corrections but
@@ -135,14 +232,29 @@ inline void QnCorrectionsDetectorConfigurationTracks::ClearConfiguration() {
 /// Remember, this configuration does not have a channelized
 /// approach so, the built Q vectors are the ones to be used for
 /// subsequent corrections.
+///
+/// If the data vectors bank is shared the Q vectors contributions
+/// were already accumulated by the bank owner and only the
+/// quality check and normalization are left. Otherwise the harmonic
+/// terms of the data vectors are taken from the detector harmonic
+/// basis when they were evaluated there.
 inline void QnCorrectionsDetectorConfigurationTracks::BuildQnVector() {
-  fTempQnVector.Reset();
-  fTempQ2nVector.Reset();
+  if (!fSharedDataBank) {
+    fTempQnVector.Reset();
+    fTempQ2nVector.Reset();
 
-  for(Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++){
-    QnCorrectionsDataVector *dataVector = static_cast<QnCorrectionsDataVector *>(fDataVectorBank->At(ixData));
-    fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
-    fTempQ2nVector.Add(dataVector->Phi(), dataVector->Weight());
+    for(Int_t ixData = 0; ixData < fDataVectorBank->GetEntriesFast(); ixData++){
+      QnCorrectionsDataVector *dataVector = static_cast<QnCorrectionsDataVector *>(fDataVectorBank->At(ixData));
+      Int_t row = dataVector->GetBasisRow();
+      if (row < 0) {
+        fTempQnVector.Add(dataVector->Phi(), dataVector->Weight());
+        fTempQ2nVector.Add(dataVector->Phi(), dataVector->Weight());
+      }
+      else {
+        fTempQnVector.AddFromBasis(fHarmonicBasis->GetCos(row), fHarmonicBasis->GetSin(row), dataVector->Weight());
+        fTempQ2nVector.AddFromBasis(fHarmonicBasis->GetCos(row), fHarmonicBasis->GetSin(row), dataVector->Weight());
+      }
+    }
   }
   /* check the quality of the Qn vector */
   fTempQnVector.CheckQuality();
@@ -167,8 +279,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationTracks::ProcessCorrections(const
 
   /* then we transfer the request to the Q vector correction steps */
   /* the loop is broken when a correction step has not been applied */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    if (fQnVectorCorrections.At(ixCorrection)->ProcessCorrections(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ProcessCorrections(variableContainer))
       continue;
     else
       return kFALSE;
@@ -189,8 +301,8 @@ inline Bool_t QnCorrectionsDetectorConfigurationTracks::ProcessDataCollection(co
 
   /* we transfer the request to the Q vector correction steps */
   /* the loop is broken when a correction step has not been applied */
-  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetEntries(); ixCorrection++) {
-    if (fQnVectorCorrections.At(ixCorrection)->ProcessDataCollection(variableContainer))
+  for (Int_t ixCorrection = 0; ixCorrection < fQnVectorCorrections.GetNoOfDispatchedSteps(); ixCorrection++) {
+    if (fQnVectorCorrections.GetDispatchedStep(ixCorrection)->ProcessDataCollection(variableContainer))
       continue;
     else
       return kFALSE;
@@ -0,0 +1,122 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsDetectorConfigurationTracksFamily.cxx
+/// \brief Implementation of the family of track detector configurations binned in a track variable
+
+#include "QnCorrectionsDetectorConfigurationTracksFamily.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsDetectorConfigurationTracksFamily);
+/// \endcond
+
+/// Default constructor
+QnCorrectionsDetectorConfigurationTracksFamily::QnCorrectionsDetectorConfigurationTracksFamily() : TNamed(),
+    fSliceVariable(),
+    fSlices(),
+    fSliceBinning() {
+
+  fSlices.SetOwner(kTRUE);
+  fCuts = NULL;
+}
+
+/// Normal constructor
+///
+/// Builds one track detector configuration per bin of the slices variable.
+/// The slices are named after the family name and the slice number.
+/// \param name the name of the family
+/// \param eventClassesVariables the set of event classes variables shared by all slices
+/// \param sliceVariable the binned track variable which defines the slices
+/// \param nNoOfHarmonics the number of harmonics that must be handled
+/// \param harmonicMap an optional ordered array with the harmonic numbers
+QnCorrectionsDetectorConfigurationTracksFamily::QnCorrectionsDetectorConfigurationTracksFamily(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      const QnCorrectionsEventClassVariable &sliceVariable,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap) :
+          TNamed(name,name),
+          fSliceVariable(sliceVariable),
+          fSlices(),
+          fSliceBinning() {
+
+  /* the family owns its slices */
+  fSlices.SetOwner(kTRUE);
+  fCuts = NULL;
+
+  for (Int_t slice = 0; slice < fSliceVariable.GetNBins(); slice++) {
+    QnCorrectionsDetectorConfigurationTracks *sliceConfiguration =
+        new QnCorrectionsDetectorConfigurationTracks(Form("%s_%d", name, slice), eventClassesVariables, nNoOfHarmonics, harmonicMap);
+    sliceConfiguration->SetTitle(Form("%s %s [%g, %g)", name, fSliceVariable.GetVariableLabel(),
+        fSliceVariable.GetBins()[slice], fSliceVariable.GetBins()[slice + 1]));
+    fSlices.Add(sliceConfiguration);
+  }
+}
+
+/// Default destructor
+///
+/// The family owns its slices and the set of cuts.
+QnCorrectionsDetectorConfigurationTracksFamily::~QnCorrectionsDetectorConfigurationTracksFamily() {
+  if (fCuts != NULL) {
+    delete fCuts;
+  }
+}
+
+/// Sets the normalization method for the Q vectors of the whole family
+/// \param method the Qn vector normalization method
+void QnCorrectionsDetectorConfigurationTracksFamily::SetQVectorNormalizationMethod(QnCorrectionsQnVector::QnVectorNormalizationMethod method) {
+  for (Int_t slice = 0; slice < GetNoOfSlices(); slice++) {
+    GetSlice(slice)->SetQVectorNormalizationMethod(method);
+  }
+}
+
+/// Asks for support data structures creation
+///
+/// The slices bin locator is built from the slices variable, already
+/// with its final variable Id. Being transient, it has to be built on
+/// each framework initialization, streamed families included. The
+/// slices create their own support data structures as any other
+/// detector configuration.
+void QnCorrectionsDetectorConfigurationTracksFamily::CreateSupportDataStructures() {
+  fSliceBinning.Clear();
+  fSliceBinning.AddAxis(fSliceVariable.GetVariableId(), fSliceVariable.GetNBins(), fSliceVariable.GetBins());
+}
+
+/// Registers the variables Ids the family reads from the variables
+/// bank for their remapping into a dense variables bank
+///
+/// The shared cuts and the slices variable are registered. The slices
+/// register their own ones.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetectorConfigurationTracksFamily::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  if (fCuts != NULL) fCuts->RegisterDataVariables(bank);
+  fSliceVariable.RegisterDataVariables(bank);
+}
@@ -0,0 +1,126 @@
+#ifndef QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSFAMILY_H
+#define QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSFAMILY_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsDetectorConfigurationTracksFamily.h
+/// \brief Family of track detector configurations binned in a track variable
+///
+
+#include <TNamed.h>
+#include <TObjArray.h>
+
+#include "QnCorrectionsCoreEventClassBinning.h"
+#include "QnCorrectionsEventClassVariable.h"
+#include "QnCorrectionsDetectorConfigurationTracks.h"
+
+/// \class QnCorrectionsDetectorConfigurationTracksFamily
+/// \brief Set of track detector configurations, one per bin of a track variable
+///
+/// Differential Qn vectors, i.e. Qn vectors in slices of a track variable
+/// as pseudorapidity, would require one track detector configuration per slice
+/// each of them evaluating its own set of cuts on every track.
+///
+/// The family builds the whole set of slice track detector configurations
+/// from one binned track variable. The family cuts are evaluated once per
+/// data vector and the data vector is routed to its slice with a single
+/// bin lookup on the binned track variable. The slices Qn vectors are then
+/// built from the slices data banks so the overall cost is nearly independent
+/// of the number of slices.
+///
+/// All slices share the event class variables set so their correction
+/// and QA histograms share the same layout. Each slice is a regular track
+/// detector configuration, named after the family name and the slice number,
+/// so the correction steps have to be added to each of the slices.
+///
+/// The family is incorporated to a detector with
+/// QnCorrectionsDetector::AddDetectorConfigurationFamily. The detector
+/// takes its ownership and the family owns its slices.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+
+class QnCorrectionsDetectorConfigurationTracksFamily : public TNamed {
+public:
+  QnCorrectionsDetectorConfigurationTracksFamily();
+  QnCorrectionsDetectorConfigurationTracksFamily(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      const QnCorrectionsEventClassVariable &sliceVariable,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap = NULL);
+  virtual ~QnCorrectionsDetectorConfigurationTracksFamily();
+
+  /// Sets the set of cuts shared by the whole family
+  /// \param cuts the set of cuts
+  void SetCuts(QnCorrectionsCutsSet *cuts)
+  { fCuts = cuts; }
+  void SetQVectorNormalizationMethod(QnCorrectionsQnVector::QnVectorNormalizationMethod method);
+
+  /// Gets the number of slices in the family
+  /// \return the number of slices
+  Int_t GetNoOfSlices() const { return fSlices.GetEntriesFast(); }
+  /// Gets the track detector configuration associated to the passed slice
+  /// \param slice the slice number (starting at zero)
+  /// \return the slice detector configuration
+  QnCorrectionsDetectorConfigurationTracks *GetSlice(Int_t slice) const
+  { return static_cast<QnCorrectionsDetectorConfigurationTracks *>(fSlices.At(slice)); }
+  /// Gets the binned track variable which defines the slices
+  /// \return the slices variable
+  const QnCorrectionsEventClassVariable &GetSliceVariable() const { return fSliceVariable; }
+
+  void CreateSupportDataStructures();
+  QnCorrectionsDetectorConfigurationTracks *AddDataVector(const Float_t *variableContainer, Double_t phi, Double_t weight = 1.0, Int_t id = -1);
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+
+private:
+  QnCorrectionsEventClassVariable fSliceVariable;   ///< the binned track variable which defines the slices
+  TObjArray fSlices;                                ///< the slices track detector configurations, owned by the family
+  QnCorrectionsCutsSet *fCuts;                      ///< the set of cuts shared by the whole family
+  QnCorrectionsCoreEventClassBinning fSliceBinning; //!<! the slices bin locator
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsDetectorConfigurationTracksFamily(const QnCorrectionsDetectorConfigurationTracksFamily &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsDetectorConfigurationTracksFamily& operator= (const QnCorrectionsDetectorConfigurationTracksFamily &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsDetectorConfigurationTracksFamily, 1);
+/// \endcond
+};
+
+/// New data vector for the family
+///
+/// The family cuts are checked once and, if passed, the data
+/// vector is stored in the slice it belongs to, weighted by the slice
+/// tracks weights map, if any.
+/// \param variableContainer pointer to the variable content bank
+/// \param phi azimuthal angle
+/// \param weight the weight associated to the data vector
+/// \param id the Id associated to the data vector
+/// \return the slice detector configuration that stored the data vector, NULL if none or its bank is full
+inline QnCorrectionsDetectorConfigurationTracks *QnCorrectionsDetectorConfigurationTracksFamily::AddDataVector(
+    const Float_t *variableContainer, Double_t phi, Double_t weight, Int_t id) {
+  if ((fCuts != NULL) && !fCuts->IsSelected(variableContainer)) return NULL;
+
+  Int_t bin = fSliceBinning.FindAxisBin(0, variableContainer[fSliceVariable.GetVariableId()]);
+  /* under and overflow values do not belong to any slice */
+  if ((bin < 1) || (fSliceVariable.GetNBins() < bin)) return NULL;
+
+  QnCorrectionsDetectorConfigurationTracks *slice = GetSlice(bin - 1);
+  if (!slice->StoreDataVector(phi, weight * slice->GetTracksWeight(variableContainer, phi), id)) return NULL;
+  slice->RecordDataVectorVariables(variableContainer);
+  return slice;
+}
+
+#endif // QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSFAMILY_H
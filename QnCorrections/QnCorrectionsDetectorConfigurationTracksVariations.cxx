@@ -0,0 +1,249 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsDetectorConfigurationTracksVariations.cxx
+/// \brief Implementation of the set of track detector configurations for systematic cuts variations
+
+#include "QnCorrectionsDetectorConfigurationTracksVariations.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsDetectorConfigurationTracksVariations);
+/// \endcond
+
+const Int_t QnCorrectionsDetectorConfigurationTracksVariations::nMaxNoOfVariations = 64;
+
+/// Default constructor
+QnCorrectionsDetectorConfigurationTracksVariations::QnCorrectionsDetectorConfigurationTracksVariations() : TNamed(),
+    fVariations(),
+    fPhi(),
+    fWeight(),
+    fId(),
+    fVariationWeight(),
+    fAcceptanceMask(),
+    fBasisRow(),
+    fWeightedCos(),
+    fWeightedSin(),
+    fCos(),
+    fSin() {
+
+  fVariations.SetOwner(kTRUE);
+  fEventClassVariables = NULL;
+  fNoOfHarmonics = 0;
+  fHarmonicMap = NULL;
+  fHighestTerm = 0;
+  fQnNormalizationMethod = QnCorrectionsQnVector::QVNORM_noCalibration;
+  fCuts = NULL;
+  fBankCapacity = kMaxInt;
+  fNoOfDroppedDataVectors = 0;
+  fHarmonicBasis = NULL;
+}
+
+/// Normal constructor
+///
+/// The variations are incorporated afterwards with AddVariation.
+/// \param name the name of the set of variations
+/// \param eventClassesVariables the set of event classes variables shared by all variations
+/// \param nNoOfHarmonics the number of harmonics that must be handled
+/// \param harmonicMap an optional ordered array with the harmonic numbers
+QnCorrectionsDetectorConfigurationTracksVariations::QnCorrectionsDetectorConfigurationTracksVariations(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap) :
+          TNamed(name,name),
+          fVariations(),
+          fPhi(),
+          fWeight(),
+          fId(),
+          fVariationWeight(),
+          fAcceptanceMask(),
+          fBasisRow(),
+          fWeightedCos(),
+          fWeightedSin(),
+          fCos(),
+          fSin() {
+
+  /* the set owns its variations */
+  fVariations.SetOwner(kTRUE);
+  fEventClassVariables = eventClassesVariables;
+  fQnNormalizationMethod = QnCorrectionsQnVector::QVNORM_noCalibration;
+  fCuts = NULL;
+  fBankCapacity = kMaxInt;
+  fNoOfDroppedDataVectors = 0;
+  fHarmonicBasis = NULL;
+
+  fNoOfHarmonics = nNoOfHarmonics;
+  fHarmonicMap = new Int_t[fNoOfHarmonics];
+  fHighestTerm = 0;
+  for (Int_t h = 0; h < fNoOfHarmonics; h++) {
+    fHarmonicMap[h] = (harmonicMap != NULL) ? harmonicMap[h] : h + 1;
+    /* the Q2n vectors need up to twice the highest harmonic */
+    if (fHighestTerm < 2 * fHarmonicMap[h]) fHighestTerm = 2 * fHarmonicMap[h];
+  }
+  fWeightedCos.resize(fHighestTerm + 1, 0.0);
+  fWeightedSin.resize(fHighestTerm + 1, 0.0);
+  fCos.resize(fHighestTerm + 1, 0.0);
+  fSin.resize(fHighestTerm + 1, 0.0);
+}
+
+/// Default destructor
+///
+/// The set owns its variations, which own their sets of cuts, and the base cuts.
+QnCorrectionsDetectorConfigurationTracksVariations::~QnCorrectionsDetectorConfigurationTracksVariations() {
+  if (fCuts != NULL) {
+    delete fCuts;
+  }
+  if (fHarmonicMap != NULL) {
+    delete [] fHarmonicMap;
+  }
+}
+
+/// Sets the normalization method for the Q vectors of all variations
+///
+/// Variations added afterwards will also get it.
+/// \param method the Qn vector normalization method
+void QnCorrectionsDetectorConfigurationTracksVariations::SetQVectorNormalizationMethod(QnCorrectionsQnVector::QnVectorNormalizationMethod method) {
+  fQnNormalizationMethod = method;
+  for (Int_t variation = 0; variation < GetNoOfVariations(); variation++) {
+    GetVariation(variation)->SetQVectorNormalizationMethod(method);
+  }
+}
+
+/// Adds a new variation to the set
+///
+/// A new track detector configuration, named after the set name and
+/// the variation name, is created for the variation. Its data vectors
+/// bank is the one shared by the whole set.
+/// Raise an execution error if the maximum number of variations is exceeded.
+/// \param variationName the name of the variation
+/// \param cuts the variation set of cuts. Ownership is transferred to the variation configuration
+/// \return the new variation detector configuration, NULL if it was not possible to create it
+QnCorrectionsDetectorConfigurationTracks *QnCorrectionsDetectorConfigurationTracksVariations::AddVariation(const char *variationName, QnCorrectionsCutsSet *cuts) {
+  if (!(GetNoOfVariations() < nMaxNoOfVariations)) {
+    QnCorrectionsFatal(Form("You are trying to add more than %d variations to %s. FIX IT, PLEASE.",
+        nMaxNoOfVariations,
+        GetName()));
+    return NULL;
+  }
+  QnCorrectionsDetectorConfigurationTracks *variation =
+      new QnCorrectionsDetectorConfigurationTracks(Form("%s_%s", GetName(), variationName), fEventClassVariables, fNoOfHarmonics, fHarmonicMap);
+  variation->SetSharedDataBank(kTRUE);
+  variation->SetCuts(cuts);
+  variation->SetQVectorNormalizationMethod(fQnNormalizationMethod);
+  fVariations.Add(variation);
+  return variation;
+}
+
+/// Builds the Qn vectors of all variations in a single pass over the shared bank
+///
+/// For each data vector its harmonic terms are evaluated once, or taken
+/// from the detector harmonic basis when the data vector terms were evaluated
+/// there, and accumulated in the Qn and Q2n vectors of each of the variations
+/// that accepted it. The variations without tracks weights map share the
+/// weighted terms while the ones with it take the data vector weight they
+/// stored for it. The variations will afterwards finish their Qn vectors
+/// build when asked to process their corrections.
+void QnCorrectionsDetectorConfigurationTracksVariations::BuildQnVectors() {
+  Int_t nVariations = GetNoOfVariations();
+
+  for (Int_t variation = 0; variation < nVariations; variation++) {
+    GetVariation(variation)->fTempQnVector.Reset();
+    GetVariation(variation)->fTempQ2nVector.Reset();
+  }
+
+  UInt_t ixVariationWeight = 0;
+  for (UInt_t ixData = 0; ixData < fPhi.size(); ixData++) {
+    Double_t phi = fPhi[ixData];
+    Double_t weight = fWeight[ixData];
+    Int_t row = fBasisRow[ixData];
+    const Double_t *cosTerms = &fCos[0];
+    const Double_t *sinTerms = &fSin[0];
+    if (row < 0) {
+      for (Int_t k = 1; k < fHighestTerm + 1; k++) {
+        fCos[k] = TMath::Cos(k*phi);
+        fSin[k] = TMath::Sin(k*phi);
+      }
+    }
+    else {
+      cosTerms = fHarmonicBasis->GetCos(row);
+      sinTerms = fHarmonicBasis->GetSin(row);
+    }
+    for (Int_t k = 1; k < fHighestTerm + 1; k++) {
+      fWeightedCos[k] = weight * cosTerms[k];
+      fWeightedSin[k] = weight * sinTerms[k];
+    }
+    ULong64_t mask = fAcceptanceMask[ixData];
+    for (Int_t variation = 0; variation < nVariations; variation++) {
+      if ((mask & (ULong64_t(1) << variation)) != 0) {
+        QnCorrectionsDetectorConfigurationTracks *configuration = GetVariation(variation);
+        if (configuration->HasTracksWeightsMap()) {
+          Double_t variationWeight = fVariationWeight[ixVariationWeight++];
+          configuration->fTempQnVector.AddFromBasis(cosTerms, sinTerms, variationWeight);
+          configuration->fTempQ2nVector.AddFromBasis(cosTerms, sinTerms, variationWeight);
+        }
+        else {
+          configuration->fTempQnVector.Add(&fWeightedCos[0], &fWeightedSin[0], weight);
+          configuration->fTempQ2nVector.Add(&fWeightedCos[0], &fWeightedSin[0], weight);
+        }
+      }
+    }
+  }
+}
+
+/// Registers the variables Ids the set reads from the variables
+/// bank for their remapping into a dense variables bank
+///
+/// The base cuts are registered. The variations register their own ones.
+/// \param bank the variables bank remapper
+void QnCorrectionsDetectorConfigurationTracksVariations::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  if (fCuts != NULL) fCuts->RegisterDataVariables(bank);
+}
+
+/// Preallocates the shared bank for the passed number of data vectors
+///
+/// The shared bank is bounded to them so that no allocation happens
+/// while storing the data vectors of an event, their weights for the
+/// variations with tracks weights map included. The data vectors which
+/// do not fit are dropped and accounted.
+/// \param nNoOfDataVectors the capacity of the shared bank
+void QnCorrectionsDetectorConfigurationTracksVariations::PreallocateSharedBank(Int_t nNoOfDataVectors) {
+  Int_t nNoOfWeightedVariations = 0;
+  for (Int_t variation = 0; variation < GetNoOfVariations(); variation++) {
+    if (GetVariation(variation)->HasTracksWeightsMap()) nNoOfWeightedVariations++;
+  }
+  fPhi.reserve(nNoOfDataVectors);
+  fWeight.reserve(nNoOfDataVectors);
+  fId.reserve(nNoOfDataVectors);
+  fVariationWeight.reserve(size_t(nNoOfDataVectors) * nNoOfWeightedVariations);
+  fAcceptanceMask.reserve(nNoOfDataVectors);
+  fBasisRow.reserve(nNoOfDataVectors);
+  fBankCapacity = nNoOfDataVectors;
+}
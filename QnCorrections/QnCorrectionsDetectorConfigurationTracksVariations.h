@@ -0,0 +1,207 @@
+#ifndef QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSVARIATIONS_H
+#define QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSVARIATIONS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsDetectorConfigurationTracksVariations.h
+/// \brief Set of track detector configurations for systematic cuts variations sharing a single input pass
+///
+
+#include <vector>
+#include <TNamed.h>
+#include <TObjArray.h>
+
+#include "QnCorrectionsDetectorConfigurationTracks.h"
+
+/// \class QnCorrectionsDetectorConfigurationTracksVariations
+/// \brief Track detector configurations for systematic variations of the cuts
+///
+/// Systematic studies require the same track detector configuration
+/// with several alternate sets of cuts. Declaring each of them as an
+/// independent configuration means storing each data vector once per
+/// variation and evaluating the Qn vectors harmonic terms once per variation.
+///
+/// Here a set of base cuts is evaluated once per data vector and, if
+/// passed, each variation set of cuts is evaluated into a bit of an
+/// acceptance mask. Accepted data vectors are stored once, together
+/// with their acceptance mask, in a bank shared by all variations.
+/// The Qn vectors of all variations are then built simultaneously in
+/// a single loop over the shared bank: the harmonic terms of each data
+/// vector are evaluated once and accumulated in the Qn and Q2n vectors of
+/// every variation that accepted it.
+///
+/// Variations with their own tracks weights map get, for each data vector
+/// they accept, its weight multiplied by their map value. Those weights are
+/// stored in the shared bank as well, so that variations with different
+/// weights maps produce the same Qn vectors as independent configurations.
+///
+/// Each variation is a regular track detector configuration, named
+/// after the set name and the variation name, so each variation has its
+/// own correction chain whose correction steps have to be added to it.
+/// Up to 64 variations are supported.
+///
+/// The variations should be added before incorporating the set to a
+/// detector with QnCorrectionsDetector::AddDetectorConfigurationVariations.
+/// The detector takes ownership of the set. The variations have no data
+/// vectors bank of their own so the consumers of a configuration bank,
+/// as the differential flow particles of interest, reject them. Their data
+/// vectors are reachable through the set shared bank accessors.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+
+class QnCorrectionsDetectorConfigurationTracksVariations : public TNamed {
+public:
+  QnCorrectionsDetectorConfigurationTracksVariations();
+  QnCorrectionsDetectorConfigurationTracksVariations(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap = NULL);
+  virtual ~QnCorrectionsDetectorConfigurationTracksVariations();
+
+  /// Sets the set of base cuts shared by all variations
+  /// \param cuts the set of cuts
+  void SetCuts(QnCorrectionsCutsSet *cuts)
+  { fCuts = cuts; }
+  void SetQVectorNormalizationMethod(QnCorrectionsQnVector::QnVectorNormalizationMethod method);
+
+  QnCorrectionsDetectorConfigurationTracks *AddVariation(const char *variationName, QnCorrectionsCutsSet *cuts);
+
+  /// Gets the number of variations in the set
+  /// \return the number of variations
+  Int_t GetNoOfVariations() const { return fVariations.GetEntriesFast(); }
+  /// Gets the track detector configuration associated to the passed variation
+  /// \param variation the variation number (starting at zero)
+  /// \return the variation detector configuration
+  QnCorrectionsDetectorConfigurationTracks *GetVariation(Int_t variation) const
+  { return static_cast<QnCorrectionsDetectorConfigurationTracks *>(fVariations.At(variation)); }
+
+  ULong64_t AddDataVector(const Float_t *variableContainer, Double_t phi, Double_t weight = 1.0, Int_t id = -1);
+  void BuildQnVectors();
+  void ClearVariations();
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+  void PreallocateSharedBank(Int_t nNoOfDataVectors);
+  /// Gets the number of data vectors in the shared bank
+  /// \return the number of data vectors
+  Int_t GetNoOfDataVectors() const { return Int_t(fPhi.size()); }
+  /// Gets the azimuthal angle of a shared bank data vector
+  /// \param ixData the position of the data vector in the shared bank
+  Double_t GetPhi(Int_t ixData) const { return fPhi[ixData]; }
+  /// Gets the weight, before any tracks weights map, of a shared bank data vector
+  /// \param ixData the position of the data vector in the shared bank
+  Double_t GetWeight(Int_t ixData) const { return fWeight[ixData]; }
+  /// Gets the id of a shared bank data vector
+  /// \param ixData the position of the data vector in the shared bank
+  Int_t GetId(Int_t ixData) const { return fId[ixData]; }
+  /// Gets the variations acceptance mask of a shared bank data vector
+  /// \param ixData the position of the data vector in the shared bank
+  ULong64_t GetAcceptanceMask(Int_t ixData) const { return fAcceptanceMask[ixData]; }
+  /// Gets the number of data vectors dropped for exceeding the preallocated shared bank
+  /// \return the number of dropped data vectors
+  Long64_t GetNoOfDroppedDataVectors() const { return fNoOfDroppedDataVectors; }
+  /// Sets the harmonic basis where the detector keeps the harmonic terms of the current data vectors
+  /// \param basis the detector harmonic basis
+  void SetHarmonicBasis(const QnCorrectionsCoreHarmonicBasis *basis) { fHarmonicBasis = basis; }
+  /// Tags the data vector just stored in the shared bank with its row in the detector harmonic basis
+  /// \param row the harmonic basis row of the data vector
+  void SetLastBasisRow(Int_t row) { fBasisRow.back() = row; }
+
+  static const Int_t nMaxNoOfVariations;            ///< the maximum number of supported variations
+
+private:
+  QnCorrectionsEventClassVariablesSet *fEventClassVariables; ///< the event class variables shared by all variations
+  Int_t fNoOfHarmonics;                             ///< the number of harmonics handled by the variations
+  /// array, the ordered harmonic numbers
+  Int_t *fHarmonicMap;                              //[fNoOfHarmonics]
+  Int_t fHighestTerm;                               ///< the highest harmonic term needed, the Q2n vectors included
+  QnCorrectionsQnVector::QnVectorNormalizationMethod fQnNormalizationMethod; ///< the Qn vectors normalization method of the variations
+  TObjArray fVariations;                            ///< the variations track detector configurations, owned by the set
+  QnCorrectionsCutsSet *fCuts;                      ///< the set of base cuts shared by all variations
+  std::vector<Double_t> fPhi;                       //!<! the shared bank azimuthal angles
+  std::vector<Double_t> fWeight;                    //!<! the shared bank weights
+  std::vector<Int_t> fId;                           //!<! the shared bank data vectors ids
+  std::vector<Double_t> fVariationWeight;           //!<! the shared bank weights of the variations with tracks weights map
+  std::vector<ULong64_t> fAcceptanceMask;           //!<! the shared bank variations acceptance masks
+  std::vector<Int_t> fBasisRow;                     //!<! the shared bank rows in the detector harmonic basis
+  const QnCorrectionsCoreHarmonicBasis *fHarmonicBasis; //!<! the detector harmonic basis of the current data vectors
+  std::vector<Double_t> fWeightedCos;               //!<! the weighted cosine terms of the current data vector
+  std::vector<Double_t> fWeightedSin;               //!<! the weighted sine terms of the current data vector
+  std::vector<Double_t> fCos;                       //!<! the cosine terms of the current data vector if not in the harmonic basis
+  std::vector<Double_t> fSin;                       //!<! the sine terms of the current data vector if not in the harmonic basis
+  Int_t fBankCapacity;                              //!<! the data vectors the shared bank holds, only bounded once preallocated
+  Long64_t fNoOfDroppedDataVectors;                 //!<! the data vectors dropped for exceeding the shared bank capacity
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsDetectorConfigurationTracksVariations(const QnCorrectionsDetectorConfigurationTracksVariations &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsDetectorConfigurationTracksVariations& operator= (const QnCorrectionsDetectorConfigurationTracksVariations &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsDetectorConfigurationTracksVariations, 1);
+/// \endcond
+};
+
+/// New data vector for the set of variations
+///
+/// The base cuts are checked once and, if passed, each variation
+/// cuts are checked into the data vector acceptance mask. If any
+/// variation accepts the data vector it is stored once in the shared bank,
+/// together with its weight for each of the accepting variations with
+/// tracks weights map.
+/// \param variableContainer pointer to the variable content bank
+/// \param phi azimuthal angle
+/// \param weight the weight associated to the data vector
+/// \param id the Id associated to the data vector
+/// \return the acceptance mask, bit i set if variation i accepted the data vector
+inline ULong64_t QnCorrectionsDetectorConfigurationTracksVariations::AddDataVector(
+    const Float_t *variableContainer, Double_t phi, Double_t weight, Int_t id) {
+  if ((fCuts != NULL) && !fCuts->IsSelected(variableContainer)) return 0;
+
+  ULong64_t mask = 0;
+  for (Int_t variation = 0; variation < fVariations.GetEntriesFast(); variation++) {
+    if (GetVariation(variation)->IsSelected(variableContainer))
+      mask |= (ULong64_t(1) << variation);
+  }
+  if (mask != 0) {
+    if (!(Int_t(fPhi.size()) < fBankCapacity)) {
+      /* the preallocated shared bank is full */
+      fNoOfDroppedDataVectors++;
+      return 0;
+    }
+    fPhi.push_back(phi);
+    fWeight.push_back(weight);
+    fId.push_back(id);
+    fAcceptanceMask.push_back(mask);
+    fBasisRow.push_back(-1);
+    for (Int_t variation = 0; variation < fVariations.GetEntriesFast(); variation++) {
+      if (((mask & (ULong64_t(1) << variation)) != 0) && GetVariation(variation)->HasTracksWeightsMap())
+        fVariationWeight.push_back(weight * GetVariation(variation)->GetTracksWeight(variableContainer, phi));
+    }
+  }
+  return mask;
+}
+
+/// Clean the shared bank to accept a new event
+///
+/// The variations configurations are cleaned by the detector.
+inline void QnCorrectionsDetectorConfigurationTracksVariations::ClearVariations() {
+  fPhi.clear();
+  fWeight.clear();
+  fId.clear();
+  fVariationWeight.clear();
+  fAcceptanceMask.clear();
+  fBasisRow.clear();
+}
+
+#endif // QNCORRECTIONS_DETECTORCONFIGURATIONTRACKSVARIATIONS_H
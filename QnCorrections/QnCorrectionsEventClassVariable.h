@@ -28,6 +28,7 @@
 
 #include <TObject.h>
 #include <TObjArray.h>
+#include "QnCorrectionsCoreVariablesBank.h"
 
 
 class QnCorrectionsEventClassVariable : public TObject {
@@ -42,6 +43,9 @@ class QnCorrectionsEventClassVariable : public TObject {
 
   /// Gets the variable unique Id
   Int_t           GetVariableId() const { return fVarId; }
+  /// Registers the variable Id for its remapping into a dense variables bank
+  /// \param bank the variables bank remapper
+  void            RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) { bank.Register(fVarId); }
   /// Gets the variable name / label
   const char *    GetVariableLabel() const { return (const char *) fLabel; }
   /// Gets the number of bins
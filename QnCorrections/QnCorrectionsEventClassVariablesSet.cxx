@@ -54,3 +54,25 @@ void QnCorrectionsEventClassVariablesSet::GetMultidimensionalConfiguration(Int_t
   }
 }
 
+/// Fills the equivalent binning for the ROOT independent core engine
+///
+/// The passed binning is cleared before incorporating the variables.
+/// The resulting linear bin numbers are the same ones the framework
+/// multidimensional histograms use for the event classes.
+///
+/// \param binning the core engine binning to fill
+void QnCorrectionsEventClassVariablesSet::FillCoreEventClassBinning(QnCorrectionsCoreEventClassBinning &binning) const {
+  binning.Clear();
+  for (Int_t var = 0; var < GetEntriesFast(); var++) {
+    binning.AddAxis(At(var)->GetVariableId(), At(var)->GetNBins(), At(var)->GetBins());
+  }
+}
+
+/// Registers the variables Ids of the whole set for their
+/// remapping into a dense variables bank
+/// \param bank the variables bank remapper
+void QnCorrectionsEventClassVariablesSet::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  for (Int_t var = 0; var < GetEntriesFast(); var++) {
+    At(var)->RegisterDataVariables(bank);
+  }
+}
@@ -14,6 +14,7 @@
 /// \brief Class that models the set of variables that define an event class for the Q vector correction framework
 
 #include "QnCorrectionsEventClassVariable.h"
+#include "QnCorrectionsCoreEventClassBinning.h"
 
 /// \class QnCorrectionsEventClassVariablesSet
 /// \brief The set of variables which define an event class
@@ -59,6 +60,8 @@ public:
   virtual QnCorrectionsEventClassVariable *At(Int_t i) const { return (QnCorrectionsEventClassVariable *) TObjArray::At(i); }
 
   void GetMultidimensionalConfiguration(Int_t *nbins, Double_t *minvals, Double_t *maxvals);
+  void FillCoreEventClassBinning(QnCorrectionsCoreEventClassBinning &binning) const;
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
 
 /// \cond CLASSIMP
   ClassDef(QnCorrectionsEventClassVariablesSet, 1);
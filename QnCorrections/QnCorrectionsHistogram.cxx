@@ -89,15 +89,13 @@ Bool_t QnCorrectionsHistogram::CreateHistogram(TList *histogramList) {
 /// Get the bin number for the current variable content
 ///
 /// The bin number identifies the event class the current
-/// variable content points to under the passed channel.
+/// variable content points to.
 ///
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsHistogram::GetBin(const Float_t *variableContainer) {
 
-  FillBinAxesValues(variableContainer);
-  /* store the channel number */
-  return fValues->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -143,13 +141,9 @@ Float_t QnCorrectionsHistogram::GetBinError(Long64_t bin) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \param weight the increment in the bin content
 void QnCorrectionsHistogram::Fill(const Float_t *variableContainer, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
   /* and now update the bin */
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
+  FillHistogram(fValues, weight);
 }
 
 
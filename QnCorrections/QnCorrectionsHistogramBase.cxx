@@ -1,16 +1,24 @@
 /// \file QnCorrectionsHistogramBase.cxx
 /// \brief Implementation of the multidimensional profile base class
 
+#include <algorithm>
+#include <mutex>
 #include "TList.h"
+#include "TMath.h"
+#include "TNDArray.h"
 
 #include "QnCorrectionsEventClassVariablesSet.h"
 #include "QnCorrectionsHistogramBase.h"
+#include "QnCorrectionsCoreCorrectionKernels.h"
 #include "QnCorrectionsLog.h"
 
 const char *QnCorrectionsHistogramBase::szChannelAxisTitle = "Channel number";
 const char *QnCorrectionsHistogramBase::szGroupAxisTitle = "Channels group";
 const char *QnCorrectionsHistogramBase::szGroupHistoPrefix = "Group";
 const char *QnCorrectionsHistogramBase::szEntriesHistoSuffix = "_entries";
+const char *QnCorrectionsHistogramBase::szSubsampleAxisTitle = "Subsample";
+const char *QnCorrectionsHistogramBase::szSubsamplesHistoSuffix = "_subsamples";
+const char *QnCorrectionsHistogramBase::szSpreadHistoSuffix = "_spread";
 const char *QnCorrectionsHistogramBase::szXComponentSuffix = "X";
 const char *QnCorrectionsHistogramBase::szYComponentSuffix = "Y";
 const char *QnCorrectionsHistogramBase::szXXCorrelationComponentSuffix = "XX";
@@ -26,16 +34,129 @@ const UInt_t QnCorrectionsHistogramBase::correlationXYmask = 0x0002;
 const UInt_t QnCorrectionsHistogramBase::correlationYXmask = 0x0004;
 const UInt_t QnCorrectionsHistogramBase::correlationYYmask = 0x0008;
 const Int_t QnCorrectionsHistogramBase::nDefaultMinNoOfEntriesValidated = 2;
+QnCorrectionsHistogramsContext QnCorrectionsHistogramBase::fgStandaloneContext;
 
 /// \cond CLASSIMP
+ClassImp(QnCorrectionsHistogramsContext);
 ClassImp(QnCorrectionsHistogramBase);
 /// \endcond
 
+/// \cond
+/// The serialization of the registrations within a context
+struct QnCorrectionsHistogramsContext::Registration {
+  std::mutex fMutex;                    ///< serializes the registries updates
+};
+/// \endcond
+
+/// Default constructor
+///
+/// Every fill mode is disabled
+QnCorrectionsHistogramsContext::QnCorrectionsHistogramsContext() :
+  TObject(),
+  fRegistration(new Registration()),
+  fEventClassBucketing(kFALSE),
+  fBucketingHistograms(),
+  fDefaultFillBufferSize(0),
+  fBufferingHistograms(),
+  fDirtyBinsTracking(kFALSE),
+  fTargetingHistograms(),
+  fNoOfSubsamples(0),
+  fCurrentSubsample(0),
+  fQuantizedTables(kFALSE),
+  fQuantizationComparison(kFALSE),
+  fNoOfIngestionThreads(1),
+  fPreallocatedFills(kFALSE) {
+}
+
+/// Default destructor
+///
+/// The histograms filled within the context should be already gone.
+QnCorrectionsHistogramsContext::~QnCorrectionsHistogramsContext() {
+  delete fRegistration;
+}
+
+/// Performs the pending fills of all the histograms within the context
+///
+/// To be called at the end of each batch of events and before
+/// the histograms content is used or stored.
+void QnCorrectionsHistogramsContext::FlushEventClassBuckets() {
+  for (UInt_t ixHistogram = 0; ixHistogram < fBucketingHistograms.size(); ixHistogram++) {
+    fBucketingHistograms[ixHistogram]->FlushBucketedFills();
+  }
+  fBucketingHistograms.clear();
+}
+
+/// Flushes the fill buffers of all the histograms within the context
+///
+/// To be called before the histograms content is used or stored.
+void QnCorrectionsHistogramsContext::FlushFillBuffers() {
+  for (UInt_t ixHistogram = 0; ixHistogram < fBufferingHistograms.size(); ixHistogram++) {
+    fBufferingHistograms[ixHistogram]->FlushFillBuffer();
+    fBufferingHistograms[ixHistogram]->fFillBufferRegistered = kFALSE;
+  }
+  fBufferingHistograms.clear();
+}
+
+/// Collects the changed bins trackers of all the histograms within the context
+///
+/// Every histogram filled while dirty bins tracking was enabled
+/// contributes with the changed bins tracker of each of its target
+/// histograms. Pending fills should be performed before.
+/// \param dirtyBins the map from target histogram to its changed bins tracker
+void QnCorrectionsHistogramsContext::CollectDirtyBins(std::map<const THnBase *, QnCorrectionsCoreDirtyBins *> &dirtyBins) const {
+  for (UInt_t ixHistogram = 0; ixHistogram < fTargetingHistograms.size(); ixHistogram++) {
+    QnCorrectionsHistogramBase *histogram = fTargetingHistograms[ixHistogram];
+    for (UInt_t target = 0; target < histogram->fFillTargets.size(); target++) {
+      dirtyBins[histogram->fFillTargets[target]] = &histogram->fDirtyBins[target];
+    }
+  }
+}
+
+/// Incorporates the passed histogram to one of the registries of pending work
+///
+/// The histograms of the context could be filled concurrently so the
+/// registration is serialized.
+/// \param registry the registry of histograms with pending work
+/// \param histogram the histogram with pending work
+void QnCorrectionsHistogramsContext::Register(std::vector<QnCorrectionsHistogramBase *> &registry, QnCorrectionsHistogramBase *histogram) {
+  std::lock_guard<std::mutex> lock(fRegistration->fMutex);
+  registry.push_back(histogram);
+}
+
+/// Removes the passed histogram from the registries of pending work
+///
+/// Its pending fills, if any, are lost.
+/// \param histogram the histogram being destroyed or leaving the context
+void QnCorrectionsHistogramsContext::Unregister(QnCorrectionsHistogramBase *histogram) {
+  std::lock_guard<std::mutex> lock(fRegistration->fMutex);
+  if (!histogram->fBucketRegisters.IsEmpty()) {
+    fBucketingHistograms.erase(std::remove(fBucketingHistograms.begin(), fBucketingHistograms.end(), histogram), fBucketingHistograms.end());
+  }
+  if (histogram->fFillBufferRegistered) {
+    fBufferingHistograms.erase(std::remove(fBufferingHistograms.begin(), fBufferingHistograms.end(), histogram), fBufferingHistograms.end());
+  }
+  if (!histogram->fFillTargets.empty()) {
+    fTargetingHistograms.erase(std::remove(fTargetingHistograms.begin(), fTargetingHistograms.end(), histogram), fTargetingHistograms.end());
+  }
+}
+
 /// Default constructor
 QnCorrectionsHistogramBase::QnCorrectionsHistogramBase() :
   TNamed(),
+  fContext(&fgStandaloneContext),
   fEventClassVariables(),
-  fBinAxesValues(NULL) {
+  fBinAxesValues(NULL),
+  fBinLocator(),
+  fLinearBinsFills(kTRUE),
+  fBucketRegisters(),
+  fFillBuffer(),
+  fFillTargets(),
+  fDirtyBins(),
+  fFillBufferRegistered(kFALSE),
+  fSubsampledHistograms(),
+  fSubsamplesHistograms(),
+  fQuantizedTables(),
+  fUseQuantizedTables(kFALSE) {
 
   fErrorMode = kERRORMEAN;
   fMinNoOfEntriesToValidate = nDefaultMinNoOfEntriesValidated;
@@ -47,6 +168,8 @@ QnCorrectionsHistogramBase::QnCorrectionsHistogramBase() :
 QnCorrectionsHistogramBase::~QnCorrectionsHistogramBase() {
   if (fBinAxesValues != NULL)
     delete [] fBinAxesValues;
+  /* pending fills, if any, are lost */
+  fContext->Unregister(this);
 }
 
 /// Normal constructor
@@ -72,11 +195,24 @@ QnCorrectionsHistogramBase::QnCorrectionsHistogramBase(const char *name,
     QnCorrectionsEventClassVariablesSet &ecvs,
     Option_t *option) :
   TNamed(name, title),
+  fContext(&fgStandaloneContext),
   fEventClassVariables(ecvs),
-  fBinAxesValues(NULL) {
+  fBinAxesValues(NULL),
+  fBinLocator(),
+  fLinearBinsFills(kTRUE),
+  fBucketRegisters(),
+  fFillBuffer(),
+  fFillTargets(),
+  fDirtyBins(),
+  fFillBufferRegistered(kFALSE),
+  fSubsampledHistograms(),
+  fSubsamplesHistograms(),
+  fQuantizedTables(),
+  fUseQuantizedTables(kFALSE) {
 
   /* one place more for storing the channel number by inherited classes */
   fBinAxesValues = new Double_t[fEventClassVariables.GetEntries() + 1];
+  SetUpBinLocator(fBinLocator);
 
   TString opt = option;
   opt.ToLower();
@@ -116,6 +252,291 @@ Bool_t QnCorrectionsHistogramBase::AttachHistograms(TList *histogramList, const
 }
 
 
+/// Sets the histograms context the histogram is filled with
+///
+/// To be invoked by the histogram creator before creating or attaching
+/// the histograms. The fill buffer size is the context default one.
+/// \param context the histograms context of the framework manager
+void QnCorrectionsHistogramBase::SetHistogramsContext(QnCorrectionsHistogramsContext *context) {
+  fContext->Unregister(this);
+  fContext = context;
+  SetFillBufferSize(fContext->GetDefaultFillBufferSize());
+}
+
+/// Reserves the storage for every bin of the passed sparse histogram
+///
+/// Only if preallocated fills were requested, so that filling new
+/// bins does not allocate. Under and overflow bins are not included.
+/// Should be invoked once the histogram errors are configured.
+/// \param histogram the sparse histogram
+void QnCorrectionsHistogramBase::PreallocateSparseBins(THnBase *histogram) {
+  if (!fContext->GetPreallocatedFills()) return;
+
+  Long64_t nBins = 1;
+  for (Int_t dim = 0; dim < histogram->GetNdimensions(); dim++) {
+    nBins *= histogram->GetAxis(dim)->GetNbins();
+  }
+  histogram->Reserve(nBins);
+}
+
+/// Incorporates the histogram to the passed registry of histograms with pending work
+///
+/// The histograms of different detector configurations could be
+/// filled concurrently so the registration is serialized by the
+/// histograms context. It only happens at the first fill after the
+/// registry has been flushed.
+/// \param registry the registry of histograms with pending work
+void QnCorrectionsHistogramBase::RegisterPendingHistogram(std::vector<QnCorrectionsHistogramBase *> &registry) {
+  fContext->Register(registry, this);
+}
+
+/// Performs the pending fills registered per event class bin
+///
+/// The touched bins are visited in increasing order and the fills of
+/// each of them are replayed in their arrival order, so the bin content
+/// and error get the same increments than with immediate fills. The
+/// entries were already accounted when the fills were registered.
+void QnCorrectionsHistogramBase::FlushBucketedFills() {
+  fBucketRegisters.Order();
+  for (Int_t entry = 0; entry < fBucketRegisters.GetNoOfEntries(); entry++) {
+    THnBase *histogram = fFillTargets[fBucketRegisters.GetTarget(entry)];
+    Long64_t bin = fBucketRegisters.GetBin(entry);
+    Bool_t calculateErrors = histogram->GetCalculateErrors();
+    for (Int_t fill = fBucketRegisters.GetFirstFill(entry); 0 <= fill; fill = fBucketRegisters.GetNextFill(fill)) {
+      Double_t value = fBucketRegisters.GetValue(fill);
+      histogram->AddBinContent(bin, value);
+      if (calculateErrors)
+        histogram->AddBinError2(bin, value * value);
+    }
+    if (fContext->GetDirtyBinsTracking())
+      fDirtyBins[fBucketRegisters.GetTarget(entry)].Mark(bin);
+  }
+  fBucketRegisters.Clear();
+}
+
+/// Sets the fill buffer size
+///
+/// The fills already buffered are performed before.
+/// Only non sparse histograms support a fill buffer.
+/// \param size the number of fills kept before flushing, zero for immediate fills
+void QnCorrectionsHistogramBase::SetFillBufferSize(Int_t size) {
+  FlushFillBuffer();
+  fFillBuffer.SetCapacity(size);
+}
+
+/// Creates and adds the subsamples histogram for the passed histogram
+///
+/// Only if subsampling is enabled. The subsamples histogram has the
+/// same axes than the passed one plus the subsample axis as the fastest
+/// running one, and it is added to the passed list just after it.
+/// \param histogramList list where the histograms are being added
+/// \param histogram the histogram to subsample
+void QnCorrectionsHistogramBase::AddSubsamplesHistogram(TList *histogramList, THnBase *histogram) {
+  Int_t nSubsamples = fContext->GetNoOfSubsamples();
+  if (nSubsamples < 1) return;
+
+  Int_t nDimensions = histogram->GetNdimensions();
+  Int_t *nbins = new Int_t[nDimensions + 1];
+  Double_t *minvals = new Double_t[nDimensions + 1];
+  Double_t *maxvals = new Double_t[nDimensions + 1];
+
+  for (Int_t dim = 0; dim < nDimensions; dim++) {
+    nbins[dim] = histogram->GetAxis(dim)->GetNbins();
+    minvals[dim] = histogram->GetAxis(dim)->GetXmin();
+    maxvals[dim] = histogram->GetAxis(dim)->GetXmax();
+  }
+  nbins[nDimensions] = nSubsamples;
+  minvals[nDimensions] = -0.5;
+  maxvals[nDimensions] = -0.5 + nSubsamples;
+
+  TString histoName = histogram->GetName(); histoName += szSubsamplesHistoSuffix;
+  TString histoTitle = histogram->GetTitle(); histoTitle += szSubsamplesHistoSuffix;
+  THnBase *subsamples;
+  if (dynamic_cast<THnI *>(histogram) != NULL)
+    subsamples = new THnI((const char *) histoName, (const char *) histoTitle, nDimensions + 1, nbins, minvals, maxvals);
+  else
+    subsamples = new THnF((const char *) histoName, (const char *) histoTitle, nDimensions + 1, nbins, minvals, maxvals);
+
+  /* the proper binning and label on each axis */
+  for (Int_t dim = 0; dim < nDimensions; dim++) {
+    TAxis *axis = histogram->GetAxis(dim);
+    if (axis->GetXbins()->GetSize() != 0)
+      subsamples->GetAxis(dim)->Set(axis->GetNbins(), axis->GetXbins()->GetArray());
+    subsamples->GetAxis(dim)->SetTitle(axis->GetTitle());
+  }
+  subsamples->GetAxis(nDimensions)->SetTitle(szSubsampleAxisTitle);
+  if (histogram->GetCalculateErrors())
+    subsamples->Sumw2();
+
+  fSubsampledHistograms.push_back(histogram);
+  fSubsamplesHistograms.push_back(subsamples);
+  histogramList->Add(subsamples);
+
+  delete [] nbins;
+  delete [] minvals;
+  delete [] maxvals;
+}
+
+/// Prepares the quantized tables storage
+///
+/// The coefficients are served at full precision until the tables
+/// are completed with EndQuantizedTables.
+/// \param nNoOfTables the number of tables
+void QnCorrectionsHistogramBase::BeginQuantizedTables(Int_t nNoOfTables) {
+  fUseQuantizedTables = kFALSE;
+  fQuantizedTables.assign(nNoOfTables, QnCorrectionsCoreQuantizedTable());
+}
+
+/// Builds a quantized table from the passed full precision coefficients
+///
+/// If any coefficient is not finite the error is reported and the whole
+/// set of quantized tables is dropped so that the coefficients keep being
+/// served at full precision. The further tables of the set are ignored.
+///
+/// In comparison mode the maximum relative deviation of the quantized
+/// coefficients from the full precision nonzero ones is reported together
+/// with the maximum absolute deviation and the table size.
+/// \param table the table number
+/// \param nBins the number of linear bins
+/// \param values the full precision coefficients, NULL for a validity only table
+/// \param valid the bins validity, NULL for not keeping it
+/// \param label the table label for the report
+void QnCorrectionsHistogramBase::QuantizeTable(Int_t table, Long64_t nBins, const Float_t *values, const Bool_t *valid, const char *label) {
+  if (fQuantizedTables.empty()) return;
+
+  QnCorrectionsCoreQuantizedTable &quantized = fQuantizedTables[table];
+  if (!quantized.Build(nBins, values, valid)) {
+    QnCorrectionsError(Form("Histogram %s %s has not finite coefficients. Its coefficients will be served at full precision. FIX IT, PLEASE.",
+        GetName(), label));
+    std::vector<QnCorrectionsCoreQuantizedTable>().swap(fQuantizedTables);
+    return;
+  }
+
+  if (fContext->GetQuantizationComparison() && (values != NULL)) {
+    Double_t maxDeviation = 0.0;
+    Double_t maxRelativeDeviation = 0.0;
+    for (Long64_t bin = 0; bin < nBins; bin++) {
+      Double_t deviation = TMath::Abs(quantized.Get(bin) - values[bin]);
+      if (maxDeviation < deviation) maxDeviation = deviation;
+      if ((values[bin] != 0.0) && (maxRelativeDeviation < deviation / TMath::Abs(values[bin])))
+        maxRelativeDeviation = deviation / TMath::Abs(values[bin]);
+    }
+    QnCorrectionsInfo(Form("Quantized %s %s: %lld bins in %lu bytes, %lu at full precision, maximum relative deviation %g, maximum deviation %g",
+        GetName(), label, nBins, (unsigned long) quantized.GetSizeInBytes(), (unsigned long) quantized.GetNoOfExactBins(),
+        maxRelativeDeviation, maxDeviation));
+  }
+}
+
+/// Builds the spread among subsamples of a profile
+///
+/// For each bin the mean of each subsample with entries is computed
+/// from the passed subsamples values and entries histograms. The
+/// returned histogram, without the subsample axis, has as content the
+/// mean of the subsamples means and as error the standard error of
+/// that mean from the subsamples dispersion. Bins with less than two
+/// subsamples with entries are left empty. Intended to be used once
+/// the subsamples histograms from the different jobs are merged.
+/// The returned histogram is owned by the caller.
+/// \param values the subsamples values histogram
+/// \param entries the corresponding subsamples entries histogram
+/// \return the spread histogram, NULL if the histograms do not match
+THnF *QnCorrectionsHistogramBase::GetSubsamplesSpread(THnF *values, THnI *entries) {
+  Int_t nDimensions = values->GetNdimensions() - 1;
+  if ((nDimensions < 1) || (entries->GetNdimensions() != nDimensions + 1) || (values->GetNbins() != entries->GetNbins()))
+    return NULL;
+
+  Int_t *nbins = new Int_t[nDimensions];
+  Double_t *minvals = new Double_t[nDimensions];
+  Double_t *maxvals = new Double_t[nDimensions];
+  for (Int_t dim = 0; dim < nDimensions; dim++) {
+    nbins[dim] = values->GetAxis(dim)->GetNbins();
+    minvals[dim] = values->GetAxis(dim)->GetXmin();
+    maxvals[dim] = values->GetAxis(dim)->GetXmax();
+  }
+  TString histoName = values->GetName(); histoName += szSpreadHistoSuffix;
+  TString histoTitle = values->GetTitle(); histoTitle += szSpreadHistoSuffix;
+  THnF *spread = new THnF((const char *) histoName, (const char *) histoTitle, nDimensions, nbins, minvals, maxvals);
+  for (Int_t dim = 0; dim < nDimensions; dim++) {
+    TAxis *axis = values->GetAxis(dim);
+    if (axis->GetXbins()->GetSize() != 0)
+      spread->GetAxis(dim)->Set(axis->GetNbins(), axis->GetXbins()->GetArray());
+    spread->GetAxis(dim)->SetTitle(axis->GetTitle());
+  }
+  spread->Sumw2();
+
+  Int_t nSubsamples = values->GetAxis(nDimensions)->GetNbins();
+  for (Long64_t bin = 0; bin < spread->GetNbins(); bin++) {
+    Int_t nFilled = 0;
+    Double_t sumMeans = 0.0;
+    Double_t sumMeans2 = 0.0;
+    for (Int_t subsample = 0; subsample < nSubsamples; subsample++) {
+      Long64_t subsamplesBin = bin * (nSubsamples + 2) + subsample + 1;
+      Double_t nEntries = entries->GetBinContent(subsamplesBin);
+      if (nEntries > 0) {
+        Double_t mean = values->GetBinContent(subsamplesBin) / nEntries;
+        sumMeans += mean;
+        sumMeans2 += mean * mean;
+        nFilled++;
+      }
+    }
+    if (nFilled > 1) {
+      Double_t mean = sumMeans / nFilled;
+      Double_t variance = (sumMeans2 - nFilled * mean * mean) / (nFilled - 1);
+      spread->SetBinContent(bin, mean);
+      spread->SetBinError2(bin, ((variance > 0.0) ? variance : 0.0) / nFilled);
+    }
+  }
+  spread->SetEntries(entries->GetEntries());
+
+  delete [] nbins;
+  delete [] minvals;
+  delete [] maxvals;
+  return spread;
+}
+
+/// Performs the buffered fills
+///
+/// The buffered fills are sorted by target histogram and bin and
+/// the ones for the same bin are coalesced. Each target bin content
+/// and error are then updated once, in increasing bin order, and each
+/// target histogram entries are increased by the number of buffered fills.
+void QnCorrectionsHistogramBase::FlushFillBuffer() {
+  Int_t nEntries = fFillBuffer.Coalesce();
+  if (nEntries == 0) return;
+
+  std::vector<Long64_t> nFills(fFillTargets.size(), 0);
+  for (Int_t entry = 0; entry < nEntries; entry++) {
+    THnBase *histogram = fFillTargets[fFillBuffer.GetTarget(entry)];
+    histogram->AddBinContent(fFillBuffer.GetBin(entry), fFillBuffer.GetSumValues(entry));
+    if (histogram->GetCalculateErrors())
+      histogram->AddBinError2(fFillBuffer.GetBin(entry), fFillBuffer.GetSumValues2(entry));
+    nFills[fFillBuffer.GetTarget(entry)] += fFillBuffer.GetNoOfFills(entry);
+    if (fContext->GetDirtyBinsTracking())
+      fDirtyBins[fFillBuffer.GetTarget(entry)].Mark(fFillBuffer.GetBin(entry));
+  }
+  for (UInt_t target = 0; target < fFillTargets.size(); target++) {
+    if (nFills[target] != 0)
+      fFillTargets[target]->SetEntries(fFillTargets[target]->GetEntries() + nFills[target]);
+  }
+  fFillBuffer.Clear();
+}
+
+/// Sets up a bin locator for the event classes variables
+///
+/// If extra bins are requested an additional axis, with the
+/// same binning the channelized histograms use for its channel
+/// or group axis, is added as the fastest running one. Its
+/// value has to be passed explicitly when locating bins.
+///
+/// \param locator the bin locator to set up
+/// \param nNoOfExtraBins the number of bins of the additional channel or group axis
+void QnCorrectionsHistogramBase::SetUpBinLocator(QnCorrectionsCoreEventClassBinning &locator, Int_t nNoOfExtraBins) {
+  fEventClassVariables.FillCoreEventClassBinning(locator);
+  if (0 < nNoOfExtraBins) {
+    locator.AddAxis(-1, nNoOfExtraBins, -0.5, -0.5 + nNoOfExtraBins);
+  }
+}
+
 /// Get the bin number for the current variable content
 ///
 /// The bin number identifies the event class the current
@@ -803,6 +1224,9 @@ void QnCorrectionsHistogramBase::FillYY(Int_t harmonic, const Float_t *variableC
 /// Creates a value / error multidimensional histogram from
 /// a values and entries multidimensional histograms.
 /// The validation histogram is filled according to entries threshold value.
+///
+/// The division is performed in bulk over the histograms bins arrays,
+/// on as many threads as set with SetNoOfIngestionThreads.
 /// \param hValues the values multidimensional histogram
 /// \param hEntries the entries multidimensional histogram
 /// \param hValid optional multidimensional histogram where validation information is stored
@@ -810,48 +1234,38 @@ void QnCorrectionsHistogramBase::FillYY(Int_t harmonic, const Float_t *variableC
 THnF* QnCorrectionsHistogramBase::DivideTHnF(THnF *hValues, THnI *hEntries, THnC *hValid) {
 
   THnF *hResult =  (THnF*) THn::CreateHn(hValues->GetName(), hValues->GetTitle(), hValues);
+  Long64_t nBins = hResult->GetNbins();
 
-  Double_t value, error2;
-  Int_t nEntries;
-  Bool_t bErrorMessage = kFALSE;
-  Int_t nNotValidatedBins = 0;
-
-  for (Long64_t bin = 0; bin < hResult->GetNbins(); bin++){
-    value = hValues->GetBinContent(bin);
-    nEntries = Int_t(hEntries->GetBinContent(bin));
-    error2 = hValues->GetBinError2(bin);
-
-    if (nEntries < fMinNoOfEntriesToValidate) {
-      /* bin content not validated */
-      hResult->SetBinContent(bin, 0.0);
-      hResult->SetBinError(bin, 0.0);
-      if (hValid != NULL) hValid->SetBinContent(bin, 0.0);
-      if (value != 0.0) {
-        bErrorMessage = kTRUE;
-        nNotValidatedBins++;
-      }
-    }
-    else {
-      Double_t average = value / nEntries;
-      Double_t serror = TMath::Sqrt(TMath::Abs(error2 / nEntries - average * average));
-      switch (fErrorMode) {
-      case kERRORMEAN:
-        /* standard error on the mean of the bin values */
-        hResult->SetBinContent(bin, average);
-        hResult->SetBinError(bin, serror / TMath::Sqrt(nEntries));
-        break;
-      case kERRORSPREAD:
-        /* standard deviation of the bin values */
-        hResult->SetBinContent(bin, average);
-        hResult->SetBinError(bin, serror);
-        break;
-      }
-      if (hValid != NULL) hValid->SetBinContent(bin, 1.0);
-    }
-    hResult->SetEntries(hValues->GetEntries());
+  /* the bins arrays */
+  Float_t *values = &static_cast<TNDArrayT<Float_t> &>(hValues->GetArray()).At(0);
+  Int_t *entries = &static_cast<TNDArrayT<Int_t> &>(hEntries->GetArray()).At(0);
+  Float_t *averages = &static_cast<TNDArrayT<Float_t> &>(hResult->GetArray()).At(0);
+  std::vector<Char_t> validated;
+  Char_t *valid = NULL;
+  if (hValid != NULL) {
+    valid = &static_cast<TNDArrayT<Char_t> &>(hValid->GetArray()).At(0);
+  }
+  else {
+    validated.resize(nBins);
+    valid = &validated[0];
   }
-  if (bErrorMessage) {
-    QnCorrectionsError(Form("There are %d bins whose bin content were not validated! histogram: %s.\n" \
+  /* the squared errors are only reachable bin by bin */
+  std::vector<Double_t> values2(nBins);
+  std::vector<Double_t> errors2(nBins);
+  for (Long64_t bin = 0; bin < nBins; bin++) {
+    values2[bin] = hValues->GetBinError2(bin);
+  }
+
+  Long64_t nNotValidatedBins = QnCorrectionsCoreCorrectionKernels::DivideProfile(nBins, values, &values2[0], entries,
+      fMinNoOfEntriesToValidate, (fErrorMode == kERRORMEAN), averages, &errors2[0], valid, fContext->GetNoOfIngestionThreads());
+
+  for (Long64_t bin = 0; bin < nBins; bin++) {
+    hResult->SetBinError2(bin, errors2[bin]);
+  }
+  hResult->SetEntries(hValues->GetEntries());
+
+  if (nNotValidatedBins != 0) {
+    QnCorrectionsError(Form("There are %lld bins whose bin content were not validated! histogram: %s.\n" \
         "   Minimum number of entries to validate: %d.",
         nNotValidatedBins,
         hValues->GetName(),
@@ -4,8 +4,132 @@
 /// \file QnCorrectionsHistogramBase.h
 /// \brief Multidimensional profile histograms base class for the Q vector correction framework
 
+#include <vector>
+#include <map>
 #include <THn.h>
 #include "QnCorrectionsEventClassVariablesSet.h"
+#include "QnCorrectionsCoreBinRegisters.h"
+#include "QnCorrectionsCoreFillBuffer.h"
+#include "QnCorrectionsCoreDirtyBins.h"
+#include "QnCorrectionsCoreQuantizedTable.h"
+
+class QnCorrectionsHistogramBase;
+
+/// \class QnCorrectionsHistogramsContext
+/// \brief The histograms fill modes and pending work of a framework manager
+///
+/// Keeps the fill modes the histograms of a framework manager are
+/// created and filled with, together with the registries of those
+/// histograms with pending fills or with changed bins to collect.
+/// Each framework manager owns its context so several managers can
+/// coexist in the same process without sharing their fill modes.
+///
+/// The histograms get the context at creation. The ones created
+/// outside a framework manager get a standalone context with every
+/// fill mode disabled.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsHistogramsContext : public TObject {
+  friend class QnCorrectionsHistogramBase;
+public:
+  QnCorrectionsHistogramsContext();
+  virtual ~QnCorrectionsHistogramsContext();
+
+  /// Enables or disables the event class bucketing of the histograms fills
+  ///
+  /// Pending fills are flushed when bucketing is disabled.
+  /// \param enable kTRUE for deferring and grouping by event class bin the histograms fills
+  void SetEventClassBucketing(Bool_t enable) { if (!enable) FlushEventClassBuckets(); fEventClassBucketing = enable; }
+  /// Gets whether the histograms fills are bucketed by event class bin
+  /// \return kTRUE if the histograms fills are deferred and grouped by event class bin
+  Bool_t GetEventClassBucketing() const { return fEventClassBucketing; }
+  void FlushEventClassBuckets();
+
+  /// Sets the fill buffer size for the histograms created from now on
+  /// \param size the number of fills kept before flushing, zero for immediate fills
+  void SetDefaultFillBufferSize(Int_t size) { fDefaultFillBufferSize = size; }
+  /// Gets the fill buffer size for the new histograms
+  /// \return the number of fills kept before flushing, zero for immediate fills
+  Int_t GetDefaultFillBufferSize() const { return fDefaultFillBufferSize; }
+  void FlushFillBuffers();
+
+  /// Enables or disables the tracking of the bins changed by the histograms fills
+  /// \param enable kTRUE for tracking the changed bins
+  void SetDirtyBinsTracking(Bool_t enable) { fDirtyBinsTracking = enable; }
+  /// Gets whether the bins changed by the histograms fills are tracked
+  /// \return kTRUE if the changed bins are tracked
+  Bool_t GetDirtyBinsTracking() const { return fDirtyBinsTracking; }
+  void CollectDirtyBins(std::map<const THnBase *, QnCorrectionsCoreDirtyBins *> &dirtyBins) const;
+
+  /// Sets the number of subsamples for the histograms created from now on
+  /// \param nNoOfSubsamples the number of subsamples, zero for no subsampling
+  void SetNoOfSubsamples(Int_t nNoOfSubsamples) { fNoOfSubsamples = nNoOfSubsamples; }
+  /// Gets the number of subsamples
+  /// \return the number of subsamples, zero if no subsampling
+  Int_t GetNoOfSubsamples() const { return fNoOfSubsamples; }
+  /// Sets the subsample the current event is assigned to
+  /// \param subsample the subsample number, from zero to the number of subsamples minus one
+  void SetCurrentSubsample(Int_t subsample) { fCurrentSubsample = subsample; }
+  /// Gets the subsample the current event is assigned to
+  /// \return the subsample number
+  Int_t GetCurrentSubsample() const { return fCurrentSubsample; }
+
+  /// Enables or disables the quantized calibration tables for the histograms attached from now on
+  /// \param enable kTRUE for serving the calibration coefficients from quantized tables
+  /// \param compare kTRUE for reporting the deviations from the full precision coefficients
+  void SetQuantizedTables(Bool_t enable, Bool_t compare = kFALSE)
+  { fQuantizedTables = enable; fQuantizationComparison = compare; }
+  /// Gets whether the calibration coefficients are served from quantized tables
+  /// \return kTRUE if quantized tables are in use
+  Bool_t GetQuantizedTables() const { return fQuantizedTables; }
+  /// Gets whether the quantized tables deviations are reported
+  /// \return kTRUE if the deviations are reported
+  Bool_t GetQuantizationComparison() const { return fQuantizationComparison; }
+  /// Sets the number of threads for dividing the attached profiles values by their entries
+  /// \param nNoOfThreads the maximum number of threads, one for no multithreading
+  void SetNoOfIngestionThreads(Int_t nNoOfThreads) { fNoOfIngestionThreads = nNoOfThreads; }
+  /// Gets the number of threads for dividing the attached profiles values by their entries
+  /// \return the maximum number of threads
+  Int_t GetNoOfIngestionThreads() const { return fNoOfIngestionThreads; }
+  /// Sets whether the storage of the sparse histograms created from now on is preallocated
+  /// \param enable kTRUE for the sparse histograms fills not allocating
+  void SetPreallocatedFills(Bool_t enable) { fPreallocatedFills = enable; }
+  /// Gets whether the storage of the new sparse histograms is preallocated
+  /// \return kTRUE if the sparse histograms fills do not allocate
+  Bool_t GetPreallocatedFills() const { return fPreallocatedFills; }
+
+private:
+  void Register(std::vector<QnCorrectionsHistogramBase *> &registry, QnCorrectionsHistogramBase *histogram);
+  void Unregister(QnCorrectionsHistogramBase *histogram);
+
+  struct Registration;
+  Registration *fRegistration;                              //!<! serializes the registrations of the histograms with pending work
+  Bool_t fEventClassBucketing;                              //!<! the histograms fills are bucketed by event class bin
+  std::vector<QnCorrectionsHistogramBase *> fBucketingHistograms; //!<! the histograms with pending fills
+  Int_t fDefaultFillBufferSize;                             //!<! the fill buffer size for the new histograms
+  std::vector<QnCorrectionsHistogramBase *> fBufferingHistograms; //!<! the histograms with buffered fills
+  Bool_t fDirtyBinsTracking;                                //!<! the bins changed by the histograms fills are tracked
+  std::vector<QnCorrectionsHistogramBase *> fTargetingHistograms; //!<! the histograms with fill targets
+  Int_t fNoOfSubsamples;                                    //!<! the number of subsamples for the new histograms
+  Int_t fCurrentSubsample;                                  //!<! the subsample the current event is assigned to
+  Bool_t fQuantizedTables;                                  //!<! the attached histograms build quantized tables
+  Bool_t fQuantizationComparison;                           //!<! the quantized tables deviations are reported
+  Int_t fNoOfIngestionThreads;                              //!<! the threads for dividing the attached profiles
+  Bool_t fPreallocatedFills;                                //!<! the storage of the new sparse histograms is preallocated
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsHistogramsContext(const QnCorrectionsHistogramsContext &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsHistogramsContext& operator= (const QnCorrectionsHistogramsContext &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsHistogramsContext, 1);
+/// \endcond
+};
 
 /// \class QnCorrectionsHistogramBase
 /// \brief Base class for the Q vector correction histograms
@@ -28,6 +152,45 @@
 /// The encapsulated bin axes values provide an efficient
 /// runtime storage for computing bin numbers.
 ///
+/// The encapsulated bin locator, built from the event classes
+/// variables set, computes the same linear bin numbers than the
+/// non sparse multidimensional histograms without going through
+/// their generic per axis bin search.
+///
+/// When event class bucketing is enabled the histograms fills are
+/// not performed immediately but accumulated in a register per event
+/// class bin. When flushed, each touched bin is updated once with its
+/// accumulated values so the bins hit by a batch of events are visited
+/// once per batch instead of once per fill.
+///
+/// Alternatively, non sparse histograms can use a fill buffer. Each
+/// fill is then stored as its linear bin and value in a small buffer
+/// which, when full or when flushed, is sorted and coalesced so that
+/// each target bin is updated once with the sum of its values. The
+/// histograms entries are kept updated in every fill mode.
+///
+/// The fill modes are the ones of the histograms context of the
+/// framework manager the histogram was created by.
+///
+/// When dirty bins tracking is enabled the bins changed by the
+/// fills are recorded per target histogram, whatever the fill mode is,
+/// so that the histograms can be incrementally checkpointed.
+///
+/// When subsampling is enabled each profile histogram is accompanied
+/// by a subsamples histogram with an additional, fastest running, axis
+/// for the subsample the current event is assigned to. The K copies of
+/// each bin are then adjacent and the subsample fill just offsets the
+/// bin the histogram fill goes to. The subsamples histograms are filled
+/// immediately whatever the fill mode is. The profile histograms keep
+/// the merged values while the spread among subsamples, once the
+/// outputs are merged, is provided by GetSubsamplesSpread.
+///
+/// When quantized tables are enabled the histograms used as calibration
+/// inputs keep, once attached, their final per bin coefficients and bin
+/// validity in compact tables which then serve the bin content, error
+/// and validation requests. In comparison mode the deviation of each
+/// table from the full precision coefficients is reported.
+///
 /// Provides the interface for the whole set of histogram
 /// classes providing error information that helps debugging.
 ///
@@ -36,6 +199,7 @@
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
 /// \date Jan 11, 2016
 class QnCorrectionsHistogramBase : public TNamed {
+  friend class QnCorrectionsHistogramsContext;
 protected:
   /// \typedef QnCorrectionHistogramErrorMode
   /// \brief The type of bin errors supported by the framework histograms.
@@ -107,14 +271,51 @@ public:
   virtual void FillYX(Int_t harmonic, const Float_t *variableContainer, Float_t weight);
   virtual void FillYY(Int_t harmonic, const Float_t *variableContainer, Float_t weight);
 
+  void SetHistogramsContext(QnCorrectionsHistogramsContext *context);
+  /// Gets the histograms context the histogram is filled with
+  /// \return the histograms context
+  QnCorrectionsHistogramsContext *GetHistogramsContext() const { return fContext; }
+  virtual void SetFillBufferSize(Int_t size);
+  /// Gets the fill buffer size
+  /// \return the number of fills kept before flushing, zero for immediate fills
+  Int_t GetFillBufferSize() const { return fFillBuffer.GetCapacity(); }
+  static THnF *GetSubsamplesSpread(THnF *values, THnI *entries);
+
 protected:
   void FillBinAxesValues(const Float_t *variableContainer, Int_t chgrpId = -1);
+  void SetUpBinLocator(QnCorrectionsCoreEventClassBinning &locator, Int_t nNoOfExtraBins = 0);
+  void FillHistogram(THnBase *histogram, Double_t weight);
+  void FlushBucketedFills();
+  void RegisterPendingHistogram(std::vector<QnCorrectionsHistogramBase *> &registry);
+  void PreallocateSparseBins(THnBase *histogram);
+  Int_t GetFillTarget(THnBase *histogram);
+  void MarkDirtyBin(THnBase *histogram, Long64_t bin);
+  void AddSubsamplesHistogram(TList *histogramList, THnBase *histogram);
+  void FillSubsamples(THnBase *histogram, Double_t weight);
+  void BeginQuantizedTables(Int_t nNoOfTables);
+  void QuantizeTable(Int_t table, Long64_t nBins, const Float_t *values, const Bool_t *valid, const char *label);
+  /// Starts serving the coefficients from the quantized tables, if they could be built
+  void EndQuantizedTables() { fUseQuantizedTables = !fQuantizedTables.empty(); }
+  void FlushFillBuffer();
   THnF* DivideTHnF(THnF* values, THnI* entries, THnC *valid = NULL);
   void CopyTHnF(THnF *hDest, THnF *hSource, Int_t *binsArray);
   void CopyTHnFDimension(THnF *hDest, THnF *hSource, Int_t *binsArray, Int_t dimension);
 
+  QnCorrectionsHistogramsContext *fContext;                  //!<! The fill modes and pending work registries the histogram is filled with
+  static QnCorrectionsHistogramsContext fgStandaloneContext; ///< the context of the histograms not created by a framework manager
   QnCorrectionsEventClassVariablesSet fEventClassVariables;  //!<! The variables set that determines the event classes
   Double_t *fBinAxesValues;                                  //!<! Runtime place holder for computing bin number
+  QnCorrectionsCoreEventClassBinning fBinLocator;            //!<! The event classes bin locator
+  Bool_t fLinearBinsFills;                                   //!<! The histograms bins are the event classes linear bins
+  QnCorrectionsCoreBinRegisters fBucketRegisters;            //!<! The pending fills registered per event class bin
+  QnCorrectionsCoreFillBuffer fFillBuffer;                   //!<! The fill buffer
+  std::vector<THnBase *> fFillTargets;                       //!<! The target histograms of the fill buffer and of the dirty bins
+  std::vector<QnCorrectionsCoreDirtyBins> fDirtyBins;        //!<! The changed bins of each target histogram
+  Bool_t fFillBufferRegistered;                              //!<! The histogram is registered for flushing its fill buffer
+  std::vector<THnBase *> fSubsampledHistograms;              //!<! The histograms with a subsamples histogram
+  std::vector<THnBase *> fSubsamplesHistograms;              //!<! The subsamples histogram of each subsampled histogram
+  std::vector<QnCorrectionsCoreQuantizedTable> fQuantizedTables; //!<! The quantized calibration tables
+  Bool_t fUseQuantizedTables;                                //!<! The coefficients are served from the quantized tables
   QnCorrectionHistogramErrorMode fErrorMode;                 //!<! The error type for the current instance
   Int_t fMinNoOfEntriesToValidate;                           ///< the minimum number of entries for validating a bin content
   /// \cond CLASSIMP
@@ -124,6 +325,9 @@ protected:
   static const char *szGroupAxisTitle;                   ///< The title for the channel group extra axis
   static const char *szGroupHistoPrefix;                 ///< The prefix for the name of the group histograms
   static const char *szEntriesHistoSuffix;               ///< The suffix for the name of the entries histograms
+  static const char *szSubsampleAxisTitle;               ///< The title for the subsample extra axis
+  static const char *szSubsamplesHistoSuffix;            ///< The suffix for the name of the subsamples histograms
+  static const char *szSpreadHistoSuffix;                ///< The suffix for the name of the subsamples spread histograms
   static const char *szXComponentSuffix;                 ///< The suffix for the name of X component histograms
   static const char *szYComponentSuffix;                 ///< The suffix for the name of Y component histograms
   static const char *szXXCorrelationComponentSuffix;     ///< The suffix for the name of XX correlation component histograms
@@ -154,5 +358,120 @@ inline void QnCorrectionsHistogramBase::FillBinAxesValues(const Float_t *variabl
   fBinAxesValues[fEventClassVariables.GetEntriesFast()] = chgrpId;
 }
 
+/// Fills the passed histogram at the current axes values
+///
+/// The histogram number of entries is kept updated with one
+/// entry per fill whatever the fill mode is.
+///
+/// If the fill buffer is in use the fill is stored in it as its linear
+/// bin and weight and the buffer is flushed when full. The entries
+/// are then updated when the buffer is flushed.
+///
+/// If event class bucketing is enabled the fill is accumulated in the
+/// register of its event class bin for being performed, once per bin, when
+/// the buckets are flushed. The histogram number of entries is nevertheless
+/// updated immediately. The sparse histograms are filled immediately.
+///
+/// Otherwise the histogram is filled immediately at the located linear
+/// bin, without going through THn::GetBin. The sparse histograms bins are
+/// not the event classes linear bins and they are filled at the axes values.
+///
+/// If dirty bins tracking is enabled the changed bin is recorded
+/// when the histogram bin is actually updated.
+///
+/// If the histogram has a subsamples histogram this one is filled
+/// immediately for the current subsample.
+///
+/// \param histogram the histogram to fill
+/// \param weight the increment in the bin content
+inline void QnCorrectionsHistogramBase::FillHistogram(THnBase *histogram, Double_t weight) {
+  if (!fSubsampledHistograms.empty())
+    FillSubsamples(histogram, weight);
+  if (fFillBuffer.IsEnabled()) {
+    if (!fFillBufferRegistered) {
+      /* first buffered fill, register for flushing */
+      RegisterPendingHistogram(fContext->fBufferingHistograms);
+      fFillBufferRegistered = kTRUE;
+    }
+    if (fFillBuffer.Add(GetFillTarget(histogram), fBinLocator.GetBinFromValues(fBinAxesValues), weight))
+      FlushFillBuffer();
+    return;
+  }
+  if (!fContext->fEventClassBucketing || !fLinearBinsFills) {
+    Double_t nEntries = histogram->GetEntries();
+    Long64_t bin;
+    if (fLinearBinsFills) {
+      bin = fBinLocator.GetBinFromValues(fBinAxesValues);
+      histogram->AddBinContent(bin, weight);
+      if (histogram->GetCalculateErrors())
+        histogram->AddBinError2(bin, weight * weight);
+    }
+    else {
+      bin = histogram->Fill(fBinAxesValues, weight);
+    }
+    histogram->SetEntries(nEntries + 1);
+    MarkDirtyBin(histogram, bin);
+    return;
+  }
+  if (fBucketRegisters.IsEmpty()) {
+    /* first pending fill, register for flushing */
+    RegisterPendingHistogram(fContext->fBucketingHistograms);
+  }
+  fBucketRegisters.Add(GetFillTarget(histogram), fBinLocator.GetBinFromValues(fBinAxesValues), weight);
+  histogram->SetEntries(histogram->GetEntries() + 1);
+}
+
+/// Gets the fill target number associated to the passed histogram
+///
+/// The few histograms a framework histogram encapsulates are
+/// incorporated to the fill targets at their first buffered or tracked fill.
+/// \param histogram the histogram to fill
+/// \return the fill target number
+inline Int_t QnCorrectionsHistogramBase::GetFillTarget(THnBase *histogram) {
+  for (UInt_t target = 0; target < fFillTargets.size(); target++) {
+    if (fFillTargets[target] == histogram) return target;
+  }
+  if (fFillTargets.empty()) {
+    /* first target, register for collecting its changed bins */
+    RegisterPendingHistogram(fContext->fTargetingHistograms);
+  }
+  fFillTargets.push_back(histogram);
+  fDirtyBins.push_back(QnCorrectionsCoreDirtyBins());
+  return fFillTargets.size() - 1;
+}
+
+/// Records the passed bin of the passed histogram as changed
+///
+/// Only if dirty bins tracking is enabled.
+/// \param histogram the changed histogram
+/// \param bin the changed bin, as the histogram numbers it
+inline void QnCorrectionsHistogramBase::MarkDirtyBin(THnBase *histogram, Long64_t bin) {
+  if (fContext->fDirtyBinsTracking)
+    fDirtyBins[GetFillTarget(histogram)].Mark(bin);
+}
+
+/// Fills the subsamples histogram of the passed histogram, if any
+///
+/// The subsample axis is the fastest running one so the subsamples
+/// bin is the histogram bin scaled by the subsample axis size, under
+/// and overflow included, and offset by the current subsample.
+/// \param histogram the histogram being filled
+/// \param weight the increment in the bin content
+inline void QnCorrectionsHistogramBase::FillSubsamples(THnBase *histogram, Double_t weight) {
+  for (UInt_t ix = 0; ix < fSubsampledHistograms.size(); ix++) {
+    if (fSubsampledHistograms[ix] == histogram) {
+      THnBase *subsamples = fSubsamplesHistograms[ix];
+      Int_t nSubsamples = subsamples->GetAxis(subsamples->GetNdimensions() - 1)->GetNbins();
+      Long64_t bin = fBinLocator.GetBinFromValues(fBinAxesValues) * (nSubsamples + 2) + fContext->fCurrentSubsample + 1;
+      subsamples->AddBinContent(bin, weight);
+      if (subsamples->GetCalculateErrors())
+        subsamples->AddBinError2(bin, weight * weight);
+      subsamples->SetEntries(subsamples->GetEntries() + 1);
+      MarkDirtyBin(subsamples, bin);
+      return;
+    }
+  }
+}
+
 
 #endif
@@ -113,6 +113,9 @@ Bool_t QnCorrectionsHistogramChannelized::CreateChannelizedHistogram(TList *hist
   maxvals[nVariables] = -0.5 + fActualNoOfChannels;
   nbins[nVariables] = fActualNoOfChannels;
 
+  /* the bin locator has to include the channel axis */
+  SetUpBinLocator(fBinLocator, fActualNoOfChannels);
+
   /* create the values multidimensional histogram */
   fValues = new THnF((const char *) histoName, (const char *) histoTitle,nVariables+1,nbins,minvals,maxvals);
 
@@ -155,9 +158,8 @@ Bool_t QnCorrectionsHistogramChannelized::CreateChannelizedHistogram(TList *hist
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsHistogramChannelized::GetBin(const Float_t *variableContainer, Int_t nChannel) {
 
-  FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
-  /* store the channel number */
-  return fValues->GetBin(fBinAxesValues);
+  /* the channel number goes to the channel axis */
+  return fBinLocator.GetBin(variableContainer, fChannelMap[nChannel]);
 }
 
 /// Check the validity of the content of the passed bin
@@ -204,13 +206,9 @@ Float_t QnCorrectionsHistogramChannelized::GetBinError(Long64_t bin) {
 /// \param nChannel the interested external channel number
 /// \param weight the increment in the bin content
 void QnCorrectionsHistogramChannelized::Fill(const Float_t *variableContainer, Int_t nChannel, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
   /* and now update the bin */
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
+  FillHistogram(fValues, weight);
 }
 
 
@@ -15,6 +15,7 @@ ClassImp(QnCorrectionsHistogramChannelizedSparse);
 QnCorrectionsHistogramChannelizedSparse::QnCorrectionsHistogramChannelizedSparse() :
     QnCorrectionsHistogramBase() {
   fValues = NULL;
+  fLinearBinsFills = kFALSE;
   fUsedChannel = NULL;
   fNoOfChannels = 0;
   fActualNoOfChannels = 0;
@@ -39,6 +40,9 @@ QnCorrectionsHistogramChannelizedSparse::QnCorrectionsHistogramChannelizedSparse
           QnCorrectionsHistogramBase(name, title, ecvs) {
   fValues = NULL;
   fValues = NULL;
+  /* sparse histograms fills are never buffered nor performed at the linear bins */
+  fFillBuffer.SetCapacity(0);
+  fLinearBinsFills = kFALSE;
   fUsedChannel = NULL;
   fNoOfChannels = nNoOfChannels;
   fActualNoOfChannels = 0;
@@ -135,6 +139,7 @@ Bool_t QnCorrectionsHistogramChannelizedSparse::CreateChannelizedHistogram(TList
   }
 
   fValues->Sumw2();
+  PreallocateSparseBins(fValues);
 
   histogramList->Add(fValues);
 
@@ -204,13 +209,9 @@ Float_t QnCorrectionsHistogramChannelizedSparse::GetBinError(Long64_t bin) {
 /// \param nChannel the interested external channel number
 /// \param weight the increment in the bin content
 void QnCorrectionsHistogramChannelizedSparse::Fill(const Float_t *variableContainer, Int_t nChannel, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
   /* and now update the bin */
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
+  FillHistogram(fValues, weight);
 }
 
 
@@ -55,6 +55,9 @@ public:
   virtual void Fill(const Float_t *variableContainer, Float_t weight)
   { QnCorrectionsHistogramBase::Fill(variableContainer, weight); }
   virtual void Fill(const Float_t *variableContainer, Int_t nChannel, Float_t weight);
+  /// Sparse histograms linear bins are not the event classes bins
+  /// so their fills are never buffered
+  virtual void SetFillBufferSize(Int_t) {}
 private:
   THnSparseF *fValues;              //!<! Cumulates values for each of the event classes
   Bool_t *fUsedChannel;       //!<! array, which of the detector channels is used for this configuration
@@ -15,6 +15,7 @@ ClassImp(QnCorrectionsHistogramSparse);
 QnCorrectionsHistogramSparse::QnCorrectionsHistogramSparse() :
     QnCorrectionsHistogramBase() {
   fValues = NULL;
+  fLinearBinsFills = kFALSE;
 }
 
 /// Normal constructor
@@ -32,6 +33,9 @@ QnCorrectionsHistogramSparse::QnCorrectionsHistogramSparse(const char *name,
       QnCorrectionsEventClassVariablesSet &ecvs) :
           QnCorrectionsHistogramBase(name, title, ecvs) {
   fValues = NULL;
+  /* sparse histograms fills are never buffered nor performed at the linear bins */
+  fFillBuffer.SetCapacity(0);
+  fLinearBinsFills = kFALSE;
 }
 
 /// Default destructor
@@ -74,6 +78,7 @@ Bool_t QnCorrectionsHistogramSparse::CreateHistogram(TList *histogramList) {
   }
 
   fValues->Sumw2();
+  PreallocateSparseBins(fValues);
 
   histogramList->Add(fValues);
 
@@ -141,13 +146,9 @@ Float_t QnCorrectionsHistogramSparse::GetBinError(Long64_t bin) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \param weight the increment in the bin content
 void QnCorrectionsHistogramSparse::Fill(const Float_t *variableContainer, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
   /* and now update the bin */
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
+  FillHistogram(fValues, weight);
 }
 
 
@@ -42,6 +42,9 @@ public:
   virtual Float_t GetBinError(Long64_t bin);
 
   virtual void Fill(const Float_t *variableContainer, Float_t weight);
+  /// Sparse histograms linear bins are not the event classes bins
+  /// so their fills are never buffered
+  virtual void SetFillBufferSize(Int_t) {}
   /// wrong call for this class invoke base class behavior
   virtual void Fill(const Float_t *variableContainer, Int_t nChannel, Float_t weight)
   { QnCorrectionsHistogramBase::Fill(variableContainer, nChannel, weight); }
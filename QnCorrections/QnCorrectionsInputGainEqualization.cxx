@@ -62,6 +62,7 @@ ClassImp(QnCorrectionsInputGainEqualization);
 QnCorrectionsInputGainEqualization::QnCorrectionsInputGainEqualization() :
     QnCorrectionsCorrectionOnInputData(szCorrectionName, szKey) {
   fInputHistograms = NULL;
+  fStagedInputHistograms = NULL;
   fCalibrationHistograms = NULL;
   fQAMultiplicityBefore = NULL;
   fQAMultiplicityAfter = NULL;
@@ -79,6 +80,8 @@ QnCorrectionsInputGainEqualization::QnCorrectionsInputGainEqualization() :
 QnCorrectionsInputGainEqualization::~QnCorrectionsInputGainEqualization() {
   if (fInputHistograms != NULL)
     delete fInputHistograms;
+  if (fStagedInputHistograms != NULL)
+    delete fStagedInputHistograms;
   if (fCalibrationHistograms != NULL)
     delete fCalibrationHistograms;
   if (fQAMultiplicityBefore != NULL)
@@ -107,6 +110,55 @@ Bool_t QnCorrectionsInputGainEqualization::AttachInput(TList *list) {
   return kFALSE;
 }
 
+/// Stages the input information found in a new calibration for a later swap
+///
+/// Only if the correction step is being applied new input information
+/// is staged. The new histograms are attached to the passed list which
+/// should be kept until the staged information is swapped or discarded.
+/// \param list list where the new inputs should be found, NULL if not present
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsInputGainEqualization::StageInput(TList *list) {
+
+  if (!IsBeingApplied()) return kTRUE;
+  if (list == NULL) return kFALSE;
+
+  QnCorrectionsDetectorConfigurationChannels *ownerConfiguration =
+      static_cast<QnCorrectionsDetectorConfigurationChannels *>(fDetectorConfiguration);
+  TString histoNameAndTitle = TString::Format("%s %s",
+      szSupportHistogramName,
+      fDetectorConfiguration->GetName());
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = new QnCorrectionsProfileChannelizedIngress((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
+      ownerConfiguration->GetEventClassVariablesSet(),ownerConfiguration->GetNoOfChannels(), "s");
+  fStagedInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
+  fStagedInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (fStagedInputHistograms->AttachHistograms(list,
+      ownerConfiguration->GetUsedChannelsMask(), ownerConfiguration->GetChannelsGroups())) {
+    return kTRUE;
+  }
+  delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+  return kFALSE;
+}
+
+/// Replaces the input information in use by the staged one if any
+void QnCorrectionsInputGainEqualization::SwapStagedInput() {
+
+  if (fStagedInputHistograms != NULL) {
+    delete fInputHistograms;
+    fInputHistograms = fStagedInputHistograms;
+    fStagedInputHistograms = NULL;
+  }
+}
+
+/// Deletes the staged input information if any
+void QnCorrectionsInputGainEqualization::DiscardStagedInput() {
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+}
+
 /// Asks for support data structures creation
 ///
 /// Does nothing for the time being
@@ -136,9 +188,11 @@ QnCorrectionsDetectorConfigurationChannels *ownerConfiguration =
   if (fInputHistograms != NULL) delete fInputHistograms;
   fInputHistograms = new QnCorrectionsProfileChannelizedIngress((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       ownerConfiguration->GetEventClassVariablesSet(),ownerConfiguration->GetNoOfChannels(), "s");
+  fInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
   fCalibrationHistograms = new QnCorrectionsProfileChannelized((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       ownerConfiguration->GetEventClassVariablesSet(),ownerConfiguration->GetNoOfChannels(), "s");
+  fCalibrationHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fCalibrationHistograms->CreateProfileHistograms(list,
       ownerConfiguration->GetUsedChannelsMask(), ownerConfiguration->GetChannelsGroups());
   return kTRUE;
@@ -172,12 +226,14 @@ Bool_t QnCorrectionsInputGainEqualization::CreateQAHistograms(TList *list) {
       (const char *) beforeName,
       (const char *) beforeTitle,
       ownerConfiguration->GetEventClassVariablesSet(),ownerConfiguration->GetNoOfChannels());
+  fQAMultiplicityBefore->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fQAMultiplicityBefore->CreateProfileHistograms(list,
       ownerConfiguration->GetUsedChannelsMask(), ownerConfiguration->GetChannelsGroups());
   fQAMultiplicityAfter = new QnCorrectionsProfileChannelized(
       (const char *) afterName,
       (const char *) afterTitle,
       ownerConfiguration->GetEventClassVariablesSet(),ownerConfiguration->GetNoOfChannels());
+  fQAMultiplicityAfter->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fQAMultiplicityAfter->CreateProfileHistograms(list,
       ownerConfiguration->GetUsedChannelsMask(), ownerConfiguration->GetChannelsGroups());
   return kTRUE;
@@ -196,6 +252,7 @@ Bool_t QnCorrectionsInputGainEqualization::CreateNveQAHistograms(TList *list) {
       TString::Format("%s %s", szQANotValidatedHistogramName, fDetectorConfiguration->GetName()).Data(),
       ownerConfiguration->GetEventClassVariablesSet(),
       ownerConfiguration->GetNoOfChannels());
+  fQANotValidatedBin->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fQANotValidatedBin->CreateChannelizedHistogram(list, ownerConfiguration->GetUsedChannelsMask());
   return kTRUE;
 }
@@ -143,6 +143,9 @@ public:
   /// No action for input gain equalization
   virtual void AttachedToFrameworkManager() {}
   virtual Bool_t AttachInput(TList *list);
+  virtual Bool_t StageInput(TList *list);
+  virtual void SwapStagedInput();
+  virtual void DiscardStagedInput();
   virtual void CreateSupportDataStructures();
   virtual Bool_t CreateSupportHistograms(TList *list);
   virtual Bool_t CreateQAHistograms(TList *list);
@@ -164,6 +167,7 @@ private:
   static const char *szQAHistogramName;              ///< the name and title for QA histograms
   static const char *szQANotValidatedHistogramName;  ///< the name and title for bin not validated QA histograms
   QnCorrectionsProfileChannelizedIngress *fInputHistograms; //!<! the histogram with calibration information
+  QnCorrectionsProfileChannelizedIngress *fStagedInputHistograms; //!<! the histogram with the staged new calibration information
   QnCorrectionsProfileChannelized *fCalibrationHistograms; //!<! the histogram for building calibration information
   QnCorrectionsProfileChannelized *fQAMultiplicityBefore;  //!<! the channel multiplicity histogram before gain equalization
   QnCorrectionsProfileChannelized *fQAMultiplicityAfter;   //!<! the channel multiplicity histogram after gain equalization
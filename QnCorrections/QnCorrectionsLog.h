@@ -39,14 +39,18 @@ extern void QnCorrectionsPrintMessageHandler(UInt_t type, const char* message,
                           const char* module, const char* className,
                           const char* function, const char* file, Int_t line);
 extern void QnCorrectionsSetTracingLevel(UInt_t level);
+extern UInt_t nLoggingLevel;
 
 /// Actual way to invoke the logging function. It is
 /// a macro that incorporates the additional information needed
 /// for locating the source code the message was raised.
+/// The message is only built if its level is not masked so
+/// that masked messages do not cost any formatting nor allocation.
 /// \param lvl level of the logging message
 /// \param message meaningful message to print
 #define QnCorrectionsMessage(lvl,message) do { \
-      QnCorrectionsPrintMessageHandler(lvl, message, MODULENAME(), ClassName(), FUNCTIONNAME(), __FILE__, __LINE__);} while(false)
+      if (!(UInt_t(lvl) < nLoggingLevel)) \
+        QnCorrectionsPrintMessageHandler(lvl, message, MODULENAME(), ClassName(), FUNCTIONNAME(), __FILE__, __LINE__);} while(false)
 
 /// User function for an Info message
 #define QnCorrectionsInfo(message)               QnCorrectionsMessage(kInfo, message)
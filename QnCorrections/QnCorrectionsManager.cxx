@@ -34,6 +34,14 @@
 #include <TFile.h>
 #include <TList.h>
 #include <TKey.h>
+#include <TMath.h>
+#include <TROOT.h>
+#include <TVirtualMutex.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "QnCorrectionsManager.h"
 #include "QnCorrectionsLog.h"
 
@@ -54,27 +62,118 @@ const Int_t QnCorrectionsManager::nMaxNoOfDataVariables = 2048;
 const char *QnCorrectionsManager::szCalibrationHistogramsKeyName = "CalibrationHistograms";
 const char *QnCorrectionsManager::szCalibrationQAHistogramsKeyName = "CalibrationQAHistograms";
 const char *QnCorrectionsManager::szCalibrationNveQAHistogramsKeyName = "CalibrationQANveHistograms";
+const char *QnCorrectionsManager::szQnCorrelationsKeyName = "QnCorrelations";
 const char *QnCorrectionsManager::szDummyProcessListName = "dummyprocess";
 const char *QnCorrectionsManager::szAllProcessesListName = "all data";
 
+/// \cond
+/// The staged new calibration histograms list
+struct QnCorrectionsManager::CalibrationStage {
+  std::mutex fMutex;                    ///< serializes the stagings and the swaps
+  std::atomic<bool> fReady;             ///< a staged calibration is waiting to be swapped
+  TList *fList;                         ///< the staged calibration histograms list
+};
+
+/// The detector configurations and their processing threads
+struct QnCorrectionsManager::ProcessingPool {
+  std::vector<QnCorrectionsDetectorConfigurationBase *> fConfigurations; ///< the detector configurations
+  std::vector<std::thread> fThreads;    ///< the processing threads besides the calling one
+  std::mutex fMutex;                    ///< protects the current event processing state
+  std::condition_variable fStateChanged; ///< signals a new phase, the end of a phase or pool termination
+  std::vector<Bool_t> fCorrected;       ///< per configuration, all its correction steps were applied
+  Int_t fNextConfiguration;             ///< the next configuration to take within the current phase
+  Int_t fNoOfRemaining;                 ///< the number of configurations of the current phase still not processed
+  const Float_t *fVariableContainer;    ///< the current event variables bank
+  Bool_t fCollecting;                   ///< the current phase is the data collection one
+  Bool_t fStop;                         ///< the pool is being terminated
+
+  /// Processes the configurations of the current phase until there is none left to take
+  ///
+  /// Each configuration is processed without holding the lock. While
+  /// processing corrections the configuration result is kept.
+  /// \param lock the lock on the pool mutex, held at entry and exit
+  void ProcessPending(std::unique_lock<std::mutex> &lock) {
+    while (fNextConfiguration < Int_t(fConfigurations.size())) {
+      Int_t ixConfiguration = fNextConfiguration++;
+      Bool_t collecting = fCollecting;
+      Bool_t corrected = kFALSE;
+      lock.unlock();
+      if (collecting)
+        fConfigurations[ixConfiguration]->ProcessDataCollection(fVariableContainer);
+      else
+        corrected = fConfigurations[ixConfiguration]->ProcessCorrections(fVariableContainer);
+      lock.lock();
+      if (!collecting) fCorrected[ixConfiguration] = corrected;
+      if (--fNoOfRemaining == 0) fStateChanged.notify_all();
+    }
+  }
+
+  /// Runs a phase over all the configurations and waits for its end
+  ///
+  /// The calling thread takes part in the processing.
+  /// \param lock the lock on the pool mutex, held at entry and exit
+  /// \param collecting kTRUE for the data collection phase, kFALSE for the corrections one
+  void RunPhase(std::unique_lock<std::mutex> &lock, Bool_t collecting) {
+    fCollecting = collecting;
+    fNextConfiguration = 0;
+    fNoOfRemaining = fConfigurations.size();
+    fStateChanged.notify_all();
+    while (fNoOfRemaining != 0) {
+      if (fNextConfiguration < Int_t(fConfigurations.size()))
+        ProcessPending(lock);
+      else
+        fStateChanged.wait(lock);
+    }
+  }
+};
+/// \endcond
+
 /// Default constructor.
 /// The class owns the detectors and will be destroyed with it
 QnCorrectionsManager::QnCorrectionsManager() :
-    TObject(), fDetectorsSet(), fProcessListName(szDummyProcessListName) {
+    TObject(), fHistogramsContext(), fDetectorsSet(), fProcessListName(szDummyProcessListName) {
 
   fDetectorsSet.SetOwner(kTRUE);
+  fQnVectorCorrelationsSet.SetOwner(kTRUE);
+  fQnVectorDifferentialFlowSet.SetOwner(kTRUE);
   fDetectorsIdMap = NULL;
+  fNoOfDetectors = 0;
+  fDetectorsTable = NULL;
+  fUseDenseDataVariablesBank = kFALSE;
+  fNoOfDataVariables = 0;
+  fDataVariablesMap = NULL;
   fDataContainer = NULL;
   fCalibrationHistogramsList = NULL;
+  fCalibrationStage = new CalibrationStage();
+  fCalibrationStage->fReady = false;
+  fCalibrationStage->fList = NULL;
   fSupportHistogramsList = NULL;
   fQAHistogramsList = NULL;
   fNveQAHistogramsList = NULL;
+  fNoOfQnVectorCorrelations = 0;
+  fQnVectorCorrelationsTable = NULL;
+  fNoOfQnVectorDifferentialFlow = 0;
+  fQnVectorDifferentialFlowTable = NULL;
+  fQnCorrelationsList = NULL;
   fQnVectorTree = NULL;
   fQnVectorList = NULL;
   fFillOutputHistograms = kFALSE;
   fFillQAHistograms = kFALSE;
   fFillNveQAHistograms = kFALSE;
   fFillQnVectorTree = kFALSE;
+  fProvideIntermediateQnVectors = kTRUE;
+  fEventClassBucketingSize = 0;
+  fNoOfBucketedEvents = 0;
+  fFillBufferSize = 0;
+  fNoOfSubsamples = 0;
+  fNoOfSubsampledEvents = 0;
+  fSubsampleAssigned = kFALSE;
+  fQuantizedCalibrationTables = kFALSE;
+  fQuantizationComparison = kFALSE;
+  fNoOfIngestionThreads = 1;
+  fNoOfProcessingThreads = 1;
+  fNoOfPreallocatedDataVectors = 0;
+  fProcessingPool = NULL;
   fProcessesNames = NULL;
 }
 
@@ -82,9 +181,27 @@ QnCorrectionsManager::QnCorrectionsManager() :
 /// Deletes the memory taken
 QnCorrectionsManager::~QnCorrectionsManager() {
 
+  if (fProcessingPool != NULL) {
+    {
+      std::lock_guard<std::mutex> lock(fProcessingPool->fMutex);
+      fProcessingPool->fStop = kTRUE;
+    }
+    fProcessingPool->fStateChanged.notify_all();
+    for (UInt_t i = 0; i < fProcessingPool->fThreads.size(); i++) {
+      fProcessingPool->fThreads[i].join();
+    }
+    delete fProcessingPool;
+  }
+
   if (fDetectorsIdMap != NULL) delete [] fDetectorsIdMap;
+  if (fDetectorsTable != NULL) delete [] fDetectorsTable;
+  if (fQnVectorCorrelationsTable != NULL) delete [] fQnVectorCorrelationsTable;
+  if (fQnVectorDifferentialFlowTable != NULL) delete [] fQnVectorDifferentialFlowTable;
+  if (fDataVariablesMap != NULL) delete [] fDataVariablesMap;
   if (fDataContainer != NULL) delete [] fDataContainer;
   if (fCalibrationHistogramsList != NULL) delete fCalibrationHistogramsList;
+  if (fCalibrationStage->fList != NULL) delete fCalibrationStage->fList;
+  delete fCalibrationStage;
   if (fProcessesNames != NULL) delete fProcessesNames;
 }
 
@@ -112,7 +229,125 @@ void QnCorrectionsManager::SetCalibrationHistogramsList(TFile *calibrationFile)
   }
 }
 
+/// Stages a new calibration for replacing the one in use without reinitializing the framework
+///
+/// The calibration histograms list for the current process is taken from
+/// the passed file and the correction steps being applied build from it
+/// their new input information, which is kept aside until it is swapped
+/// with SwapCalibrationInputs. The support, QA and correlations histograms,
+/// as well as the Qn vectors list, are not affected. The correction steps
+/// not being applied keep their state, changing the corrections being
+/// applied requires going through SetCalibrationHistogramsList.
+///
+/// It can be invoked from a thread other than the processing one while
+/// events are being processed provided ROOT thread safety has been enabled,
+/// but not concurrently with a change of the current process.
+/// \param calibrationFile the file with the new calibration histograms
+/// \return kTRUE if the new calibration is staged
+Bool_t QnCorrectionsManager::StageCalibrationHistogramsList(TFile *calibrationFile) {
+  std::lock_guard<std::mutex> lock(fCalibrationStage->fMutex);
+
+  if (fSupportHistogramsList == NULL || fProcessListName.EqualTo(szDummyProcessListName)) {
+    QnCorrectionsError("The framework should be initialized and the process set before staging a new calibration");
+    return kFALSE;
+  }
+  if (fCalibrationStage->fReady) {
+    QnCorrectionsError("A previously staged calibration has not been swapped yet");
+    return kFALSE;
+  }
+  if (calibrationFile == NULL) return kFALSE;
+  TKey *key = (TKey *) calibrationFile->GetListOfKeys()->FindObject(szCalibrationHistogramsKeyName);
+  if (key == NULL) {
+    QnCorrectionsError(Form("No calibration histograms list in file %s", calibrationFile->GetName()));
+    return kFALSE;
+  }
 
+  /* the read list is already a new object owned by us, no need to clone it */
+  TList *list = (TList *) key->ReadObj();
+  list->SetOwner(kTRUE);
+  TList *processList = (TList *) list->FindObject((const char *) fProcessListName);
+  if (processList == NULL) {
+    QnCorrectionsError(Form("No process list %s in file %s", fProcessListName.Data(), calibrationFile->GetName()));
+    delete list;
+    return kFALSE;
+  }
+
+  Bool_t staged = kTRUE;
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    staged = ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->StageCorrectionInputs(processList) && staged;
+  }
+  if (!staged) {
+    QnCorrectionsError(Form("The calibration in file %s does not cover the corrections being applied. Not staged",
+        calibrationFile->GetName()));
+    for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+      ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->DiscardStagedCorrectionInputs();
+    }
+    delete list;
+    return kFALSE;
+  }
+
+  QnCorrectionsInfo(Form("Staged calibration list %s from file %s", list->GetName(), calibrationFile->GetName()));
+  fCalibrationStage->fList = list;
+  fCalibrationStage->fReady.store(true, std::memory_order_release);
+  return kTRUE;
+}
+
+/// Swaps the input information of the correction steps with the staged one
+///
+/// Should be invoked between events from the processing thread. If no new
+/// calibration is staged it just returns so it can be invoked before
+/// each event. Once swapped, the previous calibration is released.
+/// \return kTRUE if a staged calibration has been swapped
+Bool_t QnCorrectionsManager::SwapCalibrationInputs() {
+  if (!fCalibrationStage->fReady.load(std::memory_order_acquire)) return kFALSE;
+
+  std::lock_guard<std::mutex> lock(fCalibrationStage->fMutex);
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->SwapStagedCorrectionInputs();
+  }
+  if (fCalibrationHistogramsList != NULL) delete fCalibrationHistogramsList;
+  fCalibrationHistogramsList = fCalibrationStage->fList;
+  fCalibrationStage->fList = NULL;
+  fCalibrationStage->fReady.store(false, std::memory_order_release);
+  QnCorrectionsInfo(Form("Swapped to calibration list %s", fCalibrationHistogramsList->GetName()));
+  return kTRUE;
+}
+
+/// Gets whether a staged calibration is waiting to be swapped
+/// \return kTRUE if a new calibration is staged
+Bool_t QnCorrectionsManager::IsCalibrationStaged() const {
+  return fCalibrationStage->fReady.load(std::memory_order_acquire);
+}
+
+
+
+/// Adds a new set of Qn vector correlations
+///
+/// Checks for an already added set of correlations with the same name.
+/// If so, gives a runtime error to inform of misuse.
+/// \param correlations the new Qn vector correlations to incorporate to the framework
+void QnCorrectionsManager::AddQnVectorCorrelations(QnCorrectionsQnVectorCorrelations *correlations) {
+  if (fQnVectorCorrelationsSet.FindObject(correlations->GetName())) {
+    QnCorrectionsFatal(Form("You are trying to add twice %s Qn vector correlations. FIX IT, PLEASE.",
+        correlations->GetName()));
+    return;
+  }
+  fQnVectorCorrelationsSet.Add(correlations);
+}
+
+/// Adds a new set of differential flow correlations
+///
+/// Checks for an already added set of differential flow correlations with
+/// the same name. If so, gives a runtime error to inform of misuse.
+/// \param differentialFlow the new differential flow correlations to incorporate to the framework
+void QnCorrectionsManager::AddQnVectorDifferentialFlow(QnCorrectionsQnVectorDifferentialFlow *differentialFlow) {
+  if (fQnVectorDifferentialFlowSet.FindObject(differentialFlow->GetName())) {
+    QnCorrectionsFatal(Form("You are trying to add twice %s differential flow correlations. FIX IT, PLEASE.",
+        differentialFlow->GetName()));
+    return;
+  }
+  fQnVectorDifferentialFlowSet.Add(differentialFlow);
+}
 
 /// Adds a new detector
 /// Checks for an already added detector and for a detector id
@@ -225,6 +460,42 @@ const QnCorrectionsQnVector *QnCorrectionsManager::GetDetectorQnVector(
   return theQnVector;
 }
 
+/// Gets a pointer to the data variables bank
+///
+/// Not available with the dense data variables bank, whose positions
+/// do not correspond to the external variables ids. The variables
+/// values should then be set through SetDataVariable.
+/// \return the pointer to the data container, NULL with the dense data variables bank
+Float_t *QnCorrectionsManager::GetDataContainer() {
+  if (fUseDenseDataVariablesBank) {
+    QnCorrectionsFatal(Form("The data container is not accessible with the dense data variables bank. "
+        "Use SetDataVariable instead. FIX IT, PLEASE."));
+    return NULL;
+  }
+  return fDataContainer;
+}
+
+/// Checks whether a framework setting can still be changed
+///
+/// The settings consumed at framework initialization are rejected
+/// once it is initialized.
+/// \param setting the setting description for the report
+/// \return kTRUE if the framework is not initialized yet
+Bool_t QnCorrectionsManager::IsSettingAccepted(const char *setting) const {
+  if (fSupportHistogramsList != NULL) {
+    QnCorrectionsError(Form("%s should be set before initializing the framework. The setting is ignored. FIX IT, PLEASE.", setting));
+    return kFALSE;
+  }
+  return kTRUE;
+}
+
+/// Reports an access to a variable out of the data variables bank range
+/// \param varId the external variable id
+void QnCorrectionsManager::ReportDataVariableOutOfRange(Int_t varId) const {
+  QnCorrectionsFatal(Form("Data variable id %d out of the supported range [0, %d). FIX IT, PLEASE.",
+      varId, nMaxNoOfDataVariables));
+}
+
 /// Initializes the correction framework
 /// Basically the different list containing framework objects are built.
 /// Calibration histograms are on a per process basis while QA histograms
@@ -232,7 +503,41 @@ const QnCorrectionsQnVector *QnCorrectionsManager::GetDetectorQnVector(
 void QnCorrectionsManager::InitializeQnCorrectionsFramework() {
 
   /* the data bank */
-  fDataContainer = new Float_t[nMaxNoOfDataVariables];
+  fDataVariablesMap = new Int_t[nMaxNoOfDataVariables];
+  if (fUseDenseDataVariablesBank) {
+    /* remap the variables referenced by the framework to consecutive ids, an extra discard slot for the rest */
+    QnCorrectionsCoreVariablesBank bank;
+    for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+      ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->RegisterDataVariables(bank);
+    }
+    for (Int_t ixCorrelations = 0; ixCorrelations < fQnVectorCorrelationsSet.GetEntries(); ixCorrelations++) {
+      ((QnCorrectionsQnVectorCorrelations *) fQnVectorCorrelationsSet.At(ixCorrelations))->RegisterDataVariables(bank);
+    }
+    for (Int_t ixDifferentialFlow = 0; ixDifferentialFlow < fQnVectorDifferentialFlowSet.GetEntries(); ixDifferentialFlow++) {
+      ((QnCorrectionsQnVectorDifferentialFlow *) fQnVectorDifferentialFlowSet.At(ixDifferentialFlow))->RegisterDataVariables(bank);
+    }
+    fNoOfDataVariables = bank.Remap(nMaxNoOfDataVariables, fDataVariablesMap) + 1;
+    QnCorrectionsInfo(Form("Dense data variables bank with %d referenced variables", fNoOfDataVariables - 1));
+  }
+  else {
+    for (Int_t varId = 0; varId < nMaxNoOfDataVariables; varId++) {
+      fDataVariablesMap[varId] = varId;
+    }
+    fNoOfDataVariables = nMaxNoOfDataVariables;
+  }
+  fDataContainer = new Float_t[fNoOfDataVariables];
+
+  /* the histograms fills mode */
+  fHistogramsContext.SetEventClassBucketing(0 < fEventClassBucketingSize);
+  fNoOfBucketedEvents = 0;
+  fHistogramsContext.SetDefaultFillBufferSize(fFillBufferSize);
+  fHistogramsContext.SetDirtyBinsTracking(fCheckpoint.IsEnabled());
+  fHistogramsContext.SetNoOfSubsamples(fNoOfSubsamples);
+  fHistogramsContext.SetCurrentSubsample(0);
+  fNoOfSubsampledEvents = 0;
+  fHistogramsContext.SetQuantizedTables(fQuantizedCalibrationTables, fQuantizationComparison);
+  fHistogramsContext.SetNoOfIngestionThreads(fNoOfIngestionThreads);
+  fHistogramsContext.SetPreallocatedFills(0 < fNoOfPreallocatedDataVectors);
 
   /* let's build the detectors map */
   fDetectorsIdMap = new QnCorrectionsDetector *[nMaxNoOfDetectors];
@@ -243,7 +548,7 @@ void QnCorrectionsManager::InitializeQnCorrectionsFramework() {
   }
 
 
-  /* create the support data structures */
+  /* create the support data structures, the detector configurations lay out their per event hot data */
   for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
     ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->CreateSupportDataStructures();
   }
@@ -351,6 +656,26 @@ void QnCorrectionsManager::InitializeQnCorrectionsFramework() {
     }
   }
 
+  /* the Qn vector and differential flow correlations histograms list if needed */
+  if ((fQnVectorCorrelationsSet.GetEntries() != 0) || (fQnVectorDifferentialFlowSet.GetEntries() != 0)) {
+    fQnCorrelationsList = new TList();
+    fQnCorrelationsList->SetName(szQnCorrelationsKeyName);
+    fQnCorrelationsList->SetOwner(kTRUE);
+    for (Int_t ixCorrelations = 0; ixCorrelations < fQnVectorCorrelationsSet.GetEntries(); ixCorrelations++) {
+      QnCorrectionsQnVectorCorrelations *correlations = (QnCorrectionsQnVectorCorrelations *) fQnVectorCorrelationsSet.At(ixCorrelations);
+      if (correlations->AttachDetectorConfigurations(this)) {
+        correlations->CreateCorrelationsHistograms(fQnCorrelationsList, &fHistogramsContext);
+      }
+    }
+    for (Int_t ixDifferentialFlow = 0; ixDifferentialFlow < fQnVectorDifferentialFlowSet.GetEntries(); ixDifferentialFlow++) {
+      QnCorrectionsQnVectorDifferentialFlow *differentialFlow =
+          (QnCorrectionsQnVectorDifferentialFlow *) fQnVectorDifferentialFlowSet.At(ixDifferentialFlow);
+      if (differentialFlow->AttachDetectorConfigurations(this)) {
+        differentialFlow->CreateDifferentialFlowHistograms(fQnCorrelationsList, &fHistogramsContext);
+      }
+    }
+  }
+
   /* build the Qn vectors list */
   fQnVectorList = new TList();
   /* the list does not own the Qn vectors */
@@ -359,6 +684,117 @@ void QnCorrectionsManager::InitializeQnCorrectionsFramework() {
   for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
     ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->IncludeQnVectors(fQnVectorList);
   }
+
+  /* freeze the framework topology into the per event dispatch tables */
+  fNoOfDetectors = fDetectorsSet.GetEntries();
+  fDetectorsTable = new QnCorrectionsDetector *[fNoOfDetectors];
+  for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+    fDetectorsTable[ixDetector] = (QnCorrectionsDetector *) fDetectorsSet.At(ixDetector);
+    fDetectorsTable[ixDetector]->BuildDispatchTables();
+  }
+  fNoOfQnVectorCorrelations = fQnVectorCorrelationsSet.GetEntries();
+  fQnVectorCorrelationsTable = new QnCorrectionsQnVectorCorrelations *[fNoOfQnVectorCorrelations];
+  for (Int_t ixCorrelations = 0; ixCorrelations < fNoOfQnVectorCorrelations; ixCorrelations++) {
+    fQnVectorCorrelationsTable[ixCorrelations] = (QnCorrectionsQnVectorCorrelations *) fQnVectorCorrelationsSet.At(ixCorrelations);
+  }
+  fNoOfQnVectorDifferentialFlow = fQnVectorDifferentialFlowSet.GetEntries();
+  fQnVectorDifferentialFlowTable = new QnCorrectionsQnVectorDifferentialFlow *[fNoOfQnVectorDifferentialFlow];
+  for (Int_t ixDifferentialFlow = 0; ixDifferentialFlow < fNoOfQnVectorDifferentialFlow; ixDifferentialFlow++) {
+    fQnVectorDifferentialFlowTable[ixDifferentialFlow] =
+        (QnCorrectionsQnVectorDifferentialFlow *) fQnVectorDifferentialFlowSet.At(ixDifferentialFlow);
+  }
+
+  /* the per event storage, once the variables recorded with the data vectors are known */
+  if (0 < fNoOfPreallocatedDataVectors) {
+    for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+      fDetectorsTable[ixDetector]->PreallocateDataVectorBanks(fNoOfPreallocatedDataVectors);
+    }
+  }
+
+  /* and the pool for the concurrent processing of the detector configurations */
+  StartProcessingPool();
+}
+
+/// Starts the detector configurations processing pool
+///
+/// Only if more than one processing thread was requested and there
+/// are several detector configurations. ROOT thread safety should
+/// have been enabled by the caller, otherwise the detector
+/// configurations are processed serially.
+void QnCorrectionsManager::StartProcessingPool() {
+  if (fNoOfProcessingThreads < 2) return;
+  if (gGlobalMutex == NULL && !ROOT::IsImplicitMTEnabled()) {
+    QnCorrectionsError(Form("%d processing threads requested but ROOT thread safety is not enabled. "
+        "The detector configurations will be processed serially. "
+        "Call ROOT::EnableThreadSafety() before initializing the framework. FIX IT, PLEASE.",
+        fNoOfProcessingThreads));
+    return;
+  }
+
+  ProcessingPool *pool = new ProcessingPool();
+  for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+    for (Int_t ixConfiguration = 0; ixConfiguration < fDetectorsTable[ixDetector]->GetNoOfDispatchedConfigurations(); ixConfiguration++) {
+      pool->fConfigurations.push_back(fDetectorsTable[ixDetector]->GetDispatchedConfiguration(ixConfiguration));
+    }
+  }
+  Int_t nNoOfConfigurations = pool->fConfigurations.size();
+  if (nNoOfConfigurations < 2) {
+    delete pool;
+    return;
+  }
+  QnCorrectionsInfo(Form("Processing %d detector configurations on %d threads",
+      nNoOfConfigurations, fNoOfProcessingThreads));
+
+  pool->fCorrected.assign(nNoOfConfigurations, kFALSE);
+  pool->fNextConfiguration = nNoOfConfigurations;
+  pool->fNoOfRemaining = 0;
+  pool->fVariableContainer = NULL;
+  pool->fCollecting = kFALSE;
+  pool->fStop = kFALSE;
+  fProcessingPool = pool;
+  for (Int_t i = 1; i < fNoOfProcessingThreads; i++) {
+    pool->fThreads.push_back(std::thread(&QnCorrectionsManager::RunProcessingWorker, this));
+  }
+}
+
+/// Processes the current event detector configurations on the processing pool
+///
+/// The Qn vectors of the sets of systematic variations are built first.
+/// Then, as in the serial processing, the corrections of all detector
+/// configurations are processed and, once all of them are done, their
+/// data collection. Within each phase the detector configurations are
+/// independent: their correction steps only read the reference detector
+/// configurations Qn vectors while collecting data, when all of them are
+/// already corrected. The calling thread takes part in the processing.
+/// \return kTRUE if every detector configuration applied all its correction steps
+Bool_t QnCorrectionsManager::ProcessConfigurationsConcurrently() {
+  for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+    fDetectorsTable[ixDetector]->BuildVariationsQnVectors();
+  }
+
+  std::unique_lock<std::mutex> lock(fProcessingPool->fMutex);
+  fProcessingPool->fVariableContainer = fDataContainer;
+  fProcessingPool->RunPhase(lock, kFALSE);
+  Bool_t corrected = kTRUE;
+  for (UInt_t ixConfiguration = 0; ixConfiguration < fProcessingPool->fCorrected.size(); ixConfiguration++) {
+    corrected = fProcessingPool->fCorrected[ixConfiguration] && corrected;
+  }
+  fProcessingPool->RunPhase(lock, kTRUE);
+  return corrected;
+}
+
+/// The processing threads loop
+///
+/// Processes the detector configurations of the current phase
+/// until the pool is terminated.
+void QnCorrectionsManager::RunProcessingWorker() {
+  std::unique_lock<std::mutex> lock(fProcessingPool->fMutex);
+  while (!fProcessingPool->fStop) {
+    if (fProcessingPool->fNextConfiguration < Int_t(fProcessingPool->fConfigurations.size()))
+      fProcessingPool->ProcessPending(lock);
+    else
+      fProcessingPool->fStateChanged.wait(lock);
+  }
 }
 
 /// Set the name of the list that should be considered as assigned to the current process
@@ -746,10 +1182,86 @@ void QnCorrectionsManager::PrintFrameworkConfiguration() const {
 /// Produce the all data lists that collect data from all concurrent processes.
 void QnCorrectionsManager::FinalizeQnCorrectionsFramework() {
 
+  /* perform the histograms fills still pending */
+  FlushPendingFills();
+
+  /* report the data vectors which did not fit in the preallocated banks */
+  for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+    if (0 < fDetectorsTable[ixDetector]->GetNoOfDroppedDataVectors()) {
+      QnCorrectionsWarning(Form("Detector %s dropped %lld data vectors exceeding the preallocated data vector banks of %d",
+          fDetectorsTable[ixDetector]->GetName(),
+          fDetectorsTable[ixDetector]->GetNoOfDroppedDataVectors(),
+          fNoOfPreallocatedDataVectors));
+    }
+  }
+
   TList *processList = (TList *) fSupportHistogramsList->FindObject((const char *)fProcessListName);
   fSupportHistogramsList->Add(processList->Clone(szAllProcessesListName));
 }
 
+/// Performs the histograms fills still pending
+///
+/// Either bucketed by event class or kept in fill buffers.
+void QnCorrectionsManager::FlushPendingFills() {
+  fHistogramsContext.FlushEventClassBuckets();
+  fNoOfBucketedEvents = 0;
+  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
+    ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->FlushFillBuffers();
+  }
+  fHistogramsContext.FlushFillBuffers();
+}
 
+/// Builds the list of histograms lists covered by the checkpoints
+///
+/// The support, QA, non validated entries QA and Qn vector correlations
+/// histograms lists that are in use. The returned list does not own its lists and
+/// should be deleted by the caller.
+/// \return the list of histograms lists
+TList *QnCorrectionsManager::GetCheckpointLists() const {
+  TList *lists = new TList();
+  lists->SetOwner(kFALSE);
+  if (fSupportHistogramsList != NULL) lists->Add(fSupportHistogramsList);
+  if (fQAHistogramsList != NULL) lists->Add(fQAHistogramsList);
+  if (fNveQAHistogramsList != NULL) lists->Add(fNveQAHistogramsList);
+  if (fQnCorrelationsList != NULL) lists->Add(fQnCorrelationsList);
+  return lists;
+}
+
+/// Checkpoints the framework histograms
+///
+/// The pending histograms fills are performed and the bins changed
+/// since the previous checkpoint are appended to the checkpoint file
+/// together with the passed event cursor. To be called by the driver
+/// between events, periodically.
+/// \param eventCursor the driver position in its input events after the last processed one
+/// \return kTRUE if the checkpoint was properly stored
+Bool_t QnCorrectionsManager::Checkpoint(Long64_t eventCursor) {
+  if (!fCheckpoint.IsEnabled()) {
+    QnCorrectionsFatal(Form("Checkpoint requested without a checkpoint file. FIX IT, PLEASE."));
+    return kFALSE;
+  }
+  FlushPendingFills();
 
+  TList *lists = GetCheckpointLists();
+  Bool_t stored = fCheckpoint.Store(lists, fHistogramsContext, eventCursor);
+  delete lists;
+  return stored;
+}
 
+/// Resumes the framework histograms from the checkpoint file
+///
+/// To be called after initializing the framework, with the same
+/// configuration and current process name than the checkpointed job,
+/// and before processing any event. The driver should skip the input
+/// events up to the returned event cursor.
+/// \return the event cursor of the last checkpoint, -1 if there were no checkpoints
+Long64_t QnCorrectionsManager::ResumeFromCheckpoint() {
+  if (!fCheckpoint.IsEnabled()) {
+    QnCorrectionsFatal(Form("Resume requested without a checkpoint file. FIX IT, PLEASE."));
+    return -1;
+  }
+  TList *lists = GetCheckpointLists();
+  Long64_t eventCursor = fCheckpoint.Restore(lists);
+  delete lists;
+  return eventCursor;
+}
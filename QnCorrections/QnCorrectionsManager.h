@@ -26,7 +26,10 @@
 /// the analysis phase.
 ///
 /// To improve performance a mapping between internal detector address
-/// and external detector id is maintained.
+/// and external detector id is maintained. For the same reason, at
+/// framework initialization the detectors, their configurations and
+/// their correction steps are frozen in dispatch tables, plain arrays
+/// of typed pointers the per event code walks linearly.
 ///
 /// When the framework is in the calibration phase there are no complete
 /// calibration information available to fully implement the desired
@@ -47,6 +50,27 @@
 /// different running instances. At merging time, only the contributions
 /// from instances of the same process must be merged.
 ///
+/// Optionally, the correlations of the corrected Qn vectors of pairs
+/// or triplets of detector configurations are accumulated versus the
+/// event classes in their own histograms list, so that the standard
+/// resolution studies do not need the Qn vectors of each event.
+///
+/// The data variables bank is, by default, addressed by the external
+/// variable ids. Optionally, the variables the framework actually reads
+/// can be remapped at initialization into a dense bank, then, the
+/// external code should only access the bank through the data
+/// variables setter and getter.
+///
+/// Long calibration jobs can periodically checkpoint the framework
+/// histograms, together with the event cursor supplied by the driver,
+/// into a local file and, if interrupted, resume from the last checkpoint
+/// in a freshly initialized framework. Only the bins changed since the
+/// previous checkpoint are written each time.
+///
+/// Optionally, the detector configurations of an event are processed
+/// concurrently on a small pool of threads, first their corrections and,
+/// once all of them are corrected, their data collection.
+///
 /// \author Jaap Onderwaater <jacobus.onderwaater@cern.ch>, GSI
 /// \author Ilya Selyuzhenkov <ilya.selyuzhenkov@gmail.com>, GSI
 /// \author Víctor González <victor.gonzalez@cern.ch>, UCM
@@ -56,7 +80,11 @@
 #include <TObject.h>
 #include <TList.h>
 #include <TTree.h>
+#include "QnCorrectionsHistogramBase.h"
 #include "QnCorrectionsDetector.h"
+#include "QnCorrectionsCheckpoint.h"
+#include "QnCorrectionsQnVectorCorrelations.h"
+#include "QnCorrectionsQnVectorDifferentialFlow.h"
 
 class QnCorrectionsManager : public TObject {
 public:
@@ -68,6 +96,9 @@ public:
   void SetListOfProcessesNames(TObjArray *names) { fProcessesNames = names; }
   void SetCurrentProcessListName(const char *name);
   void SetCalibrationHistogramsList(TFile *calibrationFile);
+  Bool_t StageCalibrationHistogramsList(TFile *calibrationFile);
+  Bool_t SwapCalibrationInputs();
+  Bool_t IsCalibrationStaged() const;
   /// Enables disables the filling of histograms for building correction parameters
   /// \param enable kTRUE for enabling histograms filling
   void SetShouldFillOutputHistograms(Bool_t enable = kTRUE) { fFillOutputHistograms = enable; }
@@ -80,17 +111,131 @@ public:
   /// Enables disables the output of Qn vector on a TTree structure
   /// \param enable kTRUE for enabling Qn vector output into a TTree
   void SetShouldFillQnVectorTree(Bool_t enable = kTRUE) { fFillQnVectorTree = enable; }
+  /// Enables disables providing the intermediate correction steps Qn vectors
+  ///
+  /// When disabled only the fully corrected and the plain Qn vectors are
+  /// included in the Qn vectors list and the correction steps do not keep
+  /// a snapshot of their partially corrected Qn vectors unless needed internally.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param enable kTRUE for including the intermediate Qn vectors in the Qn vectors list
+  void SetShouldProvideIntermediateQnVectors(Bool_t enable = kTRUE)
+  { if (IsSettingAccepted("Intermediate Qn vectors")) fProvideIntermediateQnVectors = enable; }
+  /// Sets the number of events whose histograms fills are bucketed by event class
+  ///
+  /// The histograms fills of each batch of events are deferred and performed
+  /// grouped by event class bin at the end of the batch. The fills of each
+  /// bin are replayed in their arrival order so the resulting histograms
+  /// bin contents are identical to the ones of immediate fills.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param nNoOfEvents the number of events per batch, zero for immediate fills
+  void SetEventClassBucketing(Int_t nNoOfEvents)
+  { if (IsSettingAccepted("Event class bucketing")) fEventClassBucketingSize = nNoOfEvents; }
+  /// Sets the size of the histograms fill buffers
+  ///
+  /// The histograms fills are kept in a buffer of the given size per
+  /// histogram which, when full, is flushed sorted and coalesced by
+  /// bin. The bins contents may differ from the ones of immediate
+  /// fills by rounding. Takes precedence over event class bucketing.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param size the number of fills kept per histogram, zero for immediate fills
+  void SetFillBufferSize(Int_t size)
+  { if (IsSettingAccepted("Fill buffer size")) fFillBufferSize = size; }
+  /// Sets the number of subsamples for the statistical uncertainties
+  ///
+  /// Each profile histogram is accompanied by a subsamples histogram
+  /// with an additional axis for the subsample each event is assigned to.
+  /// Events are assigned round robin unless their id is passed with
+  /// SetSubsampleEventId before processing them.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param nNoOfSubsamples the number of subsamples, zero for no subsampling
+  void SetNoOfSubsamples(Int_t nNoOfSubsamples)
+  { if (IsSettingAccepted("Number of subsamples")) fNoOfSubsamples = nNoOfSubsamples; }
+  /// Enables disables the quantized calibration tables
+  ///
+  /// Once attached, the gain equalization, recentering and alignment
+  /// calibration inputs are served from compact tables of half precision
+  /// floats with a bit packed bins validity mask. In comparison mode
+  /// the deviation of each table from the full precision calibration
+  /// is reported at attach time.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param enable kTRUE for serving the calibration inputs from quantized tables
+  /// \param compare kTRUE for reporting the quantization deviations
+  void SetQuantizedCalibrationTables(Bool_t enable = kTRUE, Bool_t compare = kFALSE)
+  { if (IsSettingAccepted("Quantized calibration tables")) { fQuantizedCalibrationTables = enable; fQuantizationComparison = compare; } }
+  /// Sets the number of threads for ingesting the calibration histograms
+  ///
+  /// The division of the attached calibration profiles values by
+  /// their entries is split among the given number of threads.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param nNoOfThreads the maximum number of threads, one for no multithreading
+  void SetNoOfCalibrationIngestionThreads(Int_t nNoOfThreads)
+  { if (IsSettingAccepted("Number of calibration ingestion threads")) fNoOfIngestionThreads = nNoOfThreads; }
+  /// Sets the number of threads for processing the detector configurations of each event
+  ///
+  /// The corrections of the detector configurations are processed
+  /// concurrently and, once all of them are done, their data collection.
+  /// The calling thread is one of them. ROOT thread safety, i.e.
+  /// ROOT::EnableThreadSafety, is a caller precondition which the
+  /// framework does not change, without it the processing is serial.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param nNoOfThreads the number of threads, one for serial processing
+  void SetNoOfProcessingThreads(Int_t nNoOfThreads)
+  { if (IsSettingAccepted("Number of processing threads")) fNoOfProcessingThreads = nNoOfThreads; }
+  /// Sets the per event storage as preallocated for an allocation free events loop
+  ///
+  /// The data vector banks are preallocated for the passed number
+  /// of data vectors and bounded to it, the data vectors beyond
+  /// the capacity are dropped and reported at finalization. The
+  /// storage of the sparse, non validated entries QA, histograms
+  /// is preallocated for all their bins.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param nNoOfDataVectors the capacity of each data vector bank, zero for growing banks
+  void SetPreallocatedEventStorage(Int_t nNoOfDataVectors)
+  { if (IsSettingAccepted("Preallocated event storage")) fNoOfPreallocatedDataVectors = nNoOfDataVectors; }
+  /// Sets the file for checkpointing the framework histograms
+  ///
+  /// Enables the tracking of the histograms bins changed between
+  /// checkpoints. Rejected, with an error, once the framework is initialized.
+  /// \param fileName the name of the local checkpoint file
+  void SetCheckpointFileName(const char *fileName)
+  { if (IsSettingAccepted("Checkpoint file name")) fCheckpoint.SetFileName(fileName); }
+  /// Enables disables the dense data variables bank
+  ///
+  /// At framework initialization the variables ids referenced by the
+  /// cuts, the event class variables and the QA settings are remapped
+  /// to consecutive ids in a dense data variables bank. The external
+  /// code should then set the variables values through SetDataVariable,
+  /// the values of variables not referenced by the framework are not kept,
+  /// and the data container is no longer accessible.
+  ///
+  /// The remapping rewrites in place the variables ids of the cuts and
+  /// event class variables objects passed to the framework, which are
+  /// owned by the user, so after initialization they carry the dense
+  /// ids and should not be shared with other code nor frameworks.
+  /// Rejected, with an error, once the framework is initialized.
+  /// \param enable kTRUE for using a dense data variables bank
+  void SetShouldUseDenseDataVariablesBank(Bool_t enable = kTRUE)
+  { if (IsSettingAccepted("Dense data variables bank")) fUseDenseDataVariablesBank = enable; }
 
   void AddDetector(QnCorrectionsDetector *detector);
+  void AddQnVectorCorrelations(QnCorrectionsQnVectorCorrelations *correlations);
+  void AddQnVectorDifferentialFlow(QnCorrectionsQnVectorDifferentialFlow *differentialFlow);
 
   QnCorrectionsDetector *FindDetector(const char *name) const;
   QnCorrectionsDetector *FindDetector(Int_t id) const;
   QnCorrectionsDetectorConfigurationBase *FindDetectorConfiguration(const char *name) const;
 
 
-  /// Gets a pointer to the data variables bank
-  /// \return the pointer to the data container
-  Float_t *GetDataContainer() { return fDataContainer; }
+  Float_t *GetDataContainer();
+  void SetDataVariable(Int_t varId, Float_t value);
+  Float_t GetDataVariable(Int_t varId) const;
+  Int_t GetDataVariableIndex(Int_t varId) const;
+  /// Gets the number of variables in the data variables bank
+  /// \return the data container size
+  Int_t GetNoOfDataVariables() const { return fNoOfDataVariables; }
+  /// Gets the histograms context the framework histograms are created with
+  /// \return the pointer to the histograms context
+  QnCorrectionsHistogramsContext *GetHistogramsContext() { return &fHistogramsContext; }
 
   /// Get whether the output histograms should be filled
   /// \return kTRUE if the output histograms should be filled
@@ -104,6 +249,11 @@ public:
   /// Get whether the Qn vector tree should be populated
   /// \return kTRUE if the Qn vector should be written into a TTree
   Bool_t GetShouldFillQnVectorTree() const { return fFillQnVectorTree; }
+  /// Get whether the intermediate correction steps Qn vectors should be provided
+  ///
+  /// They are always provided if the Qn vector tree has to be populated
+  /// \return kTRUE if the intermediate Qn vectors should be included in the Qn vectors list
+  Bool_t GetShouldProvideIntermediateQnVectors() const { return fProvideIntermediateQnVectors || fFillQnVectorTree; }
   /// Gets the output histograms list
   /// \return the list of histograms for building correction parameters
   TList *GetOutputHistogramsList() const { return fSupportHistogramsList; }
@@ -113,6 +263,9 @@ public:
   /// Gets the non validated entries QA histograms list
   /// \return the list of QA histograms
   TList *GetNveQAHistogramsList() const { return fNveQAHistogramsList; }
+  /// Gets the Qn vector correlations histograms list
+  /// \return the list of Qn vector correlations histograms, NULL if no correlations were requested
+  TList *GetQnCorrelationsList() const { return fQnCorrelationsList; }
   /// Gets the Qn vector tree
   /// \return the tree of histograms for building correction parameters
   TTree *GetQnVectorTree() const { return fQnVectorTree; }
@@ -133,37 +286,88 @@ public:
   /// \return the calibration QA histograms container name
   const char *GetCalibrationNveQAHistogramsContainerName() const
   { return szCalibrationNveQAHistogramsKeyName; }
+  /// Gets the name of the Qn vector correlations histograms container
+  /// \return the Qn vector correlations histograms container name
+  const char *GetQnCorrelationsContainerName() const
+  { return szQnCorrelationsKeyName; }
 
 
   void PrintFrameworkConfiguration() const;
   void InitializeQnCorrectionsFramework();
   Int_t AddDataVector(Int_t detectorId, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1);
   const char *GetAcceptedDataDetectorConfigurationName(Int_t detectorId, Int_t index) const;
+  void SetSubsampleEventId(ULong64_t eventId);
   void ProcessEvent();
   void ClearEvent();
   void FinalizeQnCorrectionsFramework();
+  Bool_t Checkpoint(Long64_t eventCursor);
+  Long64_t ResumeFromCheckpoint();
 
 private:
+  Bool_t IsSettingAccepted(const char *setting) const;
+  void ReportDataVariableOutOfRange(Int_t varId) const;
+  void FlushPendingFills();
+  TList *GetCheckpointLists() const;
+  void StartProcessingPool();
+  Bool_t ProcessConfigurationsConcurrently();
+  void RunProcessingWorker();
+
+  struct CalibrationStage;
+  struct ProcessingPool;
+
   static const Int_t nMaxNoOfDetectors;              ///< the highest detector id currently supported by the framework
   static const Int_t nMaxNoOfDataVariables;          ///< the maximum number of variables currently supported by the framework
   static const char *szCalibrationHistogramsKeyName; ///< the name of the key under which calibration histograms lists are stored
   static const char *szCalibrationQAHistogramsKeyName; ///< the name of the key under which calibration QA histograms lists are stored
   static const char *szCalibrationNveQAHistogramsKeyName; ///< the name of the key under which non validated calibration entries QA histograms lists are stored
+  static const char *szQnCorrelationsKeyName;        ///< the name of the key under which the Qn vector correlations histograms lists are stored
   static const char *szDummyProcessListName;         ///< accepted temporary name before getting the definitive one
   static const char *szAllProcessesListName;         ///< the name of the list that collects data from all concurrent processes
+  QnCorrectionsHistogramsContext fHistogramsContext; //!<! the histograms fill modes, kept alive until the histograms are gone
   TList fDetectorsSet;                  ///< the list of detectors
   QnCorrectionsDetector **fDetectorsIdMap; //!<! map between external detector Id and internal detector
+  Int_t fNoOfDetectors;                 //!<! the number of detectors in the detectors dispatch table
+  /// array, the detectors frozen at framework initialization
+  QnCorrectionsDetector **fDetectorsTable; //!<!
+  Bool_t fUseDenseDataVariablesBank;   ///< kTRUE if the data variables bank should be remapped into a dense one
+  Int_t fNoOfDataVariables;             //!<! the number of variables in the data variables bank
+  /// array, map between external variable id and its position in the data variables bank
+  Int_t *fDataVariablesMap;             //!<!
   Float_t *fDataContainer;              //!<! the data variables bank
   TList *fCalibrationHistogramsList;    ///< the list of the input calibration histograms
+  CalibrationStage *fCalibrationStage;  //!<! the staged new calibration histograms list waiting to be swapped
   TList *fSupportHistogramsList;        //!<! the list of the support histograms
   TList *fQAHistogramsList;             //!<! the list of QA histograms
   TList *fNveQAHistogramsList;          //!<! the list of not validated entries QA histograms
+  TList fQnVectorCorrelationsSet;       ///< the list of Qn vector correlations
+  Int_t fNoOfQnVectorCorrelations;      //!<! the number of Qn vector correlations in the correlations dispatch table
+  /// array, the Qn vector correlations frozen at framework initialization
+  QnCorrectionsQnVectorCorrelations **fQnVectorCorrelationsTable; //!<!
+  TList fQnVectorDifferentialFlowSet;   ///< the list of differential flow correlations
+  Int_t fNoOfQnVectorDifferentialFlow;  //!<! the number of differential flow correlations in its dispatch table
+  /// array, the differential flow correlations frozen at framework initialization
+  QnCorrectionsQnVectorDifferentialFlow **fQnVectorDifferentialFlowTable; //!<!
+  TList *fQnCorrelationsList;           //!<! the list of Qn vector and differential flow correlations histograms
   TTree *fQnVectorTree;                 //!<! the tree to out Qn vectors
   TList *fQnVectorList;                 //!<! list that contains the current event corrected Qn vectors
   Bool_t fFillOutputHistograms;         ///< kTRUE if output histograms for building correction parameters must be filled
   Bool_t fFillQAHistograms;             ///< kTRUE if QA histograms must be filled
   Bool_t fFillNveQAHistograms;          ///< kTRUE if non validated entries QA histograms must be filled
   Bool_t fFillQnVectorTree;             ///< kTRUE if Qn vectors must be written in a TTree structure
+  Bool_t fProvideIntermediateQnVectors; ///< kTRUE if intermediate correction steps Qn vectors must be provided
+  Int_t fEventClassBucketingSize;       ///< number of events per batch of event class bucketed histograms fills
+  Int_t fNoOfBucketedEvents;            //!<! number of events in the current batch of bucketed histograms fills
+  Int_t fFillBufferSize;                ///< number of fills kept in each histogram fill buffer
+  Int_t fNoOfSubsamples;                ///< number of subsamples for the statistical uncertainties
+  Long64_t fNoOfSubsampledEvents;       //!<! number of events assigned round robin to subsamples
+  Bool_t fSubsampleAssigned;            //!<! the current event has been assigned to a subsample by its id
+  Bool_t fQuantizedCalibrationTables;   ///< kTRUE if the calibration inputs are served from quantized tables
+  Bool_t fQuantizationComparison;       ///< kTRUE if the quantization deviations must be reported
+  Int_t fNoOfIngestionThreads;          ///< number of threads for ingesting the calibration histograms
+  Int_t fNoOfProcessingThreads;         ///< number of threads for processing the detector configurations
+  Int_t fNoOfPreallocatedDataVectors;   ///< capacity of the preallocated data vector banks, zero if not preallocated
+  ProcessingPool *fProcessingPool;      //!<! the detector configurations processing threads, NULL if serial
+  QnCorrectionsCheckpoint fCheckpoint;  ///< the incremental checkpoint of the framework histograms
   TString fProcessListName;             ///< the name of the list associated to the current process
   TObjArray *fProcessesNames;           ///< array with the list of processes names
 
@@ -176,7 +380,7 @@ private:
   QnCorrectionsManager& operator= (const QnCorrectionsManager &);
 
 /// \cond CLASSIMP
-  ClassDef(QnCorrectionsManager, 5);
+  ClassDef(QnCorrectionsManager, 18);
 /// \endcond
 };
 
@@ -192,6 +396,39 @@ inline Int_t QnCorrectionsManager::AddDataVector(Int_t detectorId, Double_t phi,
   return fDetectorsIdMap[detectorId]->AddDataVector(fDataContainer, phi, weight, channelId);
 }
 
+/// Sets the value of a variable in the data variables bank
+/// \param varId the external variable id, from zero to nMaxNoOfDataVariables minus one
+/// \param value the variable value
+inline void QnCorrectionsManager::SetDataVariable(Int_t varId, Float_t value) {
+  if ((varId < 0) || (nMaxNoOfDataVariables <= varId)) {
+    ReportDataVariableOutOfRange(varId);
+    return;
+  }
+  fDataContainer[fDataVariablesMap[varId]] = value;
+}
+
+/// Gets the value of a variable from the data variables bank
+/// \param varId the external variable id, from zero to nMaxNoOfDataVariables minus one
+/// \return the variable value
+inline Float_t QnCorrectionsManager::GetDataVariable(Int_t varId) const {
+  if ((varId < 0) || (nMaxNoOfDataVariables <= varId)) {
+    ReportDataVariableOutOfRange(varId);
+    return 0.0;
+  }
+  return fDataContainer[fDataVariablesMap[varId]];
+}
+
+/// Gets the position of a variable within the data variables bank
+/// \param varId the external variable id, from zero to nMaxNoOfDataVariables minus one
+/// \return the variable position in the data container, -1 if out of range
+inline Int_t QnCorrectionsManager::GetDataVariableIndex(Int_t varId) const {
+  if ((varId < 0) || (nMaxNoOfDataVariables <= varId)) {
+    ReportDataVariableOutOfRange(varId);
+    return -1;
+  }
+  return fDataVariablesMap[varId];
+}
+
 /// Gets the name of the detector configuration at index that accepted last data vector
 /// \param detectorId id of the involved detector
 /// \param index the position in the list of accepted data vector configuration
@@ -205,14 +442,44 @@ inline const char *QnCorrectionsManager::GetAcceptedDataDetectorConfigurationNam
 /// The request is transmitted to the different detectors first for applying the different
 /// correction steps and then to collect the correction steps data.
 ///
+/// If event class bucketing is active, the histograms fills of the
+/// current batch of events are performed once the batch is completed.
+///
+/// If several processing threads were requested the detector configurations
+/// are processed concurrently, keeping the corrections and data collection
+/// phases. The Qn vector
+/// correlations and differential flow are always processed afterwards.
+///
 /// Must be called only when the whole data vectors for the event
 /// have been incorporated to the framework.
 inline void QnCorrectionsManager::ProcessEvent() {
-  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-    ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->ProcessCorrections(fDataContainer);
+  if ((0 < fNoOfSubsamples) && !fSubsampleAssigned) {
+    fHistogramsContext.SetCurrentSubsample(fNoOfSubsampledEvents % fNoOfSubsamples);
+    fNoOfSubsampledEvents++;
+  }
+  if (fProcessingPool != NULL) {
+    ProcessConfigurationsConcurrently();
+  }
+  else {
+    for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+      fDetectorsTable[ixDetector]->ProcessCorrections(fDataContainer);
+    }
+    for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+      fDetectorsTable[ixDetector]->ProcessDataCollection(fDataContainer);
+    }
   }
-  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-    ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->ProcessDataCollection(fDataContainer);
+  for (Int_t ixCorrelations = 0; ixCorrelations < fNoOfQnVectorCorrelations; ixCorrelations++) {
+    fQnVectorCorrelationsTable[ixCorrelations]->ProcessCorrelations(fDataContainer);
+  }
+  for (Int_t ixDifferentialFlow = 0; ixDifferentialFlow < fNoOfQnVectorDifferentialFlow; ixDifferentialFlow++) {
+    fQnVectorDifferentialFlowTable[ixDifferentialFlow]->ProcessDifferentialFlow();
+  }
+  if (0 < fEventClassBucketingSize) {
+    fNoOfBucketedEvents++;
+    if (!(fNoOfBucketedEvents < fEventClassBucketingSize)) {
+      fHistogramsContext.FlushEventClassBuckets();
+      fNoOfBucketedEvents = 0;
+    }
   }
 }
 
@@ -222,9 +489,30 @@ inline void QnCorrectionsManager::ProcessEvent() {
 ///
 /// Must be called only at the end of each event to start processing the next one
 inline void QnCorrectionsManager::ClearEvent() {
-  for (Int_t ixDetector = 0; ixDetector < fDetectorsSet.GetEntries(); ixDetector++) {
-    ((QnCorrectionsDetector *) fDetectorsSet.At(ixDetector))->ClearDetector();
+  for (Int_t ixDetector = 0; ixDetector < fNoOfDetectors; ixDetector++) {
+    fDetectorsTable[ixDetector]->ClearDetector();
   }
+  fSubsampleAssigned = kFALSE;
+}
+
+/// Assigns the current event to a subsample by its id
+///
+/// The assignment is a hash of the event id so that the same event
+/// goes to the same subsample whatever the order the events are
+/// processed or the job they are processed in. Only meaningful if
+/// subsampling is enabled. To be called before ProcessEvent.
+/// \param eventId the unique id of the current event
+inline void QnCorrectionsManager::SetSubsampleEventId(ULong64_t eventId) {
+  if (fNoOfSubsamples < 1) return;
+
+  /* mix the bits of the event id */
+  eventId ^= eventId >> 33;
+  eventId *= 0xff51afd7ed558ccdULL;
+  eventId ^= eventId >> 33;
+  eventId *= 0xc4ceb9fe1a85ec53ULL;
+  eventId ^= eventId >> 33;
+  fHistogramsContext.SetCurrentSubsample(eventId % fNoOfSubsamples);
+  fSubsampleAssigned = kTRUE;
 }
 
 #endif // QNCORRECTIONS_MANAGER_H
@@ -0,0 +1,389 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsOutputWriter.cxx
+/// \brief Implementation of the asynchronous writer of the framework output
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <TROOT.h>
+#include <TFile.h>
+#include <TList.h>
+#include <TString.h>
+#include <TVirtualMutex.h>
+
+#include "QnCorrectionsManager.h"
+#include "QnCorrectionsOutputWriter.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond
+/// The outcome of a set of writes shared by the handle copies
+struct QnCorrectionsOutputHandle::Result {
+  /// Creates the outcome of a set of writes
+  ///
+  /// The outcome is created with the reference of the handle which
+  /// will be returned for the writes.
+  /// \param nNoOfTasks the number of writes
+  /// \return the new outcome
+  static Result *New(Int_t nNoOfTasks) {
+    Result *result = new Result();
+    result->fNoOfReferences = 1;
+    result->fNoOfTasks = nNoOfTasks;
+    result->fNoOfDone = 0;
+    result->fNoOfBytes = 0;
+    return result;
+  }
+
+  /// Releases a reference to the outcome
+  ///
+  /// The outcome is deleted with its last reference.
+  void Release() {
+    if (--fNoOfReferences == 0) delete this;
+  }
+
+  std::atomic<Int_t> fNoOfReferences;   ///< the handles and pending write tasks referring to it
+  Int_t fNoOfTasks;                     ///< the number of writes
+  Int_t fNoOfDone;                      ///< the number of completed writes
+  Int_t fNoOfBytes;                     ///< the number of bytes written
+};
+
+/// The background threads pool and the write tasks
+struct QnCorrectionsOutputWriter::Pool {
+  /// A write task
+  struct Task {
+    TDirectory *fDirectory;             ///< the directory where to write
+    const TObject *fObject;             ///< the object to write
+    TString fKeyName;                   ///< the key name
+    Bool_t fOwned;                      ///< the object is a snapshot owned by the writer
+    QnCorrectionsOutputHandle::Result *fResult; ///< the outcome the write contributes to
+  };
+
+  std::mutex fMutex;                    ///< protects the whole pool state
+  std::condition_variable fNewTask;     ///< signals new tasks or pool termination
+  std::condition_variable fTaskDone;    ///< signals completed tasks
+  std::vector<Task> fTasks;             ///< the write tasks slots
+  std::vector<Int_t> fFreeTasks;        ///< the slots of the completed write tasks
+  std::deque<Int_t> fQueue;             ///< the pending write tasks in request order
+  std::set<TFile *> fBusyFiles;         ///< the files being written
+  std::vector<std::thread> fThreads;    ///< the background threads
+  Bool_t fStop;                         ///< the pool is being terminated
+  Int_t fNoOfPending;                   ///< the number of not completed tasks
+};
+/// \endcond
+
+/// Normal constructor
+///
+/// Starts the background threads if ROOT thread safety has been
+/// enabled by the caller. Otherwise the writes will be performed
+/// on the calling thread.
+/// \param nNoOfThreads the number of background threads
+QnCorrectionsOutputWriter::QnCorrectionsOutputWriter(Int_t nNoOfThreads) :
+  fNoOfThreads((nNoOfThreads < 1) ? 1 : nNoOfThreads),
+  fPool(NULL) {
+
+  fPool = new Pool();
+  fPool->fStop = kFALSE;
+  fPool->fNoOfPending = 0;
+  if (gGlobalMutex == NULL && !ROOT::IsImplicitMTEnabled()) {
+    QnCorrectionsError(Form("ROOT thread safety is not enabled. The writes will be performed on the calling thread. "
+        "Call ROOT::EnableThreadSafety() before creating the writer. FIX IT, PLEASE."));
+    fNoOfThreads = 0;
+  }
+  for (Int_t i = 0; i < fNoOfThreads; i++) {
+    fPool->fThreads.push_back(std::thread(&QnCorrectionsOutputWriter::RunWorker, this));
+  }
+}
+
+/// Default destructor
+///
+/// Waits for the pending writes and stops the background threads
+QnCorrectionsOutputWriter::~QnCorrectionsOutputWriter() {
+  WaitAll();
+  {
+    std::lock_guard<std::mutex> lock(fPool->fMutex);
+    fPool->fStop = kTRUE;
+  }
+  fPool->fNewTask.notify_all();
+  for (UInt_t i = 0; i < fPool->fThreads.size(); i++) {
+    fPool->fThreads[i].join();
+  }
+  delete fPool;
+}
+
+/// Incorporates a write task to the pending ones
+///
+/// Reuses the slot of a completed task if any. Should be called with
+/// the pool lock held. Without background threads the write is
+/// performed at once.
+/// \param directory the directory where to write the object
+/// \param object the object to write
+/// \param keyName the key name
+/// \param owned the object is a snapshot owned by the writer
+/// \param result the outcome the write contributes to
+void QnCorrectionsOutputWriter::QueueTask(TDirectory *directory, const TObject *object, const char *keyName, Bool_t owned,
+    QnCorrectionsOutputHandle::Result *result) {
+  if (fNoOfThreads == 0) {
+    result->fNoOfBytes += directory->WriteTObject(object, keyName, "SingleKey");
+    result->fNoOfDone++;
+    if (owned) delete object;
+    return;
+  }
+
+  Int_t taskNo;
+  if (fPool->fFreeTasks.empty()) {
+    taskNo = fPool->fTasks.size();
+    fPool->fTasks.push_back(Pool::Task());
+  }
+  else {
+    taskNo = fPool->fFreeTasks.back();
+    fPool->fFreeTasks.pop_back();
+  }
+  Pool::Task &task = fPool->fTasks[taskNo];
+  task.fDirectory = directory;
+  task.fObject = object;
+  task.fKeyName = keyName;
+  task.fOwned = owned;
+  task.fResult = result;
+  result->fNoOfReferences++;
+  fPool->fQueue.push_back(taskNo);
+  fPool->fNoOfPending++;
+}
+
+/// Requests the write of an object into the passed directory
+///
+/// The object is written in a single key on a background thread.
+/// If a snapshot is requested the object is cloned on the calling
+/// thread so it can continue being updated. Otherwise the object
+/// should not be modified, nor deleted, until the write is completed.
+/// \param directory the directory where to write the object
+/// \param object the object to write
+/// \param keyName the key name, the object name if NULL
+/// \param snapshot kTRUE for writing a snapshot of the current object content
+/// \return the handle of the write
+QnCorrectionsOutputHandle QnCorrectionsOutputWriter::WriteAsync(TDirectory *directory, const TObject *object, const char *keyName, Bool_t snapshot) {
+  if (directory == NULL || object == NULL) {
+    QnCorrectionsFatal(Form("Asynchronous write requested without directory or object. FIX IT, PLEASE."));
+    return QnCorrectionsOutputHandle();
+  }
+
+  QnCorrectionsOutputHandle::Result *result = QnCorrectionsOutputHandle::Result::New(1);
+  {
+    std::lock_guard<std::mutex> lock(fPool->fMutex);
+    QueueTask(directory, (snapshot) ? object->Clone() : object,
+        (keyName != NULL) ? keyName : object->GetName(), snapshot, result);
+  }
+  fPool->fNewTask.notify_one();
+  return QnCorrectionsOutputHandle(this, result);
+}
+
+/// Requests the write of the whole framework output into the passed directory
+///
+/// The output histograms list and, if present, the QA, the non
+/// validated entries QA and the Qn vector correlations histograms lists are written, each in a single
+/// key named after the list. Should be requested once the framework
+/// has been finalized, and the framework manager should not be released
+/// until the writes are completed.
+///
+/// The writes are queued at once so they are performed in order even
+/// if other threads are requesting writes concurrently.
+/// \param directory the directory where to write the framework output
+/// \param manager the framework manager
+/// \return the handle of the set of writes
+QnCorrectionsOutputHandle QnCorrectionsOutputWriter::WriteFrameworkOutput(TDirectory *directory, QnCorrectionsManager *manager) {
+  if (directory == NULL) {
+    QnCorrectionsFatal(Form("Asynchronous framework output write requested without directory. FIX IT, PLEASE."));
+    return QnCorrectionsOutputHandle();
+  }
+  TList *lists[4] = {manager->GetOutputHistogramsList(), manager->GetQAHistogramsList(), manager->GetNveQAHistogramsList(),
+      manager->GetQnCorrelationsList()};
+
+  Int_t nNoOfTasks = 0;
+  for (Int_t ixList = 0; ixList < 4; ixList++) {
+    if (lists[ixList] != NULL) nNoOfTasks++;
+  }
+  if (nNoOfTasks == 0) return QnCorrectionsOutputHandle();
+
+  QnCorrectionsOutputHandle::Result *result = QnCorrectionsOutputHandle::Result::New(nNoOfTasks);
+  {
+    std::lock_guard<std::mutex> lock(fPool->fMutex);
+    for (Int_t ixList = 0; ixList < 4; ixList++) {
+      if (lists[ixList] != NULL) {
+        QueueTask(directory, lists[ixList], lists[ixList]->GetName(), kFALSE, result);
+      }
+    }
+  }
+  fPool->fNewTask.notify_all();
+  return QnCorrectionsOutputHandle(this, result);
+}
+
+/// Waits until all the requested writes are completed
+void QnCorrectionsOutputWriter::WaitAll() {
+  std::unique_lock<std::mutex> lock(fPool->fMutex);
+  while (fPool->fNoOfPending != 0) {
+    fPool->fTaskDone.wait(lock);
+  }
+}
+
+/// Gets the number of not completed writes
+/// \return the number of pending writes
+Int_t QnCorrectionsOutputWriter::GetNoOfPendingWrites() const {
+  std::lock_guard<std::mutex> lock(fPool->fMutex);
+  return fPool->fNoOfPending;
+}
+
+/// Checks whether the writes of the passed outcome have been completed
+/// \param result the outcome of the writes
+/// \return kTRUE if the writes have been performed
+Bool_t QnCorrectionsOutputWriter::IsDone(const QnCorrectionsOutputHandle::Result *result) const {
+  std::lock_guard<std::mutex> lock(fPool->fMutex);
+  return (result->fNoOfDone == result->fNoOfTasks);
+}
+
+/// Waits until the writes of the passed outcome are completed
+/// \param result the outcome of the writes
+/// \return the number of bytes written
+Int_t QnCorrectionsOutputWriter::Wait(const QnCorrectionsOutputHandle::Result *result) const {
+  std::unique_lock<std::mutex> lock(fPool->fMutex);
+  while (result->fNoOfDone != result->fNoOfTasks) {
+    fPool->fTaskDone.wait(lock);
+  }
+  return result->fNoOfBytes;
+}
+
+/// The background threads loop
+///
+/// Takes the first pending write whose file is not being written,
+/// so that writes to the same file are performed in request order,
+/// and performs it without holding the pool lock.
+void QnCorrectionsOutputWriter::RunWorker() {
+  std::unique_lock<std::mutex> lock(fPool->fMutex);
+  while (kTRUE) {
+    /* look for a pending write on a free file */
+    std::deque<Int_t>::iterator next = fPool->fQueue.end();
+    std::set<TFile *> blocked(fPool->fBusyFiles);
+    for (std::deque<Int_t>::iterator it = fPool->fQueue.begin(); it != fPool->fQueue.end(); ++it) {
+      TFile *file = fPool->fTasks[*it].fDirectory->GetFile();
+      if (blocked.count(file) == 0) {
+        next = it;
+        break;
+      }
+      /* keep the request order within each file */
+      blocked.insert(file);
+    }
+    if (next == fPool->fQueue.end()) {
+      if (fPool->fStop && fPool->fQueue.empty()) return;
+      fPool->fNewTask.wait(lock);
+      continue;
+    }
+
+    Int_t taskNo = *next;
+    fPool->fQueue.erase(next);
+    TDirectory *directory = fPool->fTasks[taskNo].fDirectory;
+    const TObject *object = fPool->fTasks[taskNo].fObject;
+    const char *keyName = fPool->fTasks[taskNo].fKeyName.Data();
+    Bool_t owned = fPool->fTasks[taskNo].fOwned;
+    QnCorrectionsOutputHandle::Result *result = fPool->fTasks[taskNo].fResult;
+    TFile *file = directory->GetFile();
+    fPool->fBusyFiles.insert(file);
+
+    /* the slot is not reused until it is released below */
+    lock.unlock();
+    Int_t nBytes = directory->WriteTObject(object, keyName, "SingleKey");
+    if (owned) delete object;
+    lock.lock();
+
+    result->fNoOfBytes += nBytes;
+    result->fNoOfDone++;
+    result->Release();
+    fPool->fTasks[taskNo].fObject = NULL;
+    fPool->fTasks[taskNo].fResult = NULL;
+    fPool->fFreeTasks.push_back(taskNo);
+    fPool->fNoOfPending--;
+    fPool->fBusyFiles.erase(file);
+    fPool->fTaskDone.notify_all();
+    /* a write on the released file may be waiting */
+    fPool->fNewTask.notify_all();
+  }
+}
+
+/// Copy constructor
+/// The copy shares the outcome of the writes
+/// \param handle the handle to copy
+QnCorrectionsOutputHandle::QnCorrectionsOutputHandle(const QnCorrectionsOutputHandle &handle) :
+  fWriter(handle.fWriter),
+  fResult(handle.fResult) {
+  if (fResult != NULL) fResult->fNoOfReferences++;
+}
+
+/// Assignment operator
+/// The handle releases its outcome and shares the one of the passed handle
+/// \param handle the handle to assign
+/// \return the handle
+QnCorrectionsOutputHandle& QnCorrectionsOutputHandle::operator= (const QnCorrectionsOutputHandle &handle) {
+  if (handle.fResult != NULL) handle.fResult->fNoOfReferences++;
+  Release();
+  fWriter = handle.fWriter;
+  fResult = handle.fResult;
+  return *this;
+}
+
+/// Default destructor
+/// Releases the outcome of the writes
+QnCorrectionsOutputHandle::~QnCorrectionsOutputHandle() {
+  Release();
+}
+
+/// Releases the reference to the outcome of the writes
+void QnCorrectionsOutputHandle::Release() {
+  if (fResult != NULL) fResult->Release();
+  fWriter = NULL;
+  fResult = NULL;
+}
+
+/// Checks whether the associated writes have been completed
+/// \return kTRUE if all the associated writes have been performed
+Bool_t QnCorrectionsOutputHandle::IsReady() const {
+  if (fWriter == NULL) return kFALSE;
+  return fWriter->IsDone(fResult);
+}
+
+/// Waits until the associated writes are completed
+/// \return the number of written bytes, zero if the writes failed
+Int_t QnCorrectionsOutputHandle::Get() const {
+  if (fWriter == NULL) return 0;
+  return fWriter->Wait(fResult);
+}
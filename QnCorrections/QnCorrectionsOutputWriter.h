@@ -0,0 +1,135 @@
+#ifndef QNCORRECTIONS_OUTPUTWRITER_H
+#define QNCORRECTIONS_OUTPUTWRITER_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsOutputWriter.h
+/// \brief Asynchronous writer of the Q vector correction framework output
+
+#include <TObject.h>
+
+class TDirectory;
+class QnCorrectionsManager;
+class QnCorrectionsOutputWriter;
+
+/// \class QnCorrectionsOutputHandle
+/// \brief Future like handle of an output object write
+///
+/// Returned by the asynchronous writer for each requested write,
+/// or set of writes. It allows to check whether the writes have been
+/// completed and to wait for their completion getting the number of
+/// written bytes. The outcome of the writes is shared by the copies
+/// of the handle and released with the last one, so the handle does
+/// not keep any writer resource. Checking or waiting for the writes
+/// requires the writer still alive.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsOutputHandle {
+public:
+  friend class QnCorrectionsOutputWriter;
+  /// Default constructor
+  /// Builds a handle not associated to any write
+  QnCorrectionsOutputHandle() : fWriter(NULL), fResult(NULL) {}
+  QnCorrectionsOutputHandle(const QnCorrectionsOutputHandle &handle);
+  QnCorrectionsOutputHandle& operator= (const QnCorrectionsOutputHandle &handle);
+  ~QnCorrectionsOutputHandle();
+
+  /// Gets whether the handle is associated to any write
+  /// \return kTRUE if the handle is associated to any write
+  Bool_t IsValid() const { return (fWriter != NULL); }
+  Bool_t IsReady() const;
+  Int_t Get() const;
+
+private:
+  struct Result;
+  /// Normal constructor
+  /// The handle takes over the reference the result is created with
+  /// \param writer the writer in charge of the writes
+  /// \param result the shared outcome of the writes
+  QnCorrectionsOutputHandle(QnCorrectionsOutputWriter *writer, Result *result) :
+    fWriter(writer), fResult(result) {}
+  void Release();
+
+  QnCorrectionsOutputWriter *fWriter;   ///< the writer in charge of the writes
+  Result *fResult;                      ///< the shared outcome of the writes
+};
+
+/// \class QnCorrectionsOutputWriter
+/// \brief Writes output objects on a pool of background threads
+///
+/// The support, QA and non validated entries QA histograms lists are
+/// large for large event class binnings and their serialization and
+/// compression on the processing thread leaves it idle. The writer
+/// takes each write request and performs it on one of its background
+/// threads, returning immediately a handle for the write completion.
+///
+/// The objects to write should not be modified while being written.
+/// For objects that are still being updated, i.e. intermediate outputs,
+/// a snapshot can be requested which is taken on the calling thread
+/// and is owned and deleted by the writer once written.
+///
+/// Writes to different files proceed concurrently while writes to
+/// the same file are performed one at a time as ROOT files do not
+/// support concurrent writes. The write tasks slots are reused once
+/// their writes are completed.
+///
+/// ROOT thread safety, i.e. ROOT::EnableThreadSafety, is a caller
+/// precondition which the writer does not change. Without it no
+/// background thread is started and the writes are performed on the
+/// calling thread at request.
+///
+/// All pending writes should be completed, i.e. with WaitAll, before
+/// closing the involved files. The writer destructor waits for them.
+///
+/// The writer is not meant for ROOT I/O and it has no dictionary.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsOutputWriter {
+public:
+  friend class QnCorrectionsOutputHandle;
+  QnCorrectionsOutputWriter(Int_t nNoOfThreads = 1);
+  ~QnCorrectionsOutputWriter();
+
+  QnCorrectionsOutputHandle WriteAsync(TDirectory *directory, const TObject *object, const char *keyName = NULL, Bool_t snapshot = kFALSE);
+  QnCorrectionsOutputHandle WriteFrameworkOutput(TDirectory *directory, QnCorrectionsManager *manager);
+  void WaitAll();
+
+  Int_t GetNoOfPendingWrites() const;
+  /// Gets the number of background threads
+  /// \return the number of threads in the pool, zero if the writes are performed on the calling thread
+  Int_t GetNoOfThreads() const { return fNoOfThreads; }
+
+private:
+  /// Gets the class name for the logging messages
+  /// \return the class name
+  static const char *ClassName() { return "QnCorrectionsOutputWriter"; }
+  void QueueTask(TDirectory *directory, const TObject *object, const char *keyName, Bool_t owned,
+      QnCorrectionsOutputHandle::Result *result);
+  Bool_t IsDone(const QnCorrectionsOutputHandle::Result *result) const;
+  Int_t Wait(const QnCorrectionsOutputHandle::Result *result) const;
+  void RunWorker();
+
+  struct Pool;
+  Int_t fNoOfThreads;                   ///< the number of background threads
+  Pool *fPool;                          //!<! the threads pool and the write tasks
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsOutputWriter(const QnCorrectionsOutputWriter &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsOutputWriter& operator= (const QnCorrectionsOutputWriter &);
+};
+
+#endif // QNCORRECTIONS_OUTPUTWRITER_H
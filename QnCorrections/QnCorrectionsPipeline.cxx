@@ -0,0 +1,211 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsPipeline.cxx
+/// \brief Implementation of the pipelined events loop driver
+
+#include <thread>
+#include <vector>
+
+#include <TROOT.h>
+#include <TVirtualMutex.h>
+
+#include "QnCorrectionsCoreSpscQueue.h"
+#include "QnCorrectionsManager.h"
+#include "QnCorrectionsPipeline.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsPipeline);
+/// \endcond
+
+/// Default constructor
+/// Builds an empty event
+QnCorrectionsPipelineEvent::QnCorrectionsPipelineEvent() :
+  fEventId(0),
+  fEventIdSet(kFALSE),
+  fEntries(),
+  fOutputValues() {
+}
+
+/// Empties the event for its reuse
+///
+/// The storage is kept.
+void QnCorrectionsPipelineEvent::Clear() {
+  fEventId = 0;
+  fEventIdSet = kFALSE;
+  fEntries.clear();
+  fOutputValues.clear();
+}
+
+/// Feeds the event to the framework
+///
+/// The event id, if set, and then the data variables assignments and the
+/// data vectors are issued to the framework manager in their recorded order.
+/// \param manager the framework manager
+void QnCorrectionsPipelineEvent::Feed(QnCorrectionsManager *manager) const {
+  if (fEventIdSet) manager->SetSubsampleEventId(fEventId);
+  for (UInt_t ixEntry = 0; ixEntry < fEntries.size(); ixEntry++) {
+    const Entry &entry = fEntries[ixEntry];
+    if (entry.fKind == kVariable)
+      manager->SetDataVariable(entry.fId, Float_t(entry.fValue));
+    else
+      manager->AddDataVector(entry.fId, entry.fValue, entry.fWeight, entry.fChannelId);
+  }
+}
+
+/// \cond
+/// The events in flight and the queues among the stages
+///
+/// The free events go from the output stage, or the processing one
+/// if there is no output, back to the input stage.
+struct QnCorrectionsPipeline::Stages {
+  /// Normal constructor
+  /// \param nCapacity the number of events and the queues capacity
+  Stages(Int_t nCapacity) : fEvents(nCapacity), fFree(nCapacity), fToProcess(nCapacity), fToOutput(nCapacity) {}
+
+  std::vector<QnCorrectionsPipelineEvent> fEvents;  ///< the events in flight
+  QnCorrectionsCoreSpscQueue fFree;                 ///< the free events
+  QnCorrectionsCoreSpscQueue fToProcess;            ///< the events decoded by the input stage
+  QnCorrectionsCoreSpscQueue fToOutput;             ///< the events processed by the framework
+};
+/// \endcond
+
+/// Normal constructor
+/// \param manager the framework manager, already initialized
+/// \param nQueueCapacity the queues capacity, the number of events in flight
+QnCorrectionsPipeline::QnCorrectionsPipeline(QnCorrectionsManager *manager, Int_t nQueueCapacity) : TObject(),
+  fCorrectionsManager(manager),
+  fQueueCapacity((nQueueCapacity < 1) ? 1 : nQueueCapacity),
+  fNoOfInputStalls(0),
+  fNoOfOutputStalls(0),
+  fStages(NULL) {
+}
+
+/// Default destructor
+QnCorrectionsPipeline::~QnCorrectionsPipeline() {
+  if (fStages != NULL) delete fStages;
+}
+
+/// Runs the events loop
+///
+/// The input and output stages are started on their own threads and the
+/// framework processing runs on the calling thread. For each event the
+/// framework event is cleared, the event fed to it and processed, and the
+/// output collected. The call returns once the input is exhausted, or the
+/// requested number of events reached, and all the processed events have
+/// been written. ROOT thread safety should have been enabled by the
+/// caller as the stages could use ROOT concurrently.
+/// \param input the input stage
+/// \param output the output stage, NULL for no per event output
+/// \param nMaxNoOfEvents the maximum number of events to process, negative for all of them
+/// \return the number of processed events
+Long64_t QnCorrectionsPipeline::Run(QnCorrectionsPipelineInput *input, QnCorrectionsPipelineOutput *output, Long64_t nMaxNoOfEvents) {
+  if (fCorrectionsManager == NULL || input == NULL) {
+    QnCorrectionsFatal(Form("Pipeline run requested without framework manager or input stage. FIX IT, PLEASE."));
+    return 0;
+  }
+  if (gGlobalMutex == NULL && !ROOT::IsImplicitMTEnabled()) {
+    QnCorrectionsFatal(Form("Pipeline run requested without ROOT thread safety enabled. "
+        "Call ROOT::EnableThreadSafety() before running the pipeline. FIX IT, PLEASE."));
+    return 0;
+  }
+
+  fStages = new Stages(fQueueCapacity);
+  for (Int_t ixEvent = 0; ixEvent < fQueueCapacity; ixEvent++) {
+    fStages->fFree.Push(ixEvent);
+  }
+  std::thread inputThread(&QnCorrectionsPipeline::RunInput, this, input, nMaxNoOfEvents);
+  std::thread outputThread;
+  if (output != NULL) outputThread = std::thread(&QnCorrectionsPipeline::RunOutput, this, output);
+
+  Long64_t nNoOfEvents = 0;
+  Int_t ixEvent;
+  while (fStages->fToProcess.Pop(ixEvent)) {
+    QnCorrectionsPipelineEvent *event = &fStages->fEvents[ixEvent];
+    fCorrectionsManager->ClearEvent();
+    event->Feed(fCorrectionsManager);
+    fCorrectionsManager->ProcessEvent();
+    if (output != NULL) {
+      output->Collect(fCorrectionsManager, event);
+      fStages->fToOutput.Push(ixEvent);
+    }
+    else {
+      fStages->fFree.Push(ixEvent);
+    }
+    nNoOfEvents++;
+  }
+  fStages->fToOutput.Close();
+
+  inputThread.join();
+  if (output != NULL) outputThread.join();
+  fNoOfInputStalls = fStages->fToProcess.GetNoOfEmptyWaits();
+  fNoOfOutputStalls = fStages->fToOutput.GetNoOfFullWaits();
+  delete fStages;
+  fStages = NULL;
+
+  QnCorrectionsInfo(Form("Pipeline processed %lld events, waiting %lld times for input and %lld times for output",
+      nNoOfEvents, fNoOfInputStalls, fNoOfOutputStalls));
+  return nNoOfEvents;
+}
+
+/// The input stage
+///
+/// Takes free events and passes them, once decoded, to the processing
+/// stage until the input is exhausted or the requested number of events
+/// is reached.
+/// \param input the input stage
+/// \param nMaxNoOfEvents the maximum number of events, negative for all of them
+void QnCorrectionsPipeline::RunInput(QnCorrectionsPipelineInput *input, Long64_t nMaxNoOfEvents) {
+  Long64_t nNoOfEvents = 0;
+  Int_t ixEvent;
+  while (((nMaxNoOfEvents < 0) || (nNoOfEvents < nMaxNoOfEvents)) && fStages->fFree.Pop(ixEvent)) {
+    QnCorrectionsPipelineEvent *event = &fStages->fEvents[ixEvent];
+    event->Clear();
+    if (!input->Next(event)) break;
+    fStages->fToProcess.Push(ixEvent);
+    nNoOfEvents++;
+  }
+  fStages->fToProcess.Close();
+}
+
+/// The output stage
+///
+/// Writes the processed events and returns them to the free ones
+/// until the processing stage finishes.
+/// \param output the output stage
+void QnCorrectionsPipeline::RunOutput(QnCorrectionsPipelineOutput *output) {
+  Int_t ixEvent;
+  while (fStages->fToOutput.Pop(ixEvent)) {
+    output->Write(&fStages->fEvents[ixEvent]);
+    fStages->fFree.Push(ixEvent);
+  }
+}
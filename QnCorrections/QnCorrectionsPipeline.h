@@ -0,0 +1,207 @@
+#ifndef QNCORRECTIONS_PIPELINE_H
+#define QNCORRECTIONS_PIPELINE_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsPipeline.h
+/// \brief Pipelined events loop driver for the Q vector correction framework
+
+#include <vector>
+#include <TObject.h>
+
+class QnCorrectionsManager;
+
+/// \class QnCorrectionsPipelineEvent
+/// \brief The content of an event in the framework batch format
+///
+/// Keeps, in the order they were issued, the data variables assignments
+/// and the data vectors of an event so that they can be decoded on one
+/// thread and fed to the framework on another one. A data variable
+/// assigned between data vectors, i.e. a track variable, applies to the
+/// data vectors that follow it, exactly as when issued directly to the
+/// framework manager.
+///
+/// It also carries the values the output collects from the framework
+/// once the event is processed. Events are reused so, after the first
+/// ones, no allocation happens.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsPipelineEvent {
+public:
+  QnCorrectionsPipelineEvent();
+
+  void Clear();
+  /// Sets the unique event id used for the subsample assignment
+  /// \param eventId the event id
+  void SetEventId(ULong64_t eventId) { fEventId = eventId; fEventIdSet = kTRUE; }
+  /// Records the assignment of a data variable
+  /// \param varId the external variable id
+  /// \param value the variable value
+  void SetDataVariable(Int_t varId, Float_t value)
+  { fEntries.push_back(Entry(kVariable, varId, value, 0.0, -1)); }
+  /// Records a data vector
+  /// \param detectorId id of the involved detector
+  /// \param phi azimuthal angle
+  /// \param weight the weight of the data vector
+  /// \param channelId the channel Id that originates the data vector
+  void AddDataVector(Int_t detectorId, Double_t phi, Double_t weight = 1.0, Int_t channelId = -1)
+  { fEntries.push_back(Entry(kDataVector, detectorId, phi, weight, channelId)); }
+  void Feed(QnCorrectionsManager *manager) const;
+
+  /// Gets the number of recorded variables assignments and data vectors
+  Int_t GetNoOfEntries() const { return Int_t(fEntries.size()); }
+
+  /// Stores a value for the output of the event
+  /// \param value the value
+  void AddOutputValue(Double_t value) { fOutputValues.push_back(value); }
+  /// Gets the number of output values of the event
+  Int_t GetNoOfOutputValues() const { return Int_t(fOutputValues.size()); }
+  /// Gets the output values of the event
+  const Double_t *GetOutputValues() const { return (fOutputValues.empty() ? NULL : &fOutputValues[0]); }
+
+private:
+  /// The kinds of entries
+  enum EntryKind {
+    kVariable,     ///< a data variable assignment
+    kDataVector    ///< a data vector
+  };
+  /// \struct Entry
+  /// \brief A data variable assignment or a data vector
+  struct Entry {
+    /// Normal constructor
+    /// \param kind the kind of entry
+    /// \param id the variable id or the detector id
+    /// \param value the variable value or the data vector azimuthal angle
+    /// \param weight the data vector weight
+    /// \param channelId the data vector channel id
+    Entry(EntryKind kind, Int_t id, Double_t value, Double_t weight, Int_t channelId) :
+      fKind(kind), fId(id), fChannelId(channelId), fValue(value), fWeight(weight) {}
+    EntryKind fKind;    ///< the kind of entry
+    Int_t fId;          ///< the variable id or the detector id
+    Int_t fChannelId;   ///< the data vector channel id
+    Double_t fValue;    ///< the variable value or the data vector azimuthal angle
+    Double_t fWeight;   ///< the data vector weight
+  };
+
+  ULong64_t fEventId;                   ///< the unique event id
+  Bool_t fEventIdSet;                   ///< the event id was set
+  std::vector<Entry> fEntries;          ///< the variables assignments and data vectors in issue order
+  std::vector<Double_t> fOutputValues;  ///< the output values collected after processing
+};
+
+/// \class QnCorrectionsPipelineInput
+/// \brief Interface of the input stage of the pipeline
+///
+/// Decodes the events of the input source, i.e. reading and
+/// decompressing the input tree baskets, into the framework batch format.
+/// Runs on its own thread so it should not touch the framework.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsPipelineInput {
+public:
+  /// Default destructor
+  virtual ~QnCorrectionsPipelineInput() {}
+  /// Decodes the next event
+  /// \param event the event to fill, already cleared
+  /// \return kFALSE if there are no more events
+  virtual Bool_t Next(QnCorrectionsPipelineEvent *event) = 0;
+};
+
+/// \class QnCorrectionsPipelineOutput
+/// \brief Interface of the output stage of the pipeline
+///
+/// Collects, on the processing thread, what it needs from the framework
+/// once each event is processed, i.e. the Qn vectors components, and
+/// stores it within the event. Then, on its own thread, writes it, i.e.
+/// filling and compressing a Qn vectors tree or a flat output.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsPipelineOutput {
+public:
+  /// Default destructor
+  virtual ~QnCorrectionsPipelineOutput() {}
+  /// Collects the output of the just processed event
+  ///
+  /// Runs on the processing thread before the next event is fed to the framework
+  /// \param manager the framework manager
+  /// \param event the processed event where to store the output values
+  virtual void Collect(QnCorrectionsManager *manager, QnCorrectionsPipelineEvent *event) = 0;
+  /// Writes the output of an event
+  ///
+  /// Runs on the output thread
+  /// \param event the event with the output values
+  virtual void Write(const QnCorrectionsPipelineEvent *event) = 0;
+};
+
+/// \class QnCorrectionsPipeline
+/// \brief Runs the events loop as three stages on separate threads
+///
+/// The input stage decodes the events, the processing stage feeds them
+/// to the framework and processes them, and the output stage writes their
+/// output. The stages run concurrently on different threads, the processing
+/// one on the calling thread, so that decompressing the input and compressing
+/// the output do not stall the framework processing.
+///
+/// The events flow through a fixed number of reusable events, as many as
+/// the queues capacity, connected by bounded single producer single consumer
+/// queues. A stage faster than the next one is held back when the queue in
+/// front of it is full, or when there is no free event left, so the memory
+/// in use stays bounded whatever the relative speed of the stages.
+///
+/// ROOT thread safety, i.e. ROOT::EnableThreadSafety, is a caller
+/// precondition which the pipeline does not change. Running the
+/// pipeline without it is a fatal error.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsPipeline : public TObject {
+public:
+  QnCorrectionsPipeline(QnCorrectionsManager *manager, Int_t nQueueCapacity = 16);
+  virtual ~QnCorrectionsPipeline();
+
+  Long64_t Run(QnCorrectionsPipelineInput *input, QnCorrectionsPipelineOutput *output = NULL, Long64_t nMaxNoOfEvents = -1);
+
+  /// Gets the queues capacity
+  /// \return the number of events in flight
+  Int_t GetQueueCapacity() const { return fQueueCapacity; }
+  /// Gets the number of times the processing stage waited for the input stage in the last run
+  Long64_t GetNoOfInputStalls() const { return fNoOfInputStalls; }
+  /// Gets the number of times the processing stage waited for the output stage in the last run
+  Long64_t GetNoOfOutputStalls() const { return fNoOfOutputStalls; }
+
+private:
+  void RunInput(QnCorrectionsPipelineInput *input, Long64_t nMaxNoOfEvents);
+  void RunOutput(QnCorrectionsPipelineOutput *output);
+
+  struct Stages;
+  QnCorrectionsManager *fCorrectionsManager; //!<! the framework manager
+  Int_t fQueueCapacity;                 ///< the queues capacity, the number of events in flight
+  Long64_t fNoOfInputStalls;            ///< the times the processing waited for input in the last run
+  Long64_t fNoOfOutputStalls;           ///< the times the processing waited for output in the last run
+  Stages *fStages;                      //!<! the events and the queues among the stages
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsPipeline(const QnCorrectionsPipeline &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsPipeline& operator= (const QnCorrectionsPipeline &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsPipeline, 1);
+/// \endcond
+};
+
+#endif // QNCORRECTIONS_PIPELINE_H
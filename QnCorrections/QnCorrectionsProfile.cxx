@@ -89,7 +89,9 @@ Bool_t QnCorrectionsProfile::CreateProfileHistograms(TList *histogramList) {
   fValues->Sumw2();
 
   histogramList->Add(fValues);
+  AddSubsamplesHistogram(histogramList, fValues);
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -134,8 +136,7 @@ Bool_t QnCorrectionsProfile::AttachHistograms(TList *histogramList) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfile::GetBin(const Float_t *variableContainer) {
-  FillBinAxesValues(variableContainer);
-  return fEntries->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -216,12 +217,8 @@ Float_t QnCorrectionsProfile::GetBinError(Long64_t bin) {
 /// \param variableContainer the current variables conten addressed by var Id
 /// \param weight the increment in the bin content
 void QnCorrectionsProfile::Fill(const Float_t *variableContainer, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fValues, weight);
+  FillHistogram(fEntries, 1.0);
 }
 
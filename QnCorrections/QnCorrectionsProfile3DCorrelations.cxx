@@ -249,9 +249,13 @@ Bool_t QnCorrectionsProfile3DCorrelations::CreateCorrelationComponentsProfileHis
 
       /* and finally add the histograms to the list */
       histogramList->Add(fXXValues[ixComb][currentHarmonic]);
+      AddSubsamplesHistogram(histogramList, fXXValues[ixComb][currentHarmonic]);
       histogramList->Add(fXYValues[ixComb][currentHarmonic]);
+      AddSubsamplesHistogram(histogramList, fXYValues[ixComb][currentHarmonic]);
       histogramList->Add(fYXValues[ixComb][currentHarmonic]);
+      AddSubsamplesHistogram(histogramList, fYXValues[ixComb][currentHarmonic]);
       histogramList->Add(fYYValues[ixComb][currentHarmonic]);
+      AddSubsamplesHistogram(histogramList, fYYValues[ixComb][currentHarmonic]);
     }
   }
   /* now the entries histogram name and title */
@@ -281,6 +285,7 @@ Bool_t QnCorrectionsProfile3DCorrelations::CreateCorrelationComponentsProfileHis
 
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -406,8 +411,7 @@ Bool_t QnCorrectionsProfile3DCorrelations::AttachHistograms(TList *histogramList
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfile3DCorrelations::GetBin(const Float_t *variableContainer) {
-  FillBinAxesValues(variableContainer);
-  return fEntries->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -828,26 +832,15 @@ void QnCorrectionsProfile3DCorrelations::Fill(const QnCorrectionsQnVector *QnA,
         QnCorrectionsFatal(Form("Non allocated harmonic %d in 3D correlation component histogram %s. FIX IT, PLEASE.", nCurrentHarmonic, GetName()));
       }
 
-      /* keep total entries in fValues updated */
-      Double_t nXXEntries = fXXValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nXYEntries = fXYValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nYXEntries = fYXValues[ixComb][nCurrentHarmonic]->GetEntries();
-      Double_t nYYEntries = fYYValues[ixComb][nCurrentHarmonic]->GetEntries();
-
-      fXXValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues, combQn[ixComb]->Qx(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
-      fXYValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues, combQn[ixComb]->Qx(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
-      fYXValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues, combQn[ixComb]->Qy(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
-      fYYValues[ixComb][nCurrentHarmonic]->Fill(fBinAxesValues, combQn[ixComb]->Qy(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
-
-      fXXValues[ixComb][nCurrentHarmonic]->SetEntries(nXXEntries + 1);
-      fXYValues[ixComb][nCurrentHarmonic]->SetEntries(nXYEntries + 1);
-      fYXValues[ixComb][nCurrentHarmonic]->SetEntries(nYXEntries + 1);
-      fYYValues[ixComb][nCurrentHarmonic]->SetEntries(nYYEntries + 1);
+      FillHistogram(fXXValues[ixComb][nCurrentHarmonic], combQn[ixComb]->Qx(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
+      FillHistogram(fXYValues[ixComb][nCurrentHarmonic], combQn[ixComb]->Qx(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
+      FillHistogram(fYXValues[ixComb][nCurrentHarmonic], combQn[ixComb]->Qy(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qx(nCurrentHarmonic));
+      FillHistogram(fYYValues[ixComb][nCurrentHarmonic], combQn[ixComb]->Qy(nCurrentHarmonic) * combQn[(ixComb+1)%CORRELATIONSNOOFQNVECTORS]->Qy(nCurrentHarmonic));
 
       nCurrentHarmonic = QnA->GetNextHarmonic(nCurrentHarmonic);
     }
   }
 
   /* update the profile entries */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
 }
@@ -135,6 +135,9 @@ Bool_t QnCorrectionsProfileChannelized::CreateProfileHistograms(TList *histogram
   maxvals[nVariables] = -0.5 + fActualNoOfChannels;
   nbins[nVariables] = fActualNoOfChannels;
 
+  /* the bin locator has to include the channel axis */
+  SetUpBinLocator(fBinLocator, fActualNoOfChannels);
+
   /* create the values and entries multidimensional histograms */
   fValues = new THnF((const char *) histoName, (const char *) histoTitle,nVariables+1,nbins,minvals,maxvals);
   fEntries = new THnI((const char *) entriesHistoName, (const char *) entriesHistoTitle,nVariables+1,nbins,minvals,maxvals);
@@ -164,7 +167,9 @@ Bool_t QnCorrectionsProfileChannelized::CreateProfileHistograms(TList *histogram
   fValues->Sumw2();
 
   histogramList->Add(fValues);
+  AddSubsamplesHistogram(histogramList, fValues);
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -184,9 +189,8 @@ Bool_t QnCorrectionsProfileChannelized::CreateProfileHistograms(TList *histogram
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfileChannelized::GetBin(const Float_t *variableContainer, Int_t nChannel) {
 
-  FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
-  /* store the channel number */
-  return fEntries->GetBin(fBinAxesValues);
+  /* the channel number goes to the channel axis */
+  return fBinLocator.GetBin(variableContainer, fChannelMap[nChannel]);
 }
 
 /// Check the validity of the content of the passed bin
@@ -269,13 +273,9 @@ Float_t QnCorrectionsProfileChannelized::GetBinError(Long64_t bin) {
 /// \param nChannel the interested external channel number
 /// \param weight the increment in the bin content
 void QnCorrectionsProfileChannelized::Fill(const Float_t *variableContainer, Int_t nChannel, Float_t weight) {
-  /* keep the total entries in fValues updated */
-  Double_t nEntries = fValues->GetEntries();
-
   FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
   /* and now update the bin */
-  fValues->Fill(fBinAxesValues, weight);
-  fValues->SetEntries(nEntries + 1);
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fValues, weight);
+  FillHistogram(fEntries, 1.0);
 }
 
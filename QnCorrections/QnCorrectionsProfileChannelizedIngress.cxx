@@ -2,6 +2,7 @@
 /// \brief Implementation of the multidimensional ingress channelized profile 
 
 #include "TList.h"
+#include "TMath.h"
 
 #include "QnCorrectionsEventClassVariablesSet.h"
 #include "QnCorrectionsProfileChannelizedIngress.h"
@@ -13,7 +14,8 @@ ClassImp(QnCorrectionsProfileChannelizedIngress);
 
 /// Default constructor
 QnCorrectionsProfileChannelizedIngress::QnCorrectionsProfileChannelizedIngress() :
-    QnCorrectionsHistogramBase() {
+    QnCorrectionsHistogramBase(),
+    fGroupBinLocator() {
 
   fValues = NULL;
   fGroupValues = NULL;
@@ -50,7 +52,8 @@ QnCorrectionsProfileChannelizedIngress::QnCorrectionsProfileChannelizedIngress(c
     const char *title,
     QnCorrectionsEventClassVariablesSet &ecvs,
     Int_t nNoOfChannels,
-    Option_t *option) : QnCorrectionsHistogramBase(name, title, ecvs, option) {
+    Option_t *option) : QnCorrectionsHistogramBase(name, title, ecvs, option),
+    fGroupBinLocator() {
 
   fValues = NULL;
   fGroupValues = NULL;
@@ -116,6 +119,7 @@ Bool_t QnCorrectionsProfileChannelizedIngress::AttachHistograms(TList *histogram
   fValues = NULL;
   fGroupValues = NULL;
   fValidated = NULL;
+  fUseQuantizedTables = kFALSE;
   if (fUsedChannel != NULL) delete [] fUsedChannel;
   if (fChannelGroup != NULL) delete [] fChannelGroup;
   if (fChannelMap != NULL) delete [] fChannelMap;
@@ -189,6 +193,12 @@ Bool_t QnCorrectionsProfileChannelizedIngress::AttachHistograms(TList *histogram
     }
   }
 
+  /* the bin locators have to include the channel and group axes */
+  SetUpBinLocator(fBinLocator, fActualNoOfChannels);
+  if (fUseGroups) {
+    SetUpBinLocator(fGroupBinLocator, fActualNoOfGroups);
+  }
+
   /* let's first try the Values / Entries structure */
   THnI *origEntries = (THnI *) histogramList->FindObject((const char*) entriesHistoName);
   if (origEntries != NULL && origEntries->GetEntries() != 0) {
@@ -261,62 +271,86 @@ Bool_t QnCorrectionsProfileChannelizedIngress::AttachHistograms(TList *histogram
       fGroupValues->Sumw2();
 
       /* now let's build its content */
-      /* the procedure is as follows: we will project and add together the values histogram */
-      /* of the channels corresponding to a group number and the number of entries within these */
-      /* channels then we divide both sums and then store the result in the corresponding group values */
-      Int_t *dimToProject = new Int_t[nVariables];
+      /* the procedure is as follows: in a single pass over the original values and entries */
+      /* histograms bins we accumulate, for each group and event class, the values, the squared */
+      /* errors and the entries of the channels within the group and then we divide the sums */
+      /* and store the result in the corresponding group values */
+      Int_t *channelGroup = new Int_t[fActualNoOfChannels];
+      for (Int_t ixChannel = 0; ixChannel < fNoOfChannels; ixChannel++) {
+        if (fUsedChannel[ixChannel]) {
+          channelGroup[fChannelMap[ixChannel]] = fGroupMap[fChannelGroup[ixChannel]];
+        }
+      }
+      Long64_t nEventClasses = 1;
       for (Int_t var = 0; var < nVariables; var++)
-        dimToProject[var] = var;
+        nEventClasses *= nbins[var];
+
+      std::vector<Double_t> groupValues(nEventClasses * fActualNoOfGroups, 0.0);
+      std::vector<Double_t> groupErrors2(nEventClasses * fActualNoOfGroups, 0.0);
+      std::vector<Long64_t> groupEntries(nEventClasses * fActualNoOfGroups, 0);
       Int_t *binsArray = new Int_t[nVariables+1];
 
-      for (Int_t ixGroup = 0; ixGroup < fNoOfGroups; ixGroup++) {
-        if (fUsedGroup[ixGroup]) {
-          /* new group, let's add its contributor channels */
-          THnF *hCumProjected = NULL;
-          THnI *hCumProjectedEntries = NULL;
-          for (Int_t ixChannel = 0; ixChannel < fNoOfChannels; ixChannel++) {
-            if (fUsedChannel[ixChannel]) {
-              if (fChannelGroup[ixChannel] == ixGroup) {
-                /* channel within the group found let's add its content */
-                /* first filter the projection */
-                origValues->GetAxis(nVariables)->SetRange(fChannelMap[ixChannel]+1, fChannelMap[ixChannel]+1);
-                origEntries->GetAxis(nVariables)->SetRange(fChannelMap[ixChannel]+1, fChannelMap[ixChannel]+1);
-                if (hCumProjected != NULL) {
-                  /* let's accumulate the new channel */
-                  THnF *hProjected = (THnF *) origValues->Projection(nVariables,dimToProject, "E");
-                  THnI *hProjectedEntries = (THnI *) origEntries->Projection(nVariables,dimToProject);
-                  hCumProjected->Add(hProjected);
-                  hCumProjectedEntries->Add(hProjectedEntries);
-                  delete hProjected;
-                  delete hProjectedEntries;
-                }
-                else {
-                  /* first channel in the group */
-                  hCumProjected = (THnF *) origValues->Projection(nVariables,dimToProject, "E");
-                  hCumProjectedEntries = (THnI *) origEntries->Projection(nVariables,dimToProject);
-                }
-              }
+      for (Long64_t bin = 0; bin < origValues->GetNbins(); bin++) {
+        Double_t value = origValues->GetBinContent(bin, binsArray);
+        /* skip the underflow and overflow bins */
+        Long64_t eventClass = 0;
+        Bool_t regular = (0 < binsArray[nVariables]) && (binsArray[nVariables] <= fActualNoOfChannels);
+        for (Int_t var = 0; (var < nVariables) && regular; var++) {
+          regular = (0 < binsArray[var]) && (binsArray[var] <= nbins[var]);
+          eventClass = eventClass * nbins[var] + (binsArray[var] - 1);
+        }
+        if (!regular) continue;
+
+        Long64_t groupEventClass = channelGroup[binsArray[nVariables] - 1] * nEventClasses + eventClass;
+        groupValues[groupEventClass] += value;
+        groupErrors2[groupEventClass] += origValues->GetBinError2(bin);
+        groupEntries[groupEventClass] += Long64_t(origEntries->GetBinContent(bin));
+      }
+
+      /* now the final group weights */
+      Int_t nNotValidatedBins = 0;
+      for (Int_t ixGroup = 0; ixGroup < fActualNoOfGroups; ixGroup++) {
+        for (Long64_t eventClass = 0; eventClass < nEventClasses; eventClass++) {
+          /* the event class bins */
+          Long64_t remainder = eventClass;
+          for (Int_t var = nVariables - 1; var >= 0; var--) {
+            binsArray[var] = Int_t(remainder % nbins[var]) + 1;
+            remainder /= nbins[var];
+          }
+          binsArray[nVariables] = ixGroup + 1;
+
+          Long64_t groupEventClass = ixGroup * nEventClasses + eventClass;
+          Double_t value = groupValues[groupEventClass];
+          Long64_t nEntries = groupEntries[groupEventClass];
+          if (nEntries < fMinNoOfEntriesToValidate) {
+            /* bin content not validated, the group values are already zero */
+            if (value != 0.0) nNotValidatedBins++;
+          }
+          else {
+            Double_t average = value / nEntries;
+            Double_t serror = TMath::Sqrt(TMath::Abs(groupErrors2[groupEventClass] / nEntries - average * average));
+            fGroupValues->SetBinContent(binsArray, average);
+            switch (fErrorMode) {
+            case kERRORMEAN:
+              /* standard error on the mean of the bin values */
+              fGroupValues->SetBinError(binsArray, serror / TMath::Sqrt(nEntries));
+              break;
+            case kERRORSPREAD:
+              /* standard deviation of the bin values */
+              fGroupValues->SetBinError(binsArray, serror);
+              break;
             }
           }
-          /* let's build the final group weight */
-          THnF *hChannelsGroupWeights = DivideTHnF(hCumProjected, hCumProjectedEntries);
-
-          /* let's store the channels contribution to the group values for the group */
-          /* the group for which we are storing values */
-          for (Int_t var = 0; var < nVariables; var++)
-            binsArray[var] = 0;
-          binsArray[nVariables] = fGroupMap[ixGroup] + 1;
-          /* remember, we copy the values because we are visiting each group once */
-          CopyTHnF(fGroupValues, hChannelsGroupWeights, binsArray);
-          delete hCumProjected;
-          delete hCumProjectedEntries;
-          delete hChannelsGroupWeights;
         }
       }
-      /* reset the ranges */
-      origValues->GetAxis(nVariables)->SetRange(0, 0);
-      origEntries->GetAxis(nVariables)->SetRange(0, 0);
-      delete [] dimToProject;
+      if (nNotValidatedBins != 0) {
+        QnCorrectionsError(Form("There are %d bins whose bin content were not validated! histogram: %s.\n" \
+            "   Minimum number of entries to validate: %d.",
+            nNotValidatedBins,
+            fGroupValues->GetName(),
+            fMinNoOfEntriesToValidate));
+      }
+      delete [] channelGroup;
       delete [] binsArray;
     }
     /* we finished here with this stuff */
@@ -327,9 +361,47 @@ Bool_t QnCorrectionsProfileChannelizedIngress::AttachHistograms(TList *histogram
   else
     return kFALSE;
 
+  if (fContext->GetQuantizedTables()) {
+    BuildQuantizedTables();
+  }
   return kTRUE;
 }
 
+/// Builds the quantized tables of the definitive values and errors
+///
+/// Table 0 keeps the channels values and the bins validity, table 1
+/// the channels errors and, if groups are in use, tables 2 and 3
+/// keep the groups values and errors.
+void QnCorrectionsProfileChannelizedIngress::BuildQuantizedTables() {
+  Long64_t nBins = fBinLocator.GetNLinearBins();
+  std::vector<Float_t> values(nBins);
+  std::vector<Float_t> errors(nBins);
+  Bool_t *valid = new Bool_t[nBins];
+
+  BeginQuantizedTables(fUseGroups ? 4 : 2);
+  for (Long64_t bin = 0; bin < nBins; bin++) {
+    values[bin] = fValues->GetBinContent(bin);
+    errors[bin] = fValues->GetBinError(bin);
+    valid[bin] = !(fValidated->GetBinContent(bin) < 0.5);
+  }
+  QuantizeTable(0, nBins, &values[0], valid, "values");
+  QuantizeTable(1, nBins, &errors[0], NULL, "errors");
+  delete [] valid;
+
+  if (fUseGroups) {
+    Long64_t nGroupBins = fGroupBinLocator.GetNLinearBins();
+    values.resize(nGroupBins);
+    errors.resize(nGroupBins);
+    for (Long64_t bin = 0; bin < nGroupBins; bin++) {
+      values[bin] = fGroupValues->GetBinContent(bin);
+      errors[bin] = fGroupValues->GetBinError(bin);
+    }
+    QuantizeTable(2, nGroupBins, &values[0], NULL, "group values");
+    QuantizeTable(3, nGroupBins, &errors[0], NULL, "group errors");
+  }
+  EndQuantizedTables();
+}
+
 /// Get the bin number for the current variable content and passed channel
 ///
 /// The bin number identifies the event class the current
@@ -340,9 +412,8 @@ Bool_t QnCorrectionsProfileChannelizedIngress::AttachHistograms(TList *histogram
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfileChannelizedIngress::GetBin(const Float_t *variableContainer, Int_t nChannel) {
 
-  /* store also the channel number */
-  FillBinAxesValues(variableContainer, fChannelMap[nChannel]);
-  return fValues->GetBin(fBinAxesValues);
+  /* the channel number goes to the channel axis */
+  return fBinLocator.GetBin(variableContainer, fChannelMap[nChannel]);
 }
 
 /// Check the validity of the content of the passed bin
@@ -352,6 +423,9 @@ Long64_t QnCorrectionsProfileChannelizedIngress::GetBin(const Float_t *variableC
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t QnCorrectionsProfileChannelizedIngress::BinContentValidated(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[0].IsValid(bin);
+  }
   if (fValidated->GetBinContent(bin) < 0.5) {
     return kFALSE;
   }
@@ -369,6 +443,9 @@ Bool_t QnCorrectionsProfileChannelizedIngress::BinContentValidated(Long64_t bin)
 /// \return the bin number content
 Float_t QnCorrectionsProfileChannelizedIngress::GetBinContent(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[0].Get(bin);
+  }
   return fValues->GetBinContent(bin);
 }
 
@@ -381,6 +458,9 @@ Float_t QnCorrectionsProfileChannelizedIngress::GetBinContent(Long64_t bin) {
 /// \return the bin number content error
 Float_t QnCorrectionsProfileChannelizedIngress::GetBinError(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[1].Get(bin);
+  }
   return fValues->GetBinError(bin);
 }
 
@@ -396,9 +476,8 @@ Long64_t QnCorrectionsProfileChannelizedIngress::GetGrpBin(const Float_t *variab
 
   /* check the groups structures are in place */
   if (fUseGroups) {
-    /* store also the group number */
-    FillBinAxesValues(variableContainer, fGroupMap[fChannelGroup[nChannel]]);
-    return fGroupValues->GetBin(fBinAxesValues);
+    /* the group number goes to the group axis */
+    return fGroupBinLocator.GetBin(variableContainer, fGroupMap[fChannelGroup[nChannel]]);
   }
   return -1;
 }
@@ -414,6 +493,9 @@ Float_t QnCorrectionsProfileChannelizedIngress::GetGrpBinContent(Long64_t bin) {
 
   /* check the groups structures are in place */
   if (fUseGroups) {
+    if (fUseQuantizedTables) {
+      return fQuantizedTables[2].Get(bin);
+    }
     return fGroupValues->GetBinContent(bin);
   }
   return 1.0;
@@ -430,6 +512,9 @@ Float_t QnCorrectionsProfileChannelizedIngress::GetGrpBinError(Long64_t bin) {
 
   /* check the groups structures are in place */
   if (fUseGroups) {
+    if (fUseQuantizedTables) {
+      return fQuantizedTables[3].Get(bin);
+    }
     return fGroupValues->GetBinError(bin);
   }
   return 1.0;
@@ -65,6 +65,8 @@ public:
   virtual Float_t GetGrpBinError(Long64_t bin);
 
 private:
+  void BuildQuantizedTables();
+
   THnF *fValues;              //!<! the values and errors on each event class and channel
   THnF *fGroupValues;         //!<! the values and errors on each event class and group
   THnC *fValidated;           //!<! bin content validated flag
@@ -78,6 +80,7 @@ private:
   Int_t fNoOfGroups;          //!<! the number of groups associated with the whole detector
   Int_t fActualNoOfGroups;    //!<! The actual number of groups handled by the histogram
   Int_t *fGroupMap;           //!<! array, the map from histo to detector channel group number
+  QnCorrectionsCoreEventClassBinning fGroupBinLocator; //!<! the event classes and group bin locator
 
 
   /// \cond CLASSIMP
@@ -176,7 +176,9 @@ Bool_t QnCorrectionsProfileComponents::CreateComponentsProfileHistograms(TList *
 
     /* and finally add the histograms to the list */
     histogramList->Add(fXValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fXValues[currentHarmonic]);
     histogramList->Add(fYValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fYValues[currentHarmonic]);
 
     /* and update the fully filled condition */
     fFullFilled |= harmonicNumberMask[currentHarmonic];
@@ -193,6 +195,7 @@ Bool_t QnCorrectionsProfileComponents::CreateComponentsProfileHistograms(TList *
 
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -234,6 +237,7 @@ Bool_t QnCorrectionsProfileComponents::AttachHistograms(TList *histogramList) {
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
   fFullFilled = 0x0000;
+  fUseQuantizedTables = kFALSE;
 
   fEntries = (THnI *) histogramList->FindObject((const char*) entriesHistoName);
   if (fEntries != NULL && fEntries->GetEntries() != 0) {
@@ -258,12 +262,51 @@ Bool_t QnCorrectionsProfileComponents::AttachHistograms(TList *histogramList) {
     return kFALSE;
 
   /* check that we actually got something */
-  if (fFullFilled != 0x0000)
+  if (fFullFilled != 0x0000) {
+    if (fContext->GetQuantizedTables()) {
+      BuildQuantizedTables();
+    }
     return kTRUE;
+  }
   else
     return kFALSE;
 }
 
+/// Builds the quantized tables of the final components averages and errors
+///
+/// Table 0 keeps the bins validity and, for each harmonic found, tables
+/// 4h to 4h+3 keep the X and Y averages and the X and Y errors. The
+/// values are taken from the full precision getters so the error mode
+/// and the non validated bins are already considered.
+void QnCorrectionsProfileComponents::BuildQuantizedTables() {
+  Long64_t nBins = fBinLocator.GetNLinearBins();
+  std::vector<Float_t> values(nBins);
+  Bool_t *valid = new Bool_t[nBins];
+
+  BeginQuantizedTables(4 * (nMaxHarmonicNumberSupported + 1));
+  for (Long64_t bin = 0; bin < nBins; bin++) {
+    valid[bin] = BinContentValidated(bin);
+  }
+  QuantizeTable(0, nBins, NULL, valid, "validity");
+  delete [] valid;
+
+  for (Int_t h = 1; h < nMaxHarmonicNumberSupported + 1; h++) {
+    if (fXValues[h] != NULL) {
+      for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXBinContent(h, bin);
+      QuantizeTable(4 * h, nBins, &values[0], NULL, Form("X h%d", h));
+      for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXBinError(h, bin);
+      QuantizeTable(4 * h + 2, nBins, &values[0], NULL, Form("X error h%d", h));
+    }
+    if (fYValues[h] != NULL) {
+      for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYBinContent(h, bin);
+      QuantizeTable(4 * h + 1, nBins, &values[0], NULL, Form("Y h%d", h));
+      for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYBinError(h, bin);
+      QuantizeTable(4 * h + 3, nBins, &values[0], NULL, Form("Y error h%d", h));
+    }
+  }
+  EndQuantizedTables();
+}
+
 /// Get the bin number for the current variable content
 ///
 /// The bin number identifies the event class the current
@@ -272,8 +315,7 @@ Bool_t QnCorrectionsProfileComponents::AttachHistograms(TList *histogramList) {
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfileComponents::GetBin(const Float_t *variableContainer) {
-  FillBinAxesValues(variableContainer);
-  return fEntries->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -284,6 +326,9 @@ Long64_t QnCorrectionsProfileComponents::GetBin(const Float_t *variableContainer
 /// \param bin the bin to check its content validity
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t QnCorrectionsProfileComponents::BinContentValidated(Long64_t bin) {
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[0].IsValid(bin);
+  }
   Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
 
   if (nEntries < fMinNoOfEntriesToValidate) {
@@ -311,6 +356,10 @@ Float_t QnCorrectionsProfileComponents::GetXBinContent(Int_t harmonic, Long64_t
     return 0.0;
   }
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[4 * harmonic + 0].Get(bin);
+  }
+
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -337,6 +386,10 @@ Float_t QnCorrectionsProfileComponents::GetYBinContent(Int_t harmonic, Long64_t
     return 0.0;
   }
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[4 * harmonic + 1].Get(bin);
+  }
+
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -363,6 +416,10 @@ Float_t QnCorrectionsProfileComponents::GetXBinError(Int_t harmonic, Long64_t bi
     return 0.0;
   }
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[4 * harmonic + 2].Get(bin);
+  }
+
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -405,6 +462,10 @@ Float_t QnCorrectionsProfileComponents::GetYBinError(Int_t harmonic, Long64_t bi
     return 0.0;
   }
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[4 * harmonic + 3].Get(bin);
+  }
+
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -454,12 +515,8 @@ void QnCorrectionsProfileComponents::FillX(Int_t harmonic, const Float_t *variab
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXValues[harmonic]->Fill(fBinAxesValues, weight);
-  fXValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fXValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fXharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -468,7 +525,7 @@ void QnCorrectionsProfileComponents::FillX(Int_t harmonic, const Float_t *variab
   if (fXharmonicFillMask != fFullFilled) return;
   if (fYharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
 }
@@ -497,12 +554,8 @@ void QnCorrectionsProfileComponents::FillY(Int_t harmonic, const Float_t *variab
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYValues[harmonic]->Fill(fBinAxesValues, weight);
-  fYValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fYValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fYharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -511,7 +564,7 @@ void QnCorrectionsProfileComponents::FillY(Int_t harmonic, const Float_t *variab
   if (fYharmonicFillMask != fFullFilled) return;
   if (fXharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXharmonicFillMask = 0x0000;
   fYharmonicFillMask = 0x0000;
 }
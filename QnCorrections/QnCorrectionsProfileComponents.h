@@ -68,6 +68,8 @@ public:
   virtual void FillY(Int_t harmonic, const Float_t *variableContainer, Float_t weight);
 
 private:
+  void BuildQuantizedTables();
+
   THnF **fXValues;            //!<! X component histogram for each requested harmonic
   THnF **fYValues;            //!<! Y component histogram for each requested harmonic
   UInt_t fXharmonicFillMask;  //!<! keeps track of harmonic X component filled values
@@ -148,9 +148,13 @@ Bool_t QnCorrectionsProfileCorrelationComponents::CreateCorrelationComponentsPro
 
   /* and finally add the histograms to the list */
   histogramList->Add(fXXValues);
+  AddSubsamplesHistogram(histogramList, fXXValues);
   histogramList->Add(fXYValues);
+  AddSubsamplesHistogram(histogramList, fXYValues);
   histogramList->Add(fYXValues);
+  AddSubsamplesHistogram(histogramList, fYXValues);
   histogramList->Add(fYYValues);
+  AddSubsamplesHistogram(histogramList, fYYValues);
 
   /* and store the fully filled condition */
   fXXXYYXYYFillMask = 0x0000;
@@ -167,6 +171,7 @@ Bool_t QnCorrectionsProfileCorrelationComponents::CreateCorrelationComponentsPro
 
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -208,6 +213,7 @@ Bool_t QnCorrectionsProfileCorrelationComponents::AttachHistograms(TList *histog
 
   fXXXYYXYYFillMask = 0x0000;
   fFullFilled = 0x0000;
+  fUseQuantizedTables = kFALSE;
 
   fEntries = (THnI *) histogramList->FindObject((const char*) entriesHistoName);
   if (fEntries != NULL && fEntries->GetEntries() != 0) {
@@ -225,12 +231,53 @@ Bool_t QnCorrectionsProfileCorrelationComponents::AttachHistograms(TList *histog
     return kFALSE;
 
   /* check that we actually got something */
-  if (fFullFilled != 0x0000)
+  if (fFullFilled != 0x0000) {
+    if (fContext->GetQuantizedTables()) {
+      BuildQuantizedTables();
+    }
     return kTRUE;
+  }
   else
     return kFALSE;
 }
 
+/// Builds the quantized tables of the final correlation components averages and errors
+///
+/// Table 0 keeps the bins validity, tables 1 to 4 the XX, XY, YX and YY
+/// averages and tables 5 to 8 their errors. The values are taken from
+/// the full precision getters so the error mode and the non validated
+/// bins are already considered.
+void QnCorrectionsProfileCorrelationComponents::BuildQuantizedTables() {
+  Long64_t nBins = fBinLocator.GetNLinearBins();
+  std::vector<Float_t> values(nBins);
+  Bool_t *valid = new Bool_t[nBins];
+
+  BeginQuantizedTables(9);
+  for (Long64_t bin = 0; bin < nBins; bin++) {
+    valid[bin] = BinContentValidated(bin);
+  }
+  QuantizeTable(0, nBins, NULL, valid, "validity");
+  delete [] valid;
+
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXXBinContent(bin);
+  QuantizeTable(1, nBins, &values[0], NULL, "XX");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXYBinContent(bin);
+  QuantizeTable(2, nBins, &values[0], NULL, "XY");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYXBinContent(bin);
+  QuantizeTable(3, nBins, &values[0], NULL, "YX");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYYBinContent(bin);
+  QuantizeTable(4, nBins, &values[0], NULL, "YY");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXXBinError(bin);
+  QuantizeTable(5, nBins, &values[0], NULL, "XX error");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetXYBinError(bin);
+  QuantizeTable(6, nBins, &values[0], NULL, "XY error");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYXBinError(bin);
+  QuantizeTable(7, nBins, &values[0], NULL, "YX error");
+  for (Long64_t bin = 0; bin < nBins; bin++) values[bin] = GetYYBinError(bin);
+  QuantizeTable(8, nBins, &values[0], NULL, "YY error");
+  EndQuantizedTables();
+}
+
 /// Get the bin number for the current variable content
 ///
 /// The bin number identifies the event class the current
@@ -239,8 +286,7 @@ Bool_t QnCorrectionsProfileCorrelationComponents::AttachHistograms(TList *histog
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfileCorrelationComponents::GetBin(const Float_t *variableContainer) {
-  FillBinAxesValues(variableContainer);
-  return fEntries->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -251,6 +297,9 @@ Long64_t QnCorrectionsProfileCorrelationComponents::GetBin(const Float_t *variab
 /// \param bin the bin to check its content validity
 /// \return kTRUE if the content is valid kFALSE otherwise
 Bool_t QnCorrectionsProfileCorrelationComponents::BinContentValidated(Long64_t bin) {
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[0].IsValid(bin);
+  }
   Int_t nEntries = Int_t(fEntries->GetBinContent(bin));
 
   if (nEntries < fMinNoOfEntriesToValidate) {
@@ -270,6 +319,9 @@ Bool_t QnCorrectionsProfileCorrelationComponents::BinContentValidated(Long64_t b
 /// \return the bin number content
 Float_t QnCorrectionsProfileCorrelationComponents::GetXXBinContent(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[1].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -288,6 +340,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetXXBinContent(Long64_t bin)
 /// \return the bin number content
 Float_t QnCorrectionsProfileCorrelationComponents::GetXYBinContent(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[2].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -306,6 +361,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetXYBinContent(Long64_t bin)
 /// \return the bin number content
 Float_t QnCorrectionsProfileCorrelationComponents::GetYXBinContent(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[3].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -324,6 +382,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetYXBinContent(Long64_t bin)
 /// \return the bin number content
 Float_t QnCorrectionsProfileCorrelationComponents::GetYYBinContent(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[4].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -342,6 +403,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetYYBinContent(Long64_t bin)
 /// \return the bin content error
 Float_t QnCorrectionsProfileCorrelationComponents::GetXXBinError(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[5].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -376,6 +440,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetXXBinError(Long64_t bin) {
 /// \return the bin content error
 Float_t QnCorrectionsProfileCorrelationComponents::GetXYBinError(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[6].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -410,6 +477,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetXYBinError(Long64_t bin) {
 /// \return the bin content error
 Float_t QnCorrectionsProfileCorrelationComponents::GetYXBinError(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[7].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -444,6 +514,9 @@ Float_t QnCorrectionsProfileCorrelationComponents::GetYXBinError(Long64_t bin) {
 /// \return the bin content error
 Float_t QnCorrectionsProfileCorrelationComponents::GetYYBinError(Long64_t bin) {
 
+  if (fUseQuantizedTables) {
+    return fQuantizedTables[8].Get(bin);
+  }
   if (!BinContentValidated(bin)) {
     return 0.0;
   }
@@ -488,12 +561,8 @@ void QnCorrectionsProfileCorrelationComponents::FillXX(const Float_t *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXXValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXXValues->Fill(fBinAxesValues, weight);
-  fXXValues->SetEntries(nEntries + 1);
+  FillHistogram(fXXValues, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationXXmask;
@@ -501,7 +570,7 @@ void QnCorrectionsProfileCorrelationComponents::FillXX(const Float_t *variableCo
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
@@ -524,12 +593,8 @@ void QnCorrectionsProfileCorrelationComponents::FillXY(const Float_t *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXYValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXYValues->Fill(fBinAxesValues, weight);
-  fXYValues->SetEntries(nEntries + 1);
+  FillHistogram(fXYValues, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationXYmask;
@@ -537,7 +602,7 @@ void QnCorrectionsProfileCorrelationComponents::FillXY(const Float_t *variableCo
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
@@ -560,12 +625,8 @@ void QnCorrectionsProfileCorrelationComponents::FillYX(const Float_t *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYXValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYXValues->Fill(fBinAxesValues, weight);
-  fYXValues->SetEntries(nEntries + 1);
+  FillHistogram(fYXValues, weight);
 
   /* update fill mask */
   fXXXYYXYYFillMask |= correlationYXmask;
@@ -573,7 +634,7 @@ void QnCorrectionsProfileCorrelationComponents::FillYX(const Float_t *variableCo
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
@@ -596,12 +657,8 @@ void QnCorrectionsProfileCorrelationComponents::FillYY(const Float_t *variableCo
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYYValues->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYYValues->Fill(fBinAxesValues, weight);
-  fYYValues->SetEntries(nEntries + 1);
+  FillHistogram(fYYValues, weight);
 
   /* update harmonic fill mask */
   fXXXYYXYYFillMask |= correlationYYmask;
@@ -609,7 +666,7 @@ void QnCorrectionsProfileCorrelationComponents::FillYY(const Float_t *variableCo
   /* now check if time for updating entries histogram */
   if (fXXXYYXYYFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXXYYXYYFillMask = 0x0000;
 }
 
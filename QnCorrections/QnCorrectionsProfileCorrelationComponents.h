@@ -97,6 +97,8 @@ public:
   { return QnCorrectionsHistogramBase::FillYY(harmonic, variableContainer, weight); }
 
 private:
+  void BuildQuantizedTables();
+
   THnF *fXXValues;            //!<! XX component histogram
   THnF *fXYValues;            //!<! XY component histogram
   THnF *fYXValues;            //!<! YX component histogram
@@ -217,9 +217,13 @@ Bool_t QnCorrectionsProfileCorrelationComponentsHarmonics::CreateCorrelationComp
 
     /* and finally add the histograms to the list */
     histogramList->Add(fXXValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fXXValues[currentHarmonic]);
     histogramList->Add(fXYValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fXYValues[currentHarmonic]);
     histogramList->Add(fYXValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fYXValues[currentHarmonic]);
     histogramList->Add(fYYValues[currentHarmonic]);
+    AddSubsamplesHistogram(histogramList, fYYValues[currentHarmonic]);
 
     /* and update the fully filled condition */
     fFullFilled |= harmonicNumberMask[currentHarmonic];
@@ -236,6 +240,7 @@ Bool_t QnCorrectionsProfileCorrelationComponentsHarmonics::CreateCorrelationComp
 
   /* and finally add the entries histogram to the list */
   histogramList->Add(fEntries);
+  AddSubsamplesHistogram(histogramList, fEntries);
 
   delete [] minvals;
   delete [] maxvals;
@@ -334,8 +339,7 @@ Bool_t QnCorrectionsProfileCorrelationComponentsHarmonics::AttachHistograms(TLis
 /// \param variableContainer the current variables content addressed by var Id
 /// \return the associated bin to the current variables content
 Long64_t QnCorrectionsProfileCorrelationComponentsHarmonics::GetBin(const Float_t *variableContainer) {
-  FillBinAxesValues(variableContainer);
-  return fEntries->GetBin(fBinAxesValues);
+  return fBinLocator.GetBin(variableContainer);
 }
 
 /// Check the validity of the content of the passed bin
@@ -652,12 +656,8 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillXX(Int_t harmonic,
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXXValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXXValues[harmonic]->Fill(fBinAxesValues, weight);
-  fXXValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fXXValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fXXharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -668,7 +668,7 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillXX(Int_t harmonic,
   if (fYXharmonicFillMask != fFullFilled) return;
   if (fYYharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXharmonicFillMask = 0x0000;
   fXYharmonicFillMask = 0x0000;
   fYXharmonicFillMask = 0x0000;
@@ -699,12 +699,8 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillXY(Int_t harmonic,
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fXYValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fXYValues[harmonic]->Fill(fBinAxesValues, weight);
-  fXYValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fXYValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fXYharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -715,7 +711,7 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillXY(Int_t harmonic,
   if (fYXharmonicFillMask != fFullFilled) return;
   if (fYYharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXharmonicFillMask = 0x0000;
   fXYharmonicFillMask = 0x0000;
   fYXharmonicFillMask = 0x0000;
@@ -746,12 +742,8 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillYX(Int_t harmonic,
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYXValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYXValues[harmonic]->Fill(fBinAxesValues, weight);
-  fYXValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fYXValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fYXharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -762,7 +754,7 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillYX(Int_t harmonic,
   if (fYXharmonicFillMask != fFullFilled) return;
   if (fYYharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXharmonicFillMask = 0x0000;
   fXYharmonicFillMask = 0x0000;
   fYXharmonicFillMask = 0x0000;
@@ -793,12 +785,8 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillYY(Int_t harmonic,
 
   /* now it's safe to continue */
 
-  /* keep total entries in fValues updated */
-  Double_t nEntries = fYYValues[harmonic]->GetEntries();
-
   FillBinAxesValues(variableContainer);
-  fYYValues[harmonic]->Fill(fBinAxesValues, weight);
-  fYYValues[harmonic]->SetEntries(nEntries + 1);
+  FillHistogram(fYYValues[harmonic], weight);
 
   /* update harmonic fill mask */
   fYYharmonicFillMask |= harmonicNumberMask[harmonic];
@@ -809,7 +797,7 @@ void QnCorrectionsProfileCorrelationComponentsHarmonics::FillYY(Int_t harmonic,
   if (fYXharmonicFillMask != fFullFilled) return;
   if (fYYharmonicFillMask != fFullFilled) return;
   /* update entries and reset the masks */
-  fEntries->Fill(fBinAxesValues, 1.0);
+  FillHistogram(fEntries, 1.0);
   fXXharmonicFillMask = 0x0000;
   fXYharmonicFillMask = 0x0000;
   fYXharmonicFillMask = 0x0000;
@@ -297,6 +297,43 @@ void QnCorrectionsQnVector::Set(QnCorrectionsQnVector* Qn, Bool_t changename) {
   }
 }
 
+/// Copy the values from a core engine Q vector
+///
+/// The harmonic structures are compared. A run time error is
+/// raised if they do not match.
+/// \param Qn the core engine Q vector to be copied
+void QnCorrectionsQnVector::SetFromCoreQnVector(const QnCorrectionsCoreQnVector &Qn) {
+  if ((fHarmonicMask != Qn.GetHarmonicMask()) ||
+      (fHarmonicMultiplier != Qn.GetHarmonicMultiplier())) {
+    QnCorrectionsFatal("You requested set a Q vector with the values of a core Q " \
+        "vector but the harmonic structures do not match");
+    return;
+  }
+  memcpy(fQnX, Qn.GetQx(), (MAXHARMONICNUMBERSUPPORTED + 1)*sizeof(Float_t));
+  memcpy(fQnY, Qn.GetQy(), (MAXHARMONICNUMBERSUPPORTED + 1)*sizeof(Float_t));
+  fGoodQuality = Qn.IsGoodQuality();
+  fN = Qn.GetN();
+  fSumW = Qn.GetSumOfWeights();
+}
+
+/// Fills a core engine Q vector with the structure and values of this one
+///
+/// The harmonic structure of the passed core Q vector is rebuilt.
+/// \param Qn the core engine Q vector to fill
+void QnCorrectionsQnVector::FillCoreQnVector(QnCorrectionsCoreQnVector &Qn) const {
+  Qn = QnCorrectionsCoreQnVector();
+  Qn.SetHarmonicMultiplier(fHarmonicMultiplier);
+  for(Int_t h = 1; h < fHighestHarmonic + 1; h++){
+    if ((fHarmonicMask & harmonicNumberMask[h]) == harmonicNumberMask[h]) {
+      Qn.ActivateHarmonic(h);
+      Qn.SetQx(h, fQnX[h]);
+      Qn.SetQy(h, fQnY[h]);
+    }
+  }
+  Qn.SetGood(fGoodQuality);
+  Qn.SetCounters(fN, fSumW);
+}
+
 /// Normalize the Q vector to unit length
 ///
 void QnCorrectionsQnVector::Normalize() {
@@ -16,6 +16,7 @@
 
 #include <TNamed.h>
 #include <TMath.h>
+#include "QnCorrectionsCoreQnVector.h"
 
 /// The maximum external harmonic number the framework currently support for Q vectors
 #define MAXHARMONICNUMBERSUPPORTED 15
@@ -86,6 +87,8 @@ public:
   virtual void SetHarmonicMultiplier(Int_t m) { fHarmonicMultiplier = m; }
 
   void Set(QnCorrectionsQnVector* Qn, Bool_t changename);
+  void SetFromCoreQnVector(const QnCorrectionsCoreQnVector &Qn);
+  void FillCoreQnVector(QnCorrectionsCoreQnVector &Qn) const;
 
   void Normalize();
   /// Provides the length of the Q vector for the considered harmonic
@@ -37,6 +37,7 @@
 #include "QnCorrectionsHistogramSparse.h"
 #include "QnCorrectionsDetector.h"
 #include "QnCorrectionsManager.h"
+#include "QnCorrectionsCoreCorrectionKernels.h"
 #include "QnCorrectionsLog.h"
 #include "QnCorrectionsQnVectorAlignment.h"
 
@@ -59,6 +60,7 @@ QnCorrectionsQnVectorAlignment::QnCorrectionsQnVectorAlignment() :
     QnCorrectionsCorrectionOnQvector(szCorrectionName, szKey),
     fDetectorConfigurationForAlignmentName() {
   fInputHistograms = NULL;
+  fStagedInputHistograms = NULL;
   fCalibrationHistograms = NULL;
   fQANotValidatedBin = NULL;
   fQAQnAverageHistogram = NULL;
@@ -72,6 +74,8 @@ QnCorrectionsQnVectorAlignment::QnCorrectionsQnVectorAlignment() :
 QnCorrectionsQnVectorAlignment::~QnCorrectionsQnVectorAlignment() {
   if (fInputHistograms != NULL)
     delete fInputHistograms;
+  if (fStagedInputHistograms != NULL)
+    delete fStagedInputHistograms;
   if (fCalibrationHistograms != NULL)
     delete fCalibrationHistograms;
   if (fQANotValidatedBin != NULL)
@@ -123,17 +127,13 @@ void QnCorrectionsQnVectorAlignment::CreateSupportDataStructures() {
         fDetectorConfiguration->GetName()));
   }
 
-  Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
-  Int_t *harmonicsMap = new Int_t[nNoOfHarmonics];
   /* make sure the alignment harmonic processing is active */
   fDetectorConfiguration->ActivateHarmonic(fHarmonicForAlignment);
   /* in both configurations */
   fDetectorConfigurationForAlignment->ActivateHarmonic(fHarmonicForAlignment);
-  /* and now create the corrected Qn vector */
-  fDetectorConfiguration->GetHarmonicMap(harmonicsMap);
-  fCorrectedQnVector = new QnCorrectionsQnVector(szCorrectedQnVectorName, nNoOfHarmonics, harmonicsMap);
+  /* and now create the corrected Qn vector in the detector configuration hot data */
+  fCorrectedQnVector = fDetectorConfiguration->NewCorrectionStepQnVector(szCorrectedQnVectorName);
   fInputQnVector = fDetectorConfiguration->GetPreviousCorrectedQnVector(this);
-  delete [] harmonicsMap;
 }
 
 /// Asks for support histograms creation
@@ -155,9 +155,11 @@ Bool_t QnCorrectionsQnVectorAlignment::CreateSupportHistograms(TList *list) {
   if (fInputHistograms != NULL) delete fInputHistograms;
   fInputHistograms = new QnCorrectionsProfileCorrelationComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
   fCalibrationHistograms = new QnCorrectionsProfileCorrelationComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fCalibrationHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
 
   fCalibrationHistograms->CreateCorrelationComponentsProfileHistograms(list);
   return kTRUE;
@@ -175,6 +177,53 @@ Bool_t QnCorrectionsQnVectorAlignment::AttachInput(TList *list) {
   return kFALSE;
 }
 
+/// Stages the input information found in a new calibration for a later swap
+///
+/// Only if the correction step is being applied new input information
+/// is staged. The new histograms are attached to the passed list which
+/// should be kept until the staged information is swapped or discarded.
+/// \param list list where the new inputs should be found, NULL if not present
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorAlignment::StageInput(TList *list) {
+
+  if (!IsBeingApplied()) return kTRUE;
+  if (list == NULL) return kFALSE;
+
+  TString histoNameAndTitle = TString::Format("%s %s#times%s ",
+      szSupportHistogramName,
+      fDetectorConfiguration->GetName(),
+      fDetectorConfigurationForAlignment->GetName());
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = new QnCorrectionsProfileCorrelationComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
+      fDetectorConfiguration->GetEventClassVariablesSet());
+  fStagedInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
+  fStagedInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (fStagedInputHistograms->AttachHistograms(list)) {
+    return kTRUE;
+  }
+  delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+  return kFALSE;
+}
+
+/// Replaces the input information in use by the staged one if any
+void QnCorrectionsQnVectorAlignment::SwapStagedInput() {
+
+  if (fStagedInputHistograms != NULL) {
+    delete fInputHistograms;
+    fInputHistograms = fStagedInputHistograms;
+    fStagedInputHistograms = NULL;
+  }
+}
+
+/// Deletes the staged input information if any
+void QnCorrectionsQnVectorAlignment::DiscardStagedInput() {
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+}
+
 /// Asks for QA histograms creation
 ///
 /// Allocates the histogram objects and creates the QA histograms.
@@ -186,6 +235,7 @@ Bool_t QnCorrectionsQnVectorAlignment::CreateQAHistograms(TList *list) {
       TString::Format("%s %s", szQAQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
       TString::Format("%s %s", szQAQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fQAQnAverageHistogram->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
 
   /* get information about the configured harmonics to pass it for histogram creation */
   Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
@@ -207,6 +257,7 @@ Bool_t QnCorrectionsQnVectorAlignment::CreateNveQAHistograms(TList *list) {
       TString::Format("%s %s", szQANotValidatedHistogramName, fDetectorConfiguration->GetName()).Data(),
       TString::Format("%s %s", szQANotValidatedHistogramName, fDetectorConfiguration->GetName()).Data(),
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fQANotValidatedBin->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fQANotValidatedBin->CreateHistogram(list);
   return kTRUE;
 }
@@ -216,6 +267,7 @@ Bool_t QnCorrectionsQnVectorAlignment::CreateNveQAHistograms(TList *list) {
 /// Apply the correction step
 /// \return kTRUE if the correction step was applied
 Bool_t QnCorrectionsQnVectorAlignment::ProcessCorrections(const Float_t *variableContainer) {
+  QnCorrectionsQnVector *currentQnVector = fDetectorConfiguration->GetCurrentQnVector();
   switch (fState) {
   case QCORRSTEP_calibration:
     /* collect the data needed to further produce correction parameters if both current Qn vectors are good enough */
@@ -230,9 +282,8 @@ Bool_t QnCorrectionsQnVectorAlignment::ProcessCorrections(const Float_t *variabl
     QnCorrectionsInfo(TString::Format("Alignment process in detector %s with reference %s: applying correction.",
         fDetectorConfiguration->GetName(),
         fDetectorConfigurationForAlignment->GetName()).Data());
-    if (fDetectorConfiguration->GetCurrentQnVector()->IsGoodQuality()) {
-      /* we get the properties of the current Qn vector but its name */
-      fCorrectedQnVector->Set(fDetectorConfiguration->GetCurrentQnVector(),kFALSE);
+    if (currentQnVector->IsGoodQuality()) {
+      /* the current Qn vector is corrected in place */
 
       /* let's check the correction histograms */
       Long64_t bin = fInputHistograms->GetBin(variableContainer);
@@ -245,19 +296,18 @@ Bool_t QnCorrectionsQnVectorAlignment::ProcessCorrections(const Float_t *variabl
         Double_t eXY = fInputHistograms->GetXYBinError(bin);
         Double_t eYX = fInputHistograms->GetYXBinError(bin);
 
-        Double_t deltaPhi = - TMath::ATan2((XY-YX),(XX+YY)) * (1.0 / fHarmonicForAlignment);
+        Double_t deltaPhi;
 
         /* significant correction? */
-        if (!(TMath::Sqrt((XY-YX)*(XY-YX)/(eXY*eXY+eYX*eYX)) < 2.0)) {
-          Int_t harmonic = fDetectorConfiguration->GetCurrentQnVector()->GetFirstHarmonic();
+        if (QnCorrectionsCoreCorrectionKernels::AlignmentAngle(XX, YY, XY, YX, eXY, eYX, fHarmonicForAlignment, deltaPhi)) {
+          Int_t harmonic = currentQnVector->GetFirstHarmonic();
           while (harmonic != -1) {
-            fCorrectedQnVector->SetQx(harmonic,
-                fDetectorConfiguration->GetCurrentQnVector()->Qx(harmonic) * TMath::Cos(((Double_t) harmonic) * deltaPhi)
-                + fDetectorConfiguration->GetCurrentQnVector()->Qy(harmonic) * TMath::Sin (((Double_t) harmonic) * deltaPhi));
-            fCorrectedQnVector->SetQy(harmonic,
-                fDetectorConfiguration->GetCurrentQnVector()->Qy(harmonic) * TMath::Cos(((Double_t) harmonic) * deltaPhi)
-                - fDetectorConfiguration->GetCurrentQnVector()->Qx(harmonic) * TMath::Sin (((Double_t) harmonic) * deltaPhi));
-            harmonic = fDetectorConfiguration->GetCurrentQnVector()->GetNextHarmonic(harmonic);
+            Float_t qx = currentQnVector->Qx(harmonic);
+            Float_t qy = currentQnVector->Qy(harmonic);
+            QnCorrectionsCoreCorrectionKernels::Rotate(qx, qy, harmonic, deltaPhi);
+            currentQnVector->SetQx(harmonic, qx);
+            currentQnVector->SetQy(harmonic, qy);
+            harmonic = currentQnVector->GetNextHarmonic(harmonic);
           }
         } /* if the correction is not significant we leave the Q vector untouched */
       } /* if the correction bin is not validated we leave the Q vector untouched */
@@ -267,10 +317,13 @@ Bool_t QnCorrectionsQnVectorAlignment::ProcessCorrections(const Float_t *variabl
     }
     else {
       /* not done! input Q vector with bad quality */
-      fCorrectedQnVector->SetGood(kFALSE);
+      currentQnVector->Reset();
     }
-    /* and update the current Qn vector */
-    fDetectorConfiguration->UpdateCurrentQnVector(fCorrectedQnVector);
+    /* keep track of the correction on the current Qn vector */
+    fDetectorConfiguration->TagCurrentQnVector(fCorrectedQnVector);
+    /* and keep the step snapshot only if someone will read it */
+    if (fKeepCorrectedQnVector || (fQAQnAverageHistogram != NULL))
+      fCorrectedQnVector->Set(currentQnVector, kFALSE);
     break;
   default:
     /* we are in passive state waiting for proper conditions, no corrections applied */
@@ -42,6 +42,8 @@ public:
 
   void Add(QnCorrectionsQnVectorBuild* qvec);
   void Add(Double_t phi, Double_t weight = 1.0);
+  void Add(const Double_t *weightedCos, const Double_t *weightedSin, Double_t weight);
+  void AddFromBasis(const Double_t *cosTerms, const Double_t *sinTerms, Double_t weight);
 
   /// Check the quality of the constructed Qn vector
   /// Current criteria is number of contributors should be at least one.
@@ -88,6 +90,55 @@ inline void QnCorrectionsQnVectorBuild::Add(Double_t phi, Double_t weight) {
   fN += 1;
 }
 
+/// Adds a contribution already expanded in its harmonic terms
+///
+/// Same as Add(phi, weight) but the weighted cosine and sine terms
+/// are given already evaluated, indexed by the harmonic number times the
+/// harmonic multiplier, so that they can be shared among several Q vectors
+/// built from the same contribution. It is responsibility of the caller
+/// to provide the terms up to the highest harmonic times the harmonic multiplier.
+/// A check for weight significant value is made. Not passing it ignores the contribution.
+/// \param weightedCos the weighted cosine terms, $ w \cos(k \varphi) $ at index k
+/// \param weightedSin the weighted sine terms, $ w \sin(k \varphi) $ at index k
+/// \param weight the weight of the contribution
+inline void QnCorrectionsQnVectorBuild::Add(const Double_t *weightedCos, const Double_t *weightedSin, Double_t weight) {
+
+  if (weight < fMinimumSignificantValue) return;
+  for(Int_t h = 1; h < fHighestHarmonic + 1; h++){
+    if ((fHarmonicMask & harmonicNumberMask[h]) == harmonicNumberMask[h]) {
+      fQnX[h] += weightedCos[h*fHarmonicMultiplier];
+      fQnY[h] += weightedSin[h*fHarmonicMultiplier];
+    }
+  }
+  fSumW += weight;
+  fN += 1;
+}
+
+/// Adds a contribution from its precomputed harmonic basis terms
+///
+/// Same as Add(phi, weight) but the not weighted cosine and sine terms
+/// are given already evaluated, indexed by the harmonic number times the
+/// harmonic multiplier, so that they are evaluated once for all the Q vectors
+/// built from the same data vector whatever their weights. It is responsibility
+/// of the caller to provide the terms up to the highest harmonic times the
+/// harmonic multiplier.
+/// A check for weight significant value is made. Not passing it ignores the contribution.
+/// \param cosTerms the cosine terms, $ \cos(k \varphi) $ at index k
+/// \param sinTerms the sine terms, $ \sin(k \varphi) $ at index k
+/// \param weight the weight of the contribution
+inline void QnCorrectionsQnVectorBuild::AddFromBasis(const Double_t *cosTerms, const Double_t *sinTerms, Double_t weight) {
+
+  if (weight < fMinimumSignificantValue) return;
+  for(Int_t h = 1; h < fHighestHarmonic + 1; h++){
+    if ((fHarmonicMask & harmonicNumberMask[h]) == harmonicNumberMask[h]) {
+      fQnX[h] += (weight * cosTerms[h*fHarmonicMultiplier]);
+      fQnY[h] += (weight * sinTerms[h*fHarmonicMultiplier]);
+    }
+  }
+  fSumW += weight;
+  fN += 1;
+}
+
 
 /// Calibrates the Q vector according to the method passed
 /// \param method the method of calibration
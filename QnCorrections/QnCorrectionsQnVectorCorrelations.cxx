@@ -0,0 +1,166 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsQnVectorCorrelations.cxx
+/// \brief Implementation of the correlations of the corrected Qn vectors of a set of detector configurations
+
+#include "QnCorrectionsQnVectorCorrelations.h"
+#include "QnCorrectionsManager.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsQnVectorCorrelations);
+/// \endcond
+
+const Int_t QnCorrectionsQnVectorCorrelations::nMaxNoOfConfigurations = 3;
+
+/// Default constructor
+QnCorrectionsQnVectorCorrelations::QnCorrectionsQnVectorCorrelations() : TNamed() {
+
+  fEventClassVariables = NULL;
+  fNoOfHarmonics = 0;
+  fHarmonicMap = NULL;
+  fNoOfConfigurations = 0;
+  for (Int_t ix = 0; ix < nMaxNoOfConfigurations; ix++) {
+    fConfigurations[ix] = NULL;
+    fCorrelations[ix] = NULL;
+  }
+}
+
+/// Normal constructor
+///
+/// The correlated detector configurations are given afterwards with
+/// SetDetectorConfigurations.
+/// \param name the name of the correlations, also for its histograms list
+/// \param eventClassesVariables the set of event classes variables the correlations are profiled against
+/// \param nNoOfHarmonics the number of harmonics to correlate
+/// \param harmonicMap an optional ordered array with the harmonic numbers
+QnCorrectionsQnVectorCorrelations::QnCorrectionsQnVectorCorrelations(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap) :
+          TNamed(name,name) {
+
+  fEventClassVariables = eventClassesVariables;
+  fNoOfHarmonics = nNoOfHarmonics;
+  fHarmonicMap = new Int_t[fNoOfHarmonics];
+  for (Int_t h = 0; h < fNoOfHarmonics; h++) {
+    fHarmonicMap[h] = (harmonicMap != NULL) ? harmonicMap[h] : h + 1;
+  }
+  fNoOfConfigurations = 0;
+  for (Int_t ix = 0; ix < nMaxNoOfConfigurations; ix++) {
+    fConfigurations[ix] = NULL;
+    fCorrelations[ix] = NULL;
+  }
+}
+
+/// Default destructor
+///
+/// The profiles histograms are owned by the histograms list
+QnCorrectionsQnVectorCorrelations::~QnCorrectionsQnVectorCorrelations() {
+  if (fHarmonicMap != NULL) {
+    delete [] fHarmonicMap;
+  }
+  for (Int_t pair = 0; pair < nMaxNoOfConfigurations; pair++) {
+    if (fCorrelations[pair] != NULL) {
+      delete fCorrelations[pair];
+    }
+  }
+}
+
+/// Sets the detector configurations to correlate
+///
+/// With two detector configurations the pair AB is profiled. With
+/// three of them the pairs AB, AC and BC are profiled.
+/// \param nameA the name of the first detector configuration
+/// \param nameB the name of the second detector configuration
+/// \param nameC the name of the optional third detector configuration
+void QnCorrectionsQnVectorCorrelations::SetDetectorConfigurations(const char *nameA, const char *nameB, const char *nameC) {
+  fConfigurationsNames[0] = nameA;
+  fConfigurationsNames[1] = nameB;
+  fNoOfConfigurations = 2;
+  if (nameC != NULL) {
+    fConfigurationsNames[2] = nameC;
+    fNoOfConfigurations = 3;
+  }
+}
+
+/// Locates the correlated detector configurations within the framework
+///
+/// Raise an execution error if any of them is not found.
+/// \param manager the framework manager
+/// \return kTRUE if all the detector configurations were found
+Bool_t QnCorrectionsQnVectorCorrelations::AttachDetectorConfigurations(QnCorrectionsManager *manager) {
+  if (fNoOfConfigurations < 2) {
+    QnCorrectionsFatal(Form("Qn vector correlations %s without detector configurations to correlate. FIX IT, PLEASE.", GetName()));
+    return kFALSE;
+  }
+  for (Int_t ix = 0; ix < fNoOfConfigurations; ix++) {
+    fConfigurations[ix] = manager->FindDetectorConfiguration(fConfigurationsNames[ix].Data());
+    if (fConfigurations[ix] == NULL) {
+      QnCorrectionsFatal(Form("Qn vector correlations %s requires the detector configuration %s which is not defined. FIX IT, PLEASE.",
+          GetName(), fConfigurationsNames[ix].Data()));
+      return kFALSE;
+    }
+  }
+  return kTRUE;
+}
+
+/// Creates the correlation components profiles of the pairs
+///
+/// The histograms are incorporated to a list named after the correlations
+/// which is added to the passed list.
+/// \param list list where the correlations histograms list should be added
+/// \param context the histograms context of the framework manager
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorCorrelations::CreateCorrelationsHistograms(TList *list, QnCorrectionsHistogramsContext *context) {
+  TList *correlationsList = new TList();
+  correlationsList->SetName(GetName());
+  correlationsList->SetOwner(kTRUE);
+
+  for (Int_t pair = 0; pair < GetNoOfPairs(); pair++) {
+    TString pairName = Form("%s_%s",
+        fConfigurationsNames[GetPairFirst(pair)].Data(),
+        fConfigurationsNames[GetPairSecond(pair)].Data());
+    fCorrelations[pair] = new QnCorrectionsProfileCorrelationComponentsHarmonics(pairName.Data(), pairName.Data(), *fEventClassVariables);
+    fCorrelations[pair]->SetHistogramsContext(context);
+    fCorrelations[pair]->CreateCorrelationComponentsProfileHistograms(correlationsList, fNoOfHarmonics, fHarmonicMap);
+  }
+  list->Add(correlationsList);
+  return kTRUE;
+}
+
+/// Registers the variables Ids the correlations read from the variables
+/// bank for their remapping into a dense variables bank
+/// \param bank the variables bank remapper
+void QnCorrectionsQnVectorCorrelations::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  if (fEventClassVariables != NULL) fEventClassVariables->RegisterDataVariables(bank);
+}
@@ -0,0 +1,127 @@
+#ifndef QNCORRECTIONS_QNVECTORCORRELATIONS_H
+#define QNCORRECTIONS_QNVECTORCORRELATIONS_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsQnVectorCorrelations.h
+/// \brief Correlations of the corrected Qn vectors of a set of detector configurations
+
+#include <TNamed.h>
+#include <TString.h>
+#include <TList.h>
+
+#include "QnCorrectionsEventClassVariablesSet.h"
+#include "QnCorrectionsProfileCorrelationComponentsHarmonics.h"
+#include "QnCorrectionsDetectorConfigurationBase.h"
+
+class QnCorrectionsManager;
+
+/// \class QnCorrectionsQnVectorCorrelations
+/// \brief Accumulates the correlations of the corrected Qn vectors of two or three detector configurations
+///
+/// Scalar product and event plane resolution studies need, versus the
+/// event classes, the averages of the products of the components of the
+/// fully corrected Qn vectors of pairs of detector configurations. Instead
+/// of providing the Qn vectors of each event for external analysis, the
+/// framework can accumulate them directly.
+///
+/// For two detector configurations A and B, the XX, XY, YX and YY
+/// correlation components of the A and B Qn vectors are profiled for
+/// each of the requested harmonics. For three detector configurations
+/// A, B and C, as needed by the three sub-events resolution method, the
+/// pairs AB, AC and BC are profiled. Only events where both Qn vectors
+/// of a pair have good quality contribute to the pair profile.
+///
+/// The correlations are accumulated once the correction steps have been
+/// applied and the corrected Qn vectors are the ones the detector
+/// configurations provide at that point. The requested harmonics should
+/// be handled by the involved detector configurations.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsQnVectorCorrelations : public TNamed {
+public:
+  QnCorrectionsQnVectorCorrelations();
+  QnCorrectionsQnVectorCorrelations(const char *name,
+      QnCorrectionsEventClassVariablesSet *eventClassesVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap = NULL);
+  virtual ~QnCorrectionsQnVectorCorrelations();
+
+  void SetDetectorConfigurations(const char *nameA, const char *nameB, const char *nameC = NULL);
+  /// Gets the number of correlated detector configurations
+  /// \return the number of detector configurations
+  Int_t GetNoOfDetectorConfigurations() const { return fNoOfConfigurations; }
+  /// Gets the number of profiled pairs of detector configurations
+  /// \return the number of pairs
+  Int_t GetNoOfPairs() const { return fNoOfConfigurations * (fNoOfConfigurations - 1) / 2; }
+
+  Bool_t AttachDetectorConfigurations(QnCorrectionsManager *manager);
+  Bool_t CreateCorrelationsHistograms(TList *list, QnCorrectionsHistogramsContext *context);
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+  void ProcessCorrelations(const Float_t *variableContainer);
+
+  static const Int_t nMaxNoOfConfigurations;       ///< the maximum number of correlated detector configurations
+
+private:
+  /// Gets the first detector configuration of a pair
+  /// Pairs are ordered as AB, AC and BC
+  /// \param pair the pair number
+  static Int_t GetPairFirst(Int_t pair) { return (pair < 2) ? 0 : 1; }
+  /// Gets the second detector configuration of a pair
+  /// Pairs are ordered as AB, AC and BC
+  /// \param pair the pair number
+  static Int_t GetPairSecond(Int_t pair) { return (pair == 0) ? 1 : 2; }
+
+  QnCorrectionsEventClassVariablesSet *fEventClassVariables; ///< the event class variables the correlations are profiled against
+  Int_t fNoOfHarmonics;                            ///< the number of correlated harmonics
+  /// array, the ordered harmonic numbers
+  Int_t *fHarmonicMap;                             //[fNoOfHarmonics]
+  Int_t fNoOfConfigurations;                       ///< the number of correlated detector configurations
+  TString fConfigurationsNames[3];                 ///< the names of the correlated detector configurations
+  QnCorrectionsDetectorConfigurationBase *fConfigurations[3]; //!<! the correlated detector configurations
+  QnCorrectionsProfileCorrelationComponentsHarmonics *fCorrelations[3]; //!<! the pairs correlation components profiles
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsQnVectorCorrelations(const QnCorrectionsQnVectorCorrelations &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsQnVectorCorrelations& operator= (const QnCorrectionsQnVectorCorrelations &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsQnVectorCorrelations, 1);
+/// \endcond
+};
+
+/// Accumulates the correlations of the current event
+///
+/// For each pair with good quality Qn vectors the four correlation
+/// components of each harmonic are filled.
+/// \param variableContainer pointer to the variable content bank
+inline void QnCorrectionsQnVectorCorrelations::ProcessCorrelations(const Float_t *variableContainer) {
+  for (Int_t pair = 0; pair < GetNoOfPairs(); pair++) {
+    const QnCorrectionsQnVector *qnA = fConfigurations[GetPairFirst(pair)]->GetCurrentQnVector();
+    const QnCorrectionsQnVector *qnB = fConfigurations[GetPairSecond(pair)]->GetCurrentQnVector();
+    if (qnA->IsGoodQuality() && qnB->IsGoodQuality()) {
+      for (Int_t h = 0; h < fNoOfHarmonics; h++) {
+        Int_t harmonic = fHarmonicMap[h];
+        fCorrelations[pair]->FillXX(harmonic, variableContainer, qnA->Qx(harmonic) * qnB->Qx(harmonic));
+        fCorrelations[pair]->FillXY(harmonic, variableContainer, qnA->Qx(harmonic) * qnB->Qy(harmonic));
+        fCorrelations[pair]->FillYX(harmonic, variableContainer, qnA->Qy(harmonic) * qnB->Qx(harmonic));
+        fCorrelations[pair]->FillYY(harmonic, variableContainer, qnA->Qy(harmonic) * qnB->Qy(harmonic));
+      }
+    }
+  }
+}
+
+#endif // QNCORRECTIONS_QNVECTORCORRELATIONS_H
@@ -0,0 +1,207 @@
+/**************************************************************************************************
+ *                                                                                                *
+ * Package:       FlowVectorCorrections                                                           *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch                              *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com                             *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch                                   *
+ *                Contributors are mentioned in the code where appropriate.                       *
+ * Development:   2012-2016                                                                       *
+ *                                                                                                *
+ * This file is part of FlowVectorCorrections, a software package that corrects Q-vector          *
+ * measurements for effects of nonuniform detector acceptance. The corrections in this package    *
+ * are based on publication:                                                                      *
+ *                                                                                                *
+ *  [1] "Effects of non-uniform acceptance in anisotropic flow measurements"                      *
+ *  Ilya Selyuzhenkov and Sergei Voloshin                                                         *
+ *  Phys. Rev. C 77, 034904 (2008)                                                                *
+ *                                                                                                *
+ * The procedure proposed in [1] is extended with the following steps:                            *
+ * (*) alignment correction between subevents                                                     *
+ * (*) possibility to extract the twist and rescaling corrections                                 *
+ *      for the case of three detector subevents                                                  *
+ *      (currently limited to the case of two “hit-only” and one “tracking” detectors)            *
+ * (*) (optional) channel equalization                                                            *
+ * (*) flow vector width equalization                                                             *
+ *                                                                                                *
+ * FlowVectorCorrections is distributed under the terms of the GNU General Public License (GPL)   *
+ * (https://en.wikipedia.org/wiki/GNU_General_Public_License)                                     *
+ * either version 3 of the License, or (at your option) any later version.                        *
+ *                                                                                                *
+ **************************************************************************************************/
+
+/// \file QnCorrectionsQnVectorDifferentialFlow.cxx
+/// \brief Implementation of the differential flow correlations of track data vectors with a corrected Qn vector
+
+#include "QnCorrectionsQnVectorDifferentialFlow.h"
+#include "QnCorrectionsManager.h"
+#include "QnCorrectionsLog.h"
+
+/// \cond CLASSIMP
+ClassImp(QnCorrectionsQnVectorDifferentialFlow);
+/// \endcond
+
+/// Default constructor
+QnCorrectionsQnVectorDifferentialFlow::QnCorrectionsQnVectorDifferentialFlow() : TNamed(),
+    fPOIConfigurationName(),
+    fReferenceConfigurationName() {
+
+  fBinningVariables = NULL;
+  fNoOfHarmonics = 0;
+  fHarmonicMap = NULL;
+  fUseDataVectorsWeights = kTRUE;
+  fPOIConfiguration = NULL;
+  fReferenceConfiguration = NULL;
+  fCorrelations = NULL;
+  fWeights = NULL;
+  fNoOfVariables = 0;
+  fVariablesIds = NULL;
+  fRecordedPositions = NULL;
+  fVariablesBank = NULL;
+  fHighestHarmonic = 0;
+  fCos = NULL;
+  fSin = NULL;
+}
+
+/// Normal constructor
+///
+/// The involved detector configurations are given afterwards with
+/// SetDetectorConfigurations.
+/// \param name the name of the differential flow correlations, also for its histograms list
+/// \param binningVariables the set of variables the correlations are profiled against
+/// \param nNoOfHarmonics the number of harmonics to correlate
+/// \param harmonicMap an optional ordered array with the harmonic numbers
+QnCorrectionsQnVectorDifferentialFlow::QnCorrectionsQnVectorDifferentialFlow(const char *name,
+      QnCorrectionsEventClassVariablesSet *binningVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap) :
+          TNamed(name,name),
+          fPOIConfigurationName(),
+          fReferenceConfigurationName() {
+
+  fBinningVariables = binningVariables;
+  fNoOfHarmonics = nNoOfHarmonics;
+  fHarmonicMap = new Int_t[fNoOfHarmonics];
+  fHighestHarmonic = 0;
+  for (Int_t h = 0; h < fNoOfHarmonics; h++) {
+    fHarmonicMap[h] = (harmonicMap != NULL) ? harmonicMap[h] : h + 1;
+    if (fHighestHarmonic < fHarmonicMap[h]) fHighestHarmonic = fHarmonicMap[h];
+  }
+  fUseDataVectorsWeights = kTRUE;
+  fPOIConfiguration = NULL;
+  fReferenceConfiguration = NULL;
+  fCorrelations = NULL;
+  fWeights = NULL;
+  fNoOfVariables = 0;
+  fVariablesIds = NULL;
+  fRecordedPositions = NULL;
+  fVariablesBank = NULL;
+  fCos = NULL;
+  fSin = NULL;
+}
+
+/// Default destructor
+///
+/// The profile histograms are owned by the histograms list
+QnCorrectionsQnVectorDifferentialFlow::~QnCorrectionsQnVectorDifferentialFlow() {
+  if (fHarmonicMap != NULL) delete [] fHarmonicMap;
+  if (fCorrelations != NULL) delete fCorrelations;
+  if (fWeights != NULL) delete fWeights;
+  if (fVariablesIds != NULL) delete [] fVariablesIds;
+  if (fRecordedPositions != NULL) delete [] fRecordedPositions;
+  if (fVariablesBank != NULL) delete [] fVariablesBank;
+  if (fCos != NULL) delete [] fCos;
+  if (fSin != NULL) delete [] fSin;
+}
+
+/// Sets the involved detector configurations
+/// \param poiName the name of the particles of interest track detector configuration
+/// \param referenceName the name of the reference detector configuration
+void QnCorrectionsQnVectorDifferentialFlow::SetDetectorConfigurations(const char *poiName, const char *referenceName) {
+  fPOIConfigurationName = poiName;
+  fReferenceConfigurationName = referenceName;
+}
+
+/// Locates the involved detector configurations within the framework
+///
+/// The particles of interest detector configuration is requested to
+/// record the binning variables for each of its data vectors. Raise
+/// an execution error if any of the detector configurations is not
+/// found or if the particles of interest one is not a track detector
+/// configuration owning its data vectors bank. To be called once the
+/// framework data variables bank is allocated.
+/// \param manager the framework manager
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorDifferentialFlow::AttachDetectorConfigurations(QnCorrectionsManager *manager) {
+  QnCorrectionsDetectorConfigurationBase *poiConfiguration = manager->FindDetectorConfiguration(fPOIConfigurationName.Data());
+  fReferenceConfiguration = manager->FindDetectorConfiguration(fReferenceConfigurationName.Data());
+  if ((poiConfiguration == NULL) || (fReferenceConfiguration == NULL)) {
+    QnCorrectionsFatal(Form("Differential flow %s requires the detector configurations %s and %s and any of them is not defined. FIX IT, PLEASE.",
+        GetName(), fPOIConfigurationName.Data(), fReferenceConfigurationName.Data()));
+    return kFALSE;
+  }
+  if (!poiConfiguration->GetIsTrackingDetector() ||
+      static_cast<QnCorrectionsDetectorConfigurationTracks *>(poiConfiguration)->GetSharedDataBank()) {
+    QnCorrectionsFatal(Form("Differential flow %s requires %s to be a track detector configuration with its own data vectors bank. FIX IT, PLEASE.",
+        GetName(), fPOIConfigurationName.Data()));
+    return kFALSE;
+  }
+  if ((fBinningVariables == NULL) || (fBinningVariables->GetEntriesFast() == 0)) {
+    QnCorrectionsFatal(Form("Differential flow %s without binning variables. FIX IT, PLEASE.", GetName()));
+    return kFALSE;
+  }
+  fPOIConfiguration = static_cast<QnCorrectionsDetectorConfigurationTracks *>(poiConfiguration);
+
+  /* the binning variables recorded with each particle of interest */
+  fNoOfVariables = fBinningVariables->GetEntriesFast();
+  fVariablesIds = new Int_t[fNoOfVariables];
+  fRecordedPositions = new Int_t[fNoOfVariables];
+  for (Int_t var = 0; var < fNoOfVariables; var++) {
+    fVariablesIds[var] = fBinningVariables->At(var)->GetVariableId();
+    fRecordedPositions[var] = fPOIConfiguration->RecordDataVectorsVariable(fVariablesIds[var]);
+  }
+  fVariablesBank = new Float_t[manager->GetNoOfDataVariables()];
+  for (Int_t var = 0; var < manager->GetNoOfDataVariables(); var++) {
+    fVariablesBank[var] = 0.0;
+  }
+
+  /* the harmonic terms storage */
+  fCos = new Double_t[fHighestHarmonic + 1];
+  fSin = new Double_t[fHighestHarmonic + 1];
+  fCos[0] = 1.0;
+  fSin[0] = 0.0;
+  return kTRUE;
+}
+
+/// Creates the correlation components profile
+///
+/// If the particles of interest are weighted the weights profile is
+/// created as well. The histograms are incorporated to a list named after the differential
+/// flow correlations which is added to the passed list.
+/// \param list list where the differential flow histograms list should be added
+/// \param context the histograms context of the framework manager
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorDifferentialFlow::CreateDifferentialFlowHistograms(TList *list, QnCorrectionsHistogramsContext *context) {
+  TList *differentialFlowList = new TList();
+  differentialFlowList->SetName(GetName());
+  differentialFlowList->SetOwner(kTRUE);
+
+  TString profileName = Form("%s_%s", fPOIConfigurationName.Data(), fReferenceConfigurationName.Data());
+  fCorrelations = new QnCorrectionsProfileCorrelationComponentsHarmonics(profileName.Data(), profileName.Data(), *fBinningVariables);
+  fCorrelations->SetHistogramsContext(context);
+  fCorrelations->CreateCorrelationComponentsProfileHistograms(differentialFlowList, fNoOfHarmonics, fHarmonicMap);
+  if (fUseDataVectorsWeights) {
+    TString weightsName = Form("%s_weights", fPOIConfigurationName.Data());
+    fWeights = new QnCorrectionsProfile(weightsName.Data(), weightsName.Data(), *fBinningVariables);
+    fWeights->SetHistogramsContext(context);
+    fWeights->CreateProfileHistograms(differentialFlowList);
+  }
+  list->Add(differentialFlowList);
+  return kTRUE;
+}
+
+/// Registers the variables Ids the differential flow correlations read
+/// from the variables bank for their remapping into a dense variables bank
+/// \param bank the variables bank remapper
+void QnCorrectionsQnVectorDifferentialFlow::RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank) {
+  if (fBinningVariables != NULL) fBinningVariables->RegisterDataVariables(bank);
+}
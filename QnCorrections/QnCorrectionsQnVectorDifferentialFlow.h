@@ -0,0 +1,167 @@
+#ifndef QNCORRECTIONS_QNVECTORDIFFERENTIALFLOW_H
+#define QNCORRECTIONS_QNVECTORDIFFERENTIALFLOW_H
+
+/***************************************************************************
+ * Package:       FlowVectorCorrections                                    *
+ * Authors:       Jaap Onderwaater, GSI, jacobus.onderwaater@cern.ch       *
+ *                Ilya Selyuzhenkov, GSI, ilya.selyuzhenkov@gmail.com      *
+ *                Víctor González, UCM, victor.gonzalez@cern.ch            *
+ *                Contributors are mentioned in the code where appropriate.*
+ * Development:   2012-2016                                                *
+ * See cxx source for GPL licence et. al.                                  *
+ ***************************************************************************/
+
+/// \file QnCorrectionsQnVectorDifferentialFlow.h
+/// \brief Differential flow correlations of track data vectors with a corrected Qn vector
+
+#include <TNamed.h>
+#include <TString.h>
+#include <TList.h>
+#include <TMath.h>
+#include <TClonesArray.h>
+
+#include "QnCorrectionsEventClassVariablesSet.h"
+#include "QnCorrectionsProfile.h"
+#include "QnCorrectionsProfileCorrelationComponentsHarmonics.h"
+#include "QnCorrectionsDetectorConfigurationTracks.h"
+
+class QnCorrectionsManager;
+
+/// \class QnCorrectionsQnVectorDifferentialFlow
+/// \brief Accumulates the correlations of the particles of interest unit vectors with a corrected Qn vector
+///
+/// Differential flow measurements need, for each particle of interest,
+/// the correlation of its unit vector u_n = (cos n phi, sin n phi) with
+/// the fully corrected Qn vector of a reference detector configuration,
+/// binned in track variables as transverse momentum or pseudorapidity.
+///
+/// The particles of interest are the data vectors stored in the data
+/// vectors bank of a track detector configuration which, for that
+/// purpose, records for each accepted data vector the values of the
+/// binning variables. Once the event has been processed, the data vectors
+/// of the particles of interest are visited once and, if the reference Qn
+/// vector has good quality, for each requested harmonic the XX, XY, YX
+/// and YY components of the profile receive the products u_x Q_x,
+/// u_x Q_y, u_y Q_x and u_y Q_y. The harmonic terms of each data vector
+/// are obtained from its angle by recurrence.
+///
+/// By default each particle of interest contributes with its data vector
+/// weight, which includes the track detector configuration tracks weights,
+/// e.g. efficiency or azimuthal weights. The products are then weighted
+/// and a companion profile receives the weights, so that the weighted
+/// correlations are the components averages divided by the weights
+/// average of the same bin. Unit weights can be requested instead.
+///
+/// The binning variables are any of the variables in the variables bank
+/// when the data vector is added, track variables or event variables as
+/// the centrality. The reference detector configuration should not share
+/// the particles of interest to avoid autocorrelations, and should handle
+/// the requested harmonics.
+///
+/// \author Víctor González <victor.gonzalez@cern.ch>, UCM
+/// \date Oct 17, 2026
+class QnCorrectionsQnVectorDifferentialFlow : public TNamed {
+public:
+  QnCorrectionsQnVectorDifferentialFlow();
+  QnCorrectionsQnVectorDifferentialFlow(const char *name,
+      QnCorrectionsEventClassVariablesSet *binningVariables,
+      Int_t nNoOfHarmonics,
+      Int_t *harmonicMap = NULL);
+  virtual ~QnCorrectionsQnVectorDifferentialFlow();
+
+  void SetDetectorConfigurations(const char *poiName, const char *referenceName);
+  /// Sets whether the particles of interest contribute with their data vectors weights
+  ///
+  /// Should be set before initializing the framework.
+  /// \param enable kTRUE for weighting the particles of interest, kFALSE for unit weights
+  void SetUseDataVectorsWeights(Bool_t enable = kTRUE) { fUseDataVectorsWeights = enable; }
+  /// Gets whether the particles of interest contribute with their data vectors weights
+  /// \return kTRUE if the particles of interest are weighted
+  Bool_t GetUseDataVectorsWeights() const { return fUseDataVectorsWeights; }
+
+  Bool_t AttachDetectorConfigurations(QnCorrectionsManager *manager);
+  Bool_t CreateDifferentialFlowHistograms(TList *list, QnCorrectionsHistogramsContext *context);
+  void RegisterDataVariables(QnCorrectionsCoreVariablesBank &bank);
+  void ProcessDifferentialFlow();
+
+private:
+  QnCorrectionsEventClassVariablesSet *fBinningVariables; ///< the variables the correlations are profiled against
+  Int_t fNoOfHarmonics;                            ///< the number of correlated harmonics
+  /// array, the ordered harmonic numbers
+  Int_t *fHarmonicMap;                             //[fNoOfHarmonics]
+  TString fPOIConfigurationName;                   ///< the name of the particles of interest track detector configuration
+  TString fReferenceConfigurationName;             ///< the name of the reference detector configuration
+  Bool_t fUseDataVectorsWeights;                   ///< the particles of interest contribute with their data vectors weights
+  QnCorrectionsDetectorConfigurationTracks *fPOIConfiguration; //!<! the particles of interest track detector configuration
+  QnCorrectionsDetectorConfigurationBase *fReferenceConfiguration; //!<! the reference detector configuration
+  QnCorrectionsProfileCorrelationComponentsHarmonics *fCorrelations; //!<! the correlation components profile
+  QnCorrectionsProfile *fWeights;                  //!<! the particles of interest weights profile, NULL for unit weights
+  Int_t fNoOfVariables;                            //!<! the number of binning variables
+  /// array, the binning variables ids
+  Int_t *fVariablesIds;                            //!<!
+  /// array, the binning variables positions within the data vectors recorded values
+  Int_t *fRecordedPositions;                       //!<!
+  /// array, the variables bank the profile is filled from
+  Float_t *fVariablesBank;                         //!<!
+  Int_t fHighestHarmonic;                          //!<! the highest correlated harmonic
+  /// array, the cosine terms of the current data vector
+  Double_t *fCos;                                  //!<!
+  /// array, the sine terms of the current data vector
+  Double_t *fSin;                                  //!<!
+
+private:
+  /// Copy constructor
+  /// Not allowed. Forced private.
+  QnCorrectionsQnVectorDifferentialFlow(const QnCorrectionsQnVectorDifferentialFlow &);
+  /// Assignment operator
+  /// Not allowed. Forced private.
+  QnCorrectionsQnVectorDifferentialFlow& operator= (const QnCorrectionsQnVectorDifferentialFlow &);
+
+/// \cond CLASSIMP
+  ClassDef(QnCorrectionsQnVectorDifferentialFlow, 2);
+/// \endcond
+};
+
+/// Accumulates the differential flow correlations of the current event
+///
+/// To be called once the reference Qn vector has been corrected and
+/// before the particles of interest data vectors bank is cleared.
+inline void QnCorrectionsQnVectorDifferentialFlow::ProcessDifferentialFlow() {
+  const QnCorrectionsQnVector *qn = fReferenceConfiguration->GetCurrentQnVector();
+  if (!qn->IsGoodQuality()) return;
+
+  TClonesArray *bank = fPOIConfiguration->GetInputDataBank();
+  for (Int_t ixDataVector = 0; ixDataVector < bank->GetEntriesFast(); ixDataVector++) {
+    QnCorrectionsDataVector *dataVector = static_cast<QnCorrectionsDataVector *>(bank->At(ixDataVector));
+
+    /* place the data vector binning variables values */
+    const Float_t *values = fPOIConfiguration->GetRecordedVariables(ixDataVector);
+    for (Int_t var = 0; var < fNoOfVariables; var++) {
+      fVariablesBank[fVariablesIds[var]] = values[fRecordedPositions[var]];
+    }
+
+    Double_t weight = 1.0;
+    if (fWeights != NULL) {
+      weight = dataVector->Weight();
+      fWeights->Fill(fVariablesBank, weight);
+    }
+
+    /* the harmonic terms by the angle addition recurrence */
+    Double_t cosPhi = TMath::Cos(dataVector->Phi());
+    Double_t sinPhi = TMath::Sin(dataVector->Phi());
+    for (Int_t n = 1; n <= fHighestHarmonic; n++) {
+      fCos[n] = fCos[n - 1] * cosPhi - fSin[n - 1] * sinPhi;
+      fSin[n] = fSin[n - 1] * cosPhi + fCos[n - 1] * sinPhi;
+    }
+
+    for (Int_t h = 0; h < fNoOfHarmonics; h++) {
+      Int_t harmonic = fHarmonicMap[h];
+      fCorrelations->FillXX(harmonic, fVariablesBank, weight * fCos[harmonic] * qn->Qx(harmonic));
+      fCorrelations->FillXY(harmonic, fVariablesBank, weight * fCos[harmonic] * qn->Qy(harmonic));
+      fCorrelations->FillYX(harmonic, fVariablesBank, weight * fSin[harmonic] * qn->Qx(harmonic));
+      fCorrelations->FillYY(harmonic, fVariablesBank, weight * fSin[harmonic] * qn->Qy(harmonic));
+    }
+  }
+}
+
+#endif // QNCORRECTIONS_QNVECTORDIFFERENTIALFLOW_H
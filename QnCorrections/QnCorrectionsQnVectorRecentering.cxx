@@ -35,6 +35,7 @@
 #include "QnCorrectionsProfileComponents.h"
 #include "QnCorrectionsHistogramSparse.h"
 #include "QnCorrectionsDetector.h"
+#include "QnCorrectionsCoreCorrectionKernels.h"
 #include "QnCorrectionsLog.h"
 #include "QnCorrectionsQnVectorRecentering.h"
 
@@ -55,6 +56,7 @@ ClassImp(QnCorrectionsQnVectorRecentering);
 QnCorrectionsQnVectorRecentering::QnCorrectionsQnVectorRecentering() :
     QnCorrectionsCorrectionOnQvector(szCorrectionName, szKey) {
   fInputHistograms = NULL;
+  fStagedInputHistograms = NULL;
   fCalibrationHistograms = NULL;
   fQANotValidatedBin = NULL;
   fQAQnAverageHistogram = NULL;
@@ -67,6 +69,8 @@ QnCorrectionsQnVectorRecentering::QnCorrectionsQnVectorRecentering() :
 QnCorrectionsQnVectorRecentering::~QnCorrectionsQnVectorRecentering() {
   if (fInputHistograms != NULL)
     delete fInputHistograms;
+  if (fStagedInputHistograms != NULL)
+    delete fStagedInputHistograms;
   if (fCalibrationHistograms != NULL)
     delete fCalibrationHistograms;
   if (fQANotValidatedBin != NULL)
@@ -77,15 +81,11 @@ QnCorrectionsQnVectorRecentering::~QnCorrectionsQnVectorRecentering() {
 
 /// Asks for support data structures creation
 ///
-/// Creates the recentered Qn vector
+/// Creates the recentered Qn vector in the detector configuration hot data
 void QnCorrectionsQnVectorRecentering::CreateSupportDataStructures() {
 
-  Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
-  Int_t *harmonicsMap = new Int_t[nNoOfHarmonics];
-  fDetectorConfiguration->GetHarmonicMap(harmonicsMap);
-  fCorrectedQnVector = new QnCorrectionsQnVector(szCorrectedQnVectorName, nNoOfHarmonics, harmonicsMap);
+  fCorrectedQnVector = fDetectorConfiguration->NewCorrectionStepQnVector(szCorrectedQnVectorName);
   fInputQnVector = fDetectorConfiguration->GetPreviousCorrectedQnVector(this);
-  delete [] harmonicsMap;
 }
 
 /// Asks for support histograms creation
@@ -108,9 +108,11 @@ Bool_t QnCorrectionsQnVectorRecentering::CreateSupportHistograms(TList *list) {
   if (fInputHistograms != NULL) delete fInputHistograms;
   fInputHistograms = new QnCorrectionsProfileComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       fDetectorConfiguration->GetEventClassVariablesSet(), "s");
+  fInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
   fCalibrationHistograms = new QnCorrectionsProfileComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
       fDetectorConfiguration->GetEventClassVariablesSet(), "s");
+  fCalibrationHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
 
   /* get information about the configured harmonics to pass it for histogram creation */
   Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
@@ -134,6 +136,52 @@ Bool_t QnCorrectionsQnVectorRecentering::AttachInput(TList *list) {
   return kFALSE;
 }
 
+/// Stages the input information found in a new calibration for a later swap
+///
+/// Only if the correction step is being applied new input information
+/// is staged. The new histograms are attached to the passed list which
+/// should be kept until the staged information is swapped or discarded.
+/// \param list list where the new inputs should be found, NULL if not present
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorRecentering::StageInput(TList *list) {
+
+  if (!IsBeingApplied()) return kTRUE;
+  if (list == NULL) return kFALSE;
+
+  TString histoNameAndTitle = TString::Format("%s %s ",
+      szSupportHistogramName,
+      fDetectorConfiguration->GetName());
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = new QnCorrectionsProfileComponents((const char *) histoNameAndTitle, (const char *) histoNameAndTitle,
+      fDetectorConfiguration->GetEventClassVariablesSet(), "s");
+  fStagedInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
+  fStagedInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+  if (fStagedInputHistograms->AttachHistograms(list)) {
+    return kTRUE;
+  }
+  delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+  return kFALSE;
+}
+
+/// Replaces the input information in use by the staged one if any
+void QnCorrectionsQnVectorRecentering::SwapStagedInput() {
+
+  if (fStagedInputHistograms != NULL) {
+    delete fInputHistograms;
+    fInputHistograms = fStagedInputHistograms;
+    fStagedInputHistograms = NULL;
+  }
+}
+
+/// Deletes the staged input information if any
+void QnCorrectionsQnVectorRecentering::DiscardStagedInput() {
+
+  if (fStagedInputHistograms != NULL) delete fStagedInputHistograms;
+  fStagedInputHistograms = NULL;
+}
+
 /// Asks for QA histograms creation
 ///
 /// Allocates the histogram objects and creates the QA histograms.
@@ -145,6 +193,7 @@ Bool_t QnCorrectionsQnVectorRecentering::CreateQAHistograms(TList *list) {
       TString::Format("%s %s", szQAQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
       TString::Format("%s %s", szQAQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fQAQnAverageHistogram->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
 
   /* get information about the configured harmonics to pass it for histogram creation */
   Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
@@ -166,6 +215,7 @@ Bool_t QnCorrectionsQnVectorRecentering::CreateNveQAHistograms(TList *list) {
       TString::Format("%s %s", szQANotValidatedHistogramName, fDetectorConfiguration->GetName()).Data(),
       TString::Format("%s %s", szQANotValidatedHistogramName, fDetectorConfiguration->GetName()).Data(),
       fDetectorConfiguration->GetEventClassVariablesSet());
+  fQANotValidatedBin->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   fQANotValidatedBin->CreateHistogram(list);
   return kTRUE;
 }
@@ -176,6 +226,7 @@ Bool_t QnCorrectionsQnVectorRecentering::CreateNveQAHistograms(TList *list) {
 /// \return kTRUE if the correction step was applied
 Bool_t QnCorrectionsQnVectorRecentering::ProcessCorrections(const Float_t *variableContainer) {
   Int_t harmonic;
+  QnCorrectionsQnVector *currentQnVector = fDetectorConfiguration->GetCurrentQnVector();
   switch (fState) {
   case QCORRSTEP_calibration:
     /* collect the data needed to further produce correction parameters if the current Qn vector is good enough */
@@ -187,29 +238,30 @@ Bool_t QnCorrectionsQnVectorRecentering::ProcessCorrections(const Float_t *varia
     /* and proceed to ... */
   case QCORRSTEP_apply: /* apply the correction if the current Qn vector is good enough */
     QnCorrectionsInfo(TString::Format("Recentering process in detector %s: applying correction.", fDetectorConfiguration->GetName()).Data());
-    if (fDetectorConfiguration->GetCurrentQnVector()->IsGoodQuality()) {
-      /* we get the properties of the current Qn vector but its name */
-      fCorrectedQnVector->Set(fDetectorConfiguration->GetCurrentQnVector(),kFALSE);
-      harmonic = fDetectorConfiguration->GetCurrentQnVector()->GetFirstHarmonic();
+    if (currentQnVector->IsGoodQuality()) {
+      /* the current Qn vector is corrected in place */
+      harmonic = currentQnVector->GetFirstHarmonic();
 
       /* let's check the correction histograms */
       Long64_t bin = fInputHistograms->GetBin(variableContainer);
       if (fInputHistograms->BinContentValidated(bin)) {
         /* correction information validated */
         while (harmonic != -1) {
-          Float_t widthX = 1.0;
-          Float_t widthY = 1.0;
+          Double_t widthX = 1.0;
+          Double_t widthY = 1.0;
           if (fApplyWidthEqualization) {
             widthX = fInputHistograms->GetXBinError(harmonic, bin);
             widthY = fInputHistograms->GetYBinError(harmonic, bin);
           }
-          fCorrectedQnVector->SetQx(harmonic, (fDetectorConfiguration->GetCurrentQnVector()->Qx(harmonic)
-              - fInputHistograms->GetXBinContent(harmonic, bin))
-              / widthX);
-          fCorrectedQnVector->SetQy(harmonic, (fDetectorConfiguration->GetCurrentQnVector()->Qy(harmonic)
-              - fInputHistograms->GetYBinContent(harmonic, bin))
-              / widthY);
-          harmonic = fDetectorConfiguration->GetCurrentQnVector()->GetNextHarmonic(harmonic);
+          Float_t qx = currentQnVector->Qx(harmonic);
+          Float_t qy = currentQnVector->Qy(harmonic);
+          QnCorrectionsCoreCorrectionKernels::Recenter(qx, qy,
+              fInputHistograms->GetXBinContent(harmonic, bin),
+              fInputHistograms->GetYBinContent(harmonic, bin),
+              widthX, widthY);
+          currentQnVector->SetQx(harmonic, qx);
+          currentQnVector->SetQy(harmonic, qy);
+          harmonic = currentQnVector->GetNextHarmonic(harmonic);
         }
       } /* correction information not validated, we leave the Q vector untouched */
       else {
@@ -218,10 +270,13 @@ Bool_t QnCorrectionsQnVectorRecentering::ProcessCorrections(const Float_t *varia
     }
     else {
       /* not done! input vector with bad quality */
-      fCorrectedQnVector->SetGood(kFALSE);
+      currentQnVector->Reset();
     }
-    /* and update the current Qn vector */
-    fDetectorConfiguration->UpdateCurrentQnVector(fCorrectedQnVector);
+    /* keep track of the correction on the current Qn vector */
+    fDetectorConfiguration->TagCurrentQnVector(fCorrectedQnVector);
+    /* and keep the step snapshot only if someone will read it */
+    if (fKeepCorrectedQnVector || (fQAQnAverageHistogram != NULL))
+      fCorrectedQnVector->Set(currentQnVector, kFALSE);
     break;
   default:
     /* we are in passive state waiting for proper conditions, no corrections applied */
@@ -118,6 +118,9 @@ public:
   /// No action for Qn vector recentering
   virtual void AttachedToFrameworkManager() {}
   virtual Bool_t AttachInput(TList *list);
+  virtual Bool_t StageInput(TList *list);
+  virtual void SwapStagedInput();
+  virtual void DiscardStagedInput();
   /// Perform after calibration histograms attach actions
   /// It is used to inform the different correction step that
   /// all conditions for running the network are in place so
@@ -145,6 +148,7 @@ private:
   static const char *szQANotValidatedHistogramName;  ///< the name and title for bin not validated QA histograms
   static const char *szQAQnAverageHistogramName;     ///< the name and title for Qn components average QA histograms
   QnCorrectionsProfileComponents *fInputHistograms; //!<! the histogram with calibration information
+  QnCorrectionsProfileComponents *fStagedInputHistograms; //!<! the histogram with the staged new calibration information
   QnCorrectionsProfileComponents *fCalibrationHistograms; //!<! the histogram for building calibration information
   QnCorrectionsHistogramSparse *fQANotValidatedBin;    //!<! the histogram with non validated bin information
   QnCorrectionsProfileComponents *fQAQnAverageHistogram; //!<! the after correction step average Qn components QA histogram
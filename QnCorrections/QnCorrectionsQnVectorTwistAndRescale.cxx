@@ -37,6 +37,7 @@
 #include "QnCorrectionsHistogramSparse.h"
 #include "QnCorrectionsDetector.h"
 #include "QnCorrectionsManager.h"
+#include "QnCorrectionsCoreCorrectionKernels.h"
 #include "QnCorrectionsLog.h"
 #include "QnCorrectionsQnVectorTwistAndRescale.h"
 
@@ -65,8 +66,10 @@ QnCorrectionsQnVectorTwistAndRescale::QnCorrectionsQnVectorTwistAndRescale() :
     fBDetectorConfigurationName(),
     fCDetectorConfigurationName() {
   fDoubleHarmonicInputHistograms = NULL;
+  fDoubleHarmonicStagedInputHistograms = NULL;
   fDoubleHarmonicCalibrationHistograms = NULL;
   fCorrelationsInputHistograms = NULL;
+  fCorrelationsStagedInputHistograms = NULL;
   fCorrelationsCalibrationHistograms = NULL;
   fQANotValidatedBin = NULL;
   fQATwistQnAverageHistogram = NULL;
@@ -79,6 +82,8 @@ QnCorrectionsQnVectorTwistAndRescale::QnCorrectionsQnVectorTwistAndRescale() :
   fMinNoOfEntriesToValidate = fDefaultMinNoOfEntries;
   fTwistCorrectedQnVector = NULL;
   fRescaleCorrectedQnVector = NULL;
+  fKeepTwistCorrectedQnVector = kFALSE;
+  fKeepRescaleCorrectedQnVector = kFALSE;
 }
 
 /// Default destructor
@@ -90,6 +95,7 @@ QnCorrectionsQnVectorTwistAndRescale::~QnCorrectionsQnVectorTwistAndRescale() {
     delete fDoubleHarmonicCalibrationHistograms;
   if (fCorrelationsInputHistograms != NULL)
     delete fCorrelationsInputHistograms;
+  DiscardStagedInput();
   if (fCorrelationsCalibrationHistograms != NULL)
     delete fCorrelationsCalibrationHistograms;
   if (fQANotValidatedBin != NULL)
@@ -98,10 +104,6 @@ QnCorrectionsQnVectorTwistAndRescale::~QnCorrectionsQnVectorTwistAndRescale() {
     delete fQATwistQnAverageHistogram;
   if (fQARescaleQnAverageHistogram != NULL)
     delete fQARescaleQnAverageHistogram;
-  if (fTwistCorrectedQnVector != NULL)
-    delete fTwistCorrectedQnVector;
-  if (fRescaleCorrectedQnVector != NULL)
-    delete fRescaleCorrectedQnVector;
 }
 
 /// Set the detector configurations used as reference for twist and rescaling
@@ -141,19 +143,13 @@ void QnCorrectionsQnVectorTwistAndRescale::AttachedToFrameworkManager() {
 /// Locates the reference detector configurations for twist and rescaling if their names have been previously stored
 void QnCorrectionsQnVectorTwistAndRescale::CreateSupportDataStructures() {
 
-  Int_t nNoOfHarmonics = fDetectorConfiguration->GetNoOfHarmonics();
-  Int_t *harmonicsMap = new Int_t[nNoOfHarmonics];
-
-  fDetectorConfiguration->GetHarmonicMap(harmonicsMap);
-  /* now create the corrected Qn vectors */
-  fCorrectedQnVector = new QnCorrectionsQnVector(szTwistCorrectedQnVectorName, nNoOfHarmonics, harmonicsMap);
-  fTwistCorrectedQnVector = new QnCorrectionsQnVector(szTwistCorrectedQnVectorName, nNoOfHarmonics, harmonicsMap);
-  fRescaleCorrectedQnVector = new QnCorrectionsQnVector(szRescaleCorrectedQnVectorName, nNoOfHarmonics, harmonicsMap);
+  /* now create the corrected Qn vectors in the detector configuration hot data */
+  fCorrectedQnVector = fDetectorConfiguration->NewCorrectionStepQnVector(szTwistCorrectedQnVectorName);
+  fTwistCorrectedQnVector = fDetectorConfiguration->NewCorrectionStepQnVector(szTwistCorrectedQnVectorName);
+  fRescaleCorrectedQnVector = fDetectorConfiguration->NewCorrectionStepQnVector(szRescaleCorrectedQnVectorName);
   /* get the input vectors we need */
   fInputQnVector = fDetectorConfiguration->GetPreviousCorrectedQnVector(this);
 
-  delete [] harmonicsMap;
-
   /* now, definitely, we should have the reference detector configurations */
   switch (fTwistAndRescaleMethod) {
   case TWRESCALE_doubleHarmonic:
@@ -234,9 +230,11 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::CreateSupportHistograms(TList *list
   case TWRESCALE_doubleHarmonic:
     fDoubleHarmonicInputHistograms = new QnCorrectionsProfileComponents((const char *) histoDoubleHarmonicNameAndTitle, (const char *) histoDoubleHarmonicNameAndTitle,
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fDoubleHarmonicInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     fDoubleHarmonicInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
     fDoubleHarmonicCalibrationHistograms = new QnCorrectionsProfileComponents((const char *) histoDoubleHarmonicNameAndTitle, (const char *) histoDoubleHarmonicNameAndTitle,
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fDoubleHarmonicCalibrationHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     harmonicsMap = new Int_t[fCorrectedQnVector->GetNoOfHarmonics()];
     fCorrectedQnVector->GetHarmonicsMap(harmonicsMap);
     /* we duplicate the harmonics used because that will be the info stored by the profiles */
@@ -250,12 +248,14 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::CreateSupportHistograms(TList *list
         fBDetectorConfiguration->GetName(),
         fCDetectorConfiguration->GetName(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fCorrelationsInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     fCorrelationsInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
     fCorrelationsCalibrationHistograms = new QnCorrectionsProfile3DCorrelations((const char *) histoCorrelationsNameandTitle, (const char *) histoCorrelationsNameandTitle,
         fDetectorConfiguration->GetName(),
         fBDetectorConfiguration->GetName(),
         fCDetectorConfiguration->GetName(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fCorrelationsCalibrationHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     harmonicsMap = new Int_t[fCorrectedQnVector->GetNoOfHarmonics()];
     fCorrectedQnVector->GetHarmonicsMap(harmonicsMap);
     fCorrelationsCalibrationHistograms->CreateCorrelationComponentsProfileHistograms(list, fCorrectedQnVector->GetNoOfHarmonics(), 1 /* harmonic multiplier */, harmonicsMap);
@@ -294,6 +294,80 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::AttachInput(TList *list) {
   return kFALSE;
 }
 
+/// Stages the input information found in a new calibration for a later swap
+///
+/// Only if the correction step is being applied new input information
+/// is staged. The new histograms are attached to the passed list which
+/// should be kept until the staged information is swapped or discarded.
+/// \param list list where the new inputs should be found, NULL if not present
+/// \return kTRUE if everything went OK
+Bool_t QnCorrectionsQnVectorTwistAndRescale::StageInput(TList *list) {
+
+  if (!IsBeingApplied()) return kTRUE;
+  if (list == NULL) return kFALSE;
+
+  TString histoDoubleHarmonicNameAndTitle = TString::Format("%s %s ",
+      szDoubleHarmonicSupportHistogramName,
+      fDetectorConfiguration->GetName());
+
+  TString histoCorrelationsNameandTitle = TString::Format("%s %s ",
+      szCorrelationsSupportHistogramName,
+      fDetectorConfiguration->GetName());
+
+  DiscardStagedInput();
+  switch (fTwistAndRescaleMethod) {
+  case TWRESCALE_doubleHarmonic:
+    fDoubleHarmonicStagedInputHistograms = new QnCorrectionsProfileComponents((const char *) histoDoubleHarmonicNameAndTitle, (const char *) histoDoubleHarmonicNameAndTitle,
+        fDetectorConfiguration->GetEventClassVariablesSet());
+    fDoubleHarmonicStagedInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
+    fDoubleHarmonicStagedInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+    if (fDoubleHarmonicStagedInputHistograms->AttachHistograms(list)) {
+      return kTRUE;
+    }
+    break;
+  case TWRESCALE_correlations:
+    fCorrelationsStagedInputHistograms = new QnCorrectionsProfile3DCorrelations((const char *) histoCorrelationsNameandTitle, (const char *) histoCorrelationsNameandTitle,
+        fDetectorConfiguration->GetName(),
+        fBDetectorConfiguration->GetName(),
+        fCDetectorConfiguration->GetName(),
+        fDetectorConfiguration->GetEventClassVariablesSet());
+    fCorrelationsStagedInputHistograms->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
+    fCorrelationsStagedInputHistograms->SetNoOfEntriesThreshold(fMinNoOfEntriesToValidate);
+    if (fCorrelationsStagedInputHistograms->AttachHistograms(list)) {
+      return kTRUE;
+    }
+    break;
+  default:
+    QnCorrectionsFatal(Form("Wrong stored twist and rescale method: %d. FIX IT, PLEASE", fTwistAndRescaleMethod));
+  }
+  DiscardStagedInput();
+  return kFALSE;
+}
+
+/// Replaces the input information in use by the staged one if any
+void QnCorrectionsQnVectorTwistAndRescale::SwapStagedInput() {
+
+  if (fDoubleHarmonicStagedInputHistograms != NULL) {
+    delete fDoubleHarmonicInputHistograms;
+    fDoubleHarmonicInputHistograms = fDoubleHarmonicStagedInputHistograms;
+    fDoubleHarmonicStagedInputHistograms = NULL;
+  }
+  if (fCorrelationsStagedInputHistograms != NULL) {
+    delete fCorrelationsInputHistograms;
+    fCorrelationsInputHistograms = fCorrelationsStagedInputHistograms;
+    fCorrelationsStagedInputHistograms = NULL;
+  }
+}
+
+/// Deletes the staged input information if any
+void QnCorrectionsQnVectorTwistAndRescale::DiscardStagedInput() {
+
+  if (fDoubleHarmonicStagedInputHistograms != NULL) delete fDoubleHarmonicStagedInputHistograms;
+  if (fCorrelationsStagedInputHistograms != NULL) delete fCorrelationsStagedInputHistograms;
+  fDoubleHarmonicStagedInputHistograms = NULL;
+  fCorrelationsStagedInputHistograms = NULL;
+}
+
 /// Perform after calibration histograms attach actions
 /// It is used to inform the different correction step that
 /// all conditions for running the network are in place so
@@ -334,12 +408,14 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::CreateQAHistograms(TList *list) {
         TString::Format("%s %s", szQATwistQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
         TString::Format("%s %s", szQATwistQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fQATwistQnAverageHistogram->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   }
   if (fApplyRescale) {
     fQARescaleQnAverageHistogram = new QnCorrectionsProfileComponents(
         TString::Format("%s %s", szQARescaleQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
         TString::Format("%s %s", szQARescaleQnAverageHistogramName, fDetectorConfiguration->GetName()).Data(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fQARescaleQnAverageHistogram->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
   }
 
   if (fApplyTwist || fApplyRescale) {
@@ -369,6 +445,7 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::CreateNveQAHistograms(TList *list)
         TString::Format("%s%s %s", szQANotValidatedHistogramName, "DH", fDetectorConfiguration->GetName()).Data(),
         TString::Format("%s%s %s", szQANotValidatedHistogramName, "DH", fDetectorConfiguration->GetName()).Data(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fQANotValidatedBin->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     fQANotValidatedBin->CreateHistogram(list);
     break;
   case TWRESCALE_correlations:
@@ -376,6 +453,7 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::CreateNveQAHistograms(TList *list)
         TString::Format("%s%s %s", szQANotValidatedHistogramName, "CORR", fDetectorConfiguration->GetName()).Data(),
         TString::Format("%s%s %s", szQANotValidatedHistogramName, "CORR", fDetectorConfiguration->GetName()).Data(),
         fDetectorConfiguration->GetEventClassVariablesSet());
+    fQANotValidatedBin->SetHistogramsContext(fDetectorConfiguration->GetHistogramsContext());
     fQANotValidatedBin->CreateHistogram(list);
     break;
   default:
@@ -402,62 +480,37 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
     /* collect the data needed to further produce correction parameters if Qn vectors are good enough */
     /* and proceed to ... */
   case QCORRSTEP_apply: { /* apply the correction if the current Qn vector is good enough */
+    /* the current Qn vector is corrected in place */
+    QnCorrectionsQnVector *currentQnVector = fDetectorConfiguration->GetCurrentQnVector();
+    Bool_t keepTwist = fKeepTwistCorrectedQnVector || (fQATwistQnAverageHistogram != NULL);
     /* logging */
     switch (fTwistAndRescaleMethod) {
     case TWRESCALE_doubleHarmonic: {
       /* TODO: basically we are re producing half of the information already produce for recentering correction. Re use it! */
       QnCorrectionsInfo(TString::Format("Twist and rescale in detector %s with double harmonic method.",
           fDetectorConfiguration->GetName()).Data());
-      if (fDetectorConfiguration->GetCurrentQnVector()->IsGoodQuality()) {
-        fCorrectedQnVector->Set(fDetectorConfiguration->GetCurrentQnVector(),kFALSE);
-        fTwistCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
-        fRescaleCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
+      if (currentQnVector->IsGoodQuality()) {
+        if (keepTwist) fTwistCorrectedQnVector->Set(currentQnVector, kFALSE);
 
         /* let's check the correction histograms */
         Long64_t bin = fDoubleHarmonicInputHistograms->GetBin(variableContainer);
         if (fDoubleHarmonicInputHistograms->BinContentValidated(bin)) {
           /* remember we store the profile information on a twice the harmonic number base */
-          harmonic = fCorrectedQnVector->GetFirstHarmonic();
+          harmonic = currentQnVector->GetFirstHarmonic();
           while (harmonic != -1) {
             Double_t X2n = fDoubleHarmonicInputHistograms->GetXBinContent(harmonic*2,bin);
             Double_t Y2n = fDoubleHarmonicInputHistograms->GetYBinContent(harmonic*2,bin);
 
-            Double_t Aplus = 1 + X2n;
-            Double_t Aminus = 1 - X2n;
-            Double_t LambdaPlus = Y2n / Aplus;
-            Double_t LambdaMinus = Y2n / Aminus;
-
-            if (TMath::Abs(Aplus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(Aminus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(LambdaPlus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(LambdaMinus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-
-            Double_t Qx = fTwistCorrectedQnVector->Qx(harmonic);
-            Double_t Qy = fTwistCorrectedQnVector->Qy(harmonic);
-            Double_t newQx = (Qx - LambdaMinus * Qy)/(1 - LambdaMinus * LambdaPlus);
-            Double_t newQy = (Qy - LambdaPlus * Qx)/(1 - LambdaMinus * LambdaPlus);
-
-            if (fApplyTwist) {
-              fCorrectedQnVector->SetQx(harmonic, newQx);
-              fCorrectedQnVector->SetQy(harmonic, newQy);
-              fTwistCorrectedQnVector->SetQx(harmonic, newQx);
-              fTwistCorrectedQnVector->SetQy(harmonic, newQy);
-              fRescaleCorrectedQnVector->SetQx(harmonic, newQx);
-              fRescaleCorrectedQnVector->SetQy(harmonic, newQy);
-            }
-            newQx = newQx / Aplus;
-            newQy = newQy / Aminus;
-
-            if (Aplus == 0.0) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (Aminus == 0.0) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
+            Double_t Aplus, Aminus, LambdaPlus, LambdaMinus;
+            QnCorrectionsCoreCorrectionKernels::TwistAndRescaleFromDoubleHarmonic(X2n, Y2n, Aplus, Aminus, LambdaPlus, LambdaMinus);
 
-            if (fApplyRescale) {
-              fCorrectedQnVector->SetQx(harmonic, newQx);
-              fCorrectedQnVector->SetQy(harmonic, newQy);
-              fRescaleCorrectedQnVector->SetQx(harmonic, newQx);
-              fRescaleCorrectedQnVector->SetQy(harmonic, newQy);
+            if (!QnCorrectionsCoreCorrectionKernels::TwistAndRescaleParametersValid(Aplus, Aminus, LambdaPlus, LambdaMinus, fMaxThreshold)) {
+              harmonic = currentQnVector->GetNextHarmonic(harmonic);
+              continue;
             }
-            harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
+
+            ApplyTwistAndRescale(currentQnVector, harmonic, Aplus, Aminus, LambdaPlus, LambdaMinus, keepTwist);
+            harmonic = currentQnVector->GetNextHarmonic(harmonic);
           }
         }
         else {
@@ -466,7 +519,7 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
       }
       else {
         /* not done! input Q vector with bad quality */
-        fCorrectedQnVector->SetGood(kFALSE);
+        if (fApplyTwist || fApplyRescale) currentQnVector->Reset();
       }
     }
     break;
@@ -476,15 +529,13 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
           fDetectorConfiguration->GetName(),
           fBDetectorConfiguration->GetName(),
           fCDetectorConfiguration->GetName()).Data());
-      if (fDetectorConfiguration->GetCurrentQnVector()->IsGoodQuality()) {
-        fCorrectedQnVector->Set(fDetectorConfiguration->GetCurrentQnVector(),kFALSE);
-        fTwistCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
-        fRescaleCorrectedQnVector->Set(fCorrectedQnVector, kFALSE);
+      if (currentQnVector->IsGoodQuality()) {
+        if (keepTwist) fTwistCorrectedQnVector->Set(currentQnVector, kFALSE);
 
         /* let's check the correction histograms */
         Long64_t bin = fCorrelationsInputHistograms->GetBin(variableContainer);
         if (fCorrelationsInputHistograms->BinContentValidated(bin)) {
-          harmonic = fCorrectedQnVector->GetFirstHarmonic();
+          harmonic = currentQnVector->GetFirstHarmonic();
           while (harmonic != -1) {
             Double_t XAXC = fCorrelationsInputHistograms->GetXXBinContent("AC",harmonic,bin);
             Double_t YAYB = fCorrelationsInputHistograms->GetYYBinContent("AB",harmonic,bin);
@@ -493,42 +544,17 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
             Double_t XAYB = fCorrelationsInputHistograms->GetXYBinContent("AB",harmonic,bin);
             Double_t XBYC = fCorrelationsInputHistograms->GetXYBinContent("BC",harmonic,bin);
 
-            Double_t Aplus = TMath::Sqrt(TMath::Abs(2.0*XAXC)) * XAXB / TMath::Sqrt(TMath::Abs(XAXB * XBXC + XAYB * XBYC));
-            Double_t Aminus = TMath::Sqrt(TMath::Abs(2.0*XAXC)) * YAYB / TMath::Sqrt(TMath::Abs(XAXB * XBXC + XAYB * XBYC));
-            Double_t LambdaPlus = XAYB / XAXB;
-            Double_t LambdaMinus = XAYB / YAYB;
-
-            if (TMath::Abs(Aplus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(Aminus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(LambdaPlus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (TMath::Abs(LambdaMinus) > fMaxThreshold) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-
-            Double_t Qx = fTwistCorrectedQnVector->Qx(harmonic);
-            Double_t Qy = fTwistCorrectedQnVector->Qy(harmonic);
-            Double_t newQx = (Qx - LambdaMinus * Qy)/(1 - LambdaMinus * LambdaPlus);
-            Double_t newQy = (Qy - LambdaPlus * Qx)/(1 - LambdaMinus * LambdaPlus);
-
-            if (fApplyTwist) {
-              fCorrectedQnVector->SetQx(harmonic, newQx);
-              fCorrectedQnVector->SetQy(harmonic, newQy);
-              fTwistCorrectedQnVector->SetQx(harmonic, newQx);
-              fTwistCorrectedQnVector->SetQy(harmonic, newQy);
-              fRescaleCorrectedQnVector->SetQx(harmonic, newQx);
-              fRescaleCorrectedQnVector->SetQy(harmonic, newQy);
-            }
-            newQx = newQx / Aplus;
-            newQy = newQy / Aminus;
-
-            if (Aplus == 0.0) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
-            if (Aminus == 0.0) { harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic); continue; }
+            Double_t Aplus, Aminus, LambdaPlus, LambdaMinus;
+            QnCorrectionsCoreCorrectionKernels::TwistAndRescaleFromCorrelations(XAXC, YAYB, XAXB, XBXC, XAYB, XBYC,
+                Aplus, Aminus, LambdaPlus, LambdaMinus);
 
-            if (fApplyRescale) {
-              fCorrectedQnVector->SetQx(harmonic, newQx);
-              fCorrectedQnVector->SetQy(harmonic, newQy);
-              fRescaleCorrectedQnVector->SetQx(harmonic, newQx);
-              fRescaleCorrectedQnVector->SetQy(harmonic, newQy);
+            if (!QnCorrectionsCoreCorrectionKernels::TwistAndRescaleParametersValid(Aplus, Aminus, LambdaPlus, LambdaMinus, fMaxThreshold)) {
+              harmonic = currentQnVector->GetNextHarmonic(harmonic);
+              continue;
             }
-            harmonic = fCorrectedQnVector->GetNextHarmonic(harmonic);
+
+            ApplyTwistAndRescale(currentQnVector, harmonic, Aplus, Aminus, LambdaPlus, LambdaMinus, keepTwist);
+            harmonic = currentQnVector->GetNextHarmonic(harmonic);
           }
         }
         else {
@@ -537,7 +563,7 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
       }
       else {
         /* not done! input Q vector with bad quality */
-        fCorrectedQnVector->SetGood(kFALSE);
+        if (fApplyTwist || fApplyRescale) currentQnVector->Reset();
       }
     }
     break;
@@ -545,13 +571,18 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
     default:
       QnCorrectionsFatal(Form("Wrong stored twist and rescale method: %d. FIX IT, PLEASE", fTwistAndRescaleMethod));
     }
-    /* and update the current Qn vector */
+    /* keep track of the corrections on the current Qn vector */
     if (fApplyTwist) {
-      fDetectorConfiguration->UpdateCurrentQnVector(fTwistCorrectedQnVector);
+      fDetectorConfiguration->TagCurrentQnVector(fTwistCorrectedQnVector);
     }
     if (fApplyRescale) {
-      fDetectorConfiguration->UpdateCurrentQnVector(fRescaleCorrectedQnVector);
+      fDetectorConfiguration->TagCurrentQnVector(fRescaleCorrectedQnVector);
     }
+    /* and keep the steps snapshots only if someone will read them */
+    if (fKeepRescaleCorrectedQnVector || (fQARescaleQnAverageHistogram != NULL))
+      fRescaleCorrectedQnVector->Set(currentQnVector, kFALSE);
+    if (fKeepCorrectedQnVector)
+      fCorrectedQnVector->Set(currentQnVector, kFALSE);
   }
   break;
 
@@ -563,6 +594,44 @@ Bool_t QnCorrectionsQnVectorTwistAndRescale::ProcessCorrections(const Float_t *v
   return kTRUE;
 }
 
+/// Applies the twist and rescale correction to the passed harmonic of the current Qn vector
+///
+/// The current Qn vector is corrected in place. The twisted
+/// values are also stored in the twist snapshot if requested.
+/// \param currentQnVector the detector configuration current Qn vector
+/// \param harmonic the harmonic to correct
+/// \param Aplus the \f$ A^{+} \f$ rescale parameter
+/// \param Aminus the \f$ A^{-} \f$ rescale parameter
+/// \param LambdaPlus the \f$ \Lambda^{+} \f$ twist parameter
+/// \param LambdaMinus the \f$ \Lambda^{-} \f$ twist parameter
+/// \param keepTwist kTRUE if the twisted values should be stored in the twist snapshot
+void QnCorrectionsQnVectorTwistAndRescale::ApplyTwistAndRescale(QnCorrectionsQnVector *currentQnVector, Int_t harmonic,
+    Double_t Aplus, Double_t Aminus, Double_t LambdaPlus, Double_t LambdaMinus, Bool_t keepTwist) {
+
+  Double_t newQx, newQy;
+  QnCorrectionsCoreCorrectionKernels::Twist(currentQnVector->Qx(harmonic), currentQnVector->Qy(harmonic),
+      LambdaPlus, LambdaMinus, newQx, newQy);
+
+  if (fApplyTwist) {
+    currentQnVector->SetQx(harmonic, newQx);
+    currentQnVector->SetQy(harmonic, newQy);
+    if (keepTwist) {
+      fTwistCorrectedQnVector->SetQx(harmonic, newQx);
+      fTwistCorrectedQnVector->SetQy(harmonic, newQy);
+    }
+  }
+  newQx = newQx / Aplus;
+  newQy = newQy / Aminus;
+
+  if (Aplus == 0.0) return;
+  if (Aminus == 0.0) return;
+
+  if (fApplyRescale) {
+    currentQnVector->SetQx(harmonic, newQx);
+    currentQnVector->SetQy(harmonic, newQy);
+  }
+}
+
 /// Processes the correction step data collection
 ///
 /// Collect data for the correction step.
@@ -699,6 +768,8 @@ void QnCorrectionsQnVectorTwistAndRescale::ClearCorrectionStep() {
 void QnCorrectionsQnVectorTwistAndRescale::IncludeCorrectedQnVector(TList *list) {
 
   QnCorrectionsInfo("");
+  fKeepTwistCorrectedQnVector = kFALSE;
+  fKeepRescaleCorrectedQnVector = kFALSE;
   switch (fState) {
   case QCORRSTEP_calibration:
     /* collect the data needed to further produce correction parameters */
@@ -707,10 +778,14 @@ void QnCorrectionsQnVectorTwistAndRescale::IncludeCorrectedQnVector(TList *list)
     /* collect the data needed to further produce correction parameters */
     /* and proceed to ... */
   case QCORRSTEP_apply: /* apply the correction */
-    if (fApplyTwist)
+    if (fApplyTwist) {
       list->Add(fTwistCorrectedQnVector);
-    if (fApplyRescale)
+      fKeepTwistCorrectedQnVector = kTRUE;
+    }
+    if (fApplyRescale) {
       list->Add(fRescaleCorrectedQnVector);
+      fKeepRescaleCorrectedQnVector = kTRUE;
+    }
     break;
   default:
     break;
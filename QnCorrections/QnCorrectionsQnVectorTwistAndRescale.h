@@ -170,6 +170,9 @@ public:
 
   virtual void AttachedToFrameworkManager();
   virtual Bool_t AttachInput(TList *list);
+  virtual Bool_t StageInput(TList *list);
+  virtual void SwapStagedInput();
+  virtual void DiscardStagedInput();
   virtual void AfterInputsAttachActions();
 virtual void CreateSupportDataStructures();
   virtual Bool_t CreateSupportHistograms(TList *list);
@@ -184,6 +187,9 @@ virtual void CreateSupportDataStructures();
   virtual Bool_t ReportUsage(TList *calibrationList, TList *applyList);
 
 private:
+  void ApplyTwistAndRescale(QnCorrectionsQnVector *currentQnVector, Int_t harmonic,
+      Double_t Aplus, Double_t Aminus, Double_t LambdaPlus, Double_t LambdaMinus, Bool_t keepTwist);
+
   static const Int_t fDefaultMinNoOfEntries;         ///< the minimum number of entries for bin content validation
   static const Double_t fMaxThreshold;               ///< highest absolute value for meaningful results
   static const char *szTwistCorrectionName;          ///< the name of the twist correction step
@@ -197,8 +203,10 @@ private:
   static const char *szQATwistQnAverageHistogramName;     ///< the name and title for after twist Qn components average QA histograms
   static const char *szQARescaleQnAverageHistogramName;     ///< the name and title for after rescale Qn components average QA histograms
   QnCorrectionsProfileComponents *fDoubleHarmonicInputHistograms; //!<! the histogram with calibration information for the double harmonic method
+  QnCorrectionsProfileComponents *fDoubleHarmonicStagedInputHistograms; //!<! the histogram with the staged new calibration information for the double harmonic method
   QnCorrectionsProfileComponents *fDoubleHarmonicCalibrationHistograms; //!<! the histogram for building calibration information for the doubel harmonic method
   QnCorrectionsProfile3DCorrelations *fCorrelationsInputHistograms; //!<! the histogram with calibration information for the correlations method
+  QnCorrectionsProfile3DCorrelations *fCorrelationsStagedInputHistograms; //!<! the histogram with the staged new calibration information for the correlations method
   QnCorrectionsProfile3DCorrelations *fCorrelationsCalibrationHistograms; //!<! the histogram for building calibration information for the correlations method
   QnCorrectionsHistogramSparse *fQANotValidatedBin;    //!<! the histogram with non validated bin information
   QnCorrectionsProfileComponents *fQATwistQnAverageHistogram; //!<! the after twist correction step average Qn components QA histogram
@@ -214,6 +222,8 @@ private:
   Int_t fMinNoOfEntriesToValidate;              ///< number of entries for bin content validation threshold
   QnCorrectionsQnVector *fTwistCorrectedQnVector;   ///< twisted Qn vector
   QnCorrectionsQnVector *fRescaleCorrectedQnVector; ///< rescaled Qn vector
+  Bool_t fKeepTwistCorrectedQnVector;   //!<! keep the twisted Qn vector snapshot updated
+  Bool_t fKeepRescaleCorrectedQnVector; //!<! keep the rescaled Qn vector snapshot updated
 
 /// \cond CLASSIMP
   ClassDef(QnCorrectionsQnVectorTwistAndRescale, 2);
@@ -13,6 +13,8 @@
 #pragma link off all classes;
 #pragma link off all functions;
 
+#pragma link C++ class QnCorrectionsCheckpoint+;
+#pragma link C++ class QnCorrectionsCheckpointBins+;
 #pragma link C++ class QnCorrectionsCorrectionOnInputData+;
 #pragma link C++ class QnCorrectionsCorrectionOnQvector+;
 #pragma link C++ class QnCorrectionsCorrectionsSetOnInputData+;
@@ -33,6 +35,8 @@
 #pragma link C++ class QnCorrectionsDetectorConfigurationChannels+;
 #pragma link C++ class QnCorrectionsDetectorConfigurationsSet+;
 #pragma link C++ class QnCorrectionsDetectorConfigurationTracks+;
+#pragma link C++ class QnCorrectionsDetectorConfigurationTracksFamily+;
+#pragma link C++ class QnCorrectionsDetectorConfigurationTracksVariations+;
 #pragma link C++ class QnCorrectionsEventClassVariable+;
 #pragma link C++ class QnCorrectionsEventClassVariablesSet+;
 #pragma link C++ class QnCorrectionsHistogram+;
@@ -40,8 +44,13 @@
 #pragma link C++ class QnCorrectionsHistogramChannelized+;
 #pragma link C++ class QnCorrectionsHistogramChannelizedSparse+;
 #pragma link C++ class QnCorrectionsHistogramSparse+;
+#pragma link C++ class QnCorrectionsHistogramsContext+;
 #pragma link C++ class QnCorrectionsInputGainEqualization+;
 #pragma link C++ class QnCorrectionsManager+;
+#pragma link C++ class QnCorrectionsPipeline+;
+#pragma link C++ class QnCorrectionsPipelineEvent+;
+#pragma link C++ class QnCorrectionsPipelineInput+;
+#pragma link C++ class QnCorrectionsPipelineOutput+;
 #pragma link C++ class QnCorrectionsProfile+;
 #pragma link C++ class QnCorrectionsProfile3DCorrelations+;
 #pragma link C++ class QnCorrectionsProfileChannelized+;
@@ -52,6 +61,8 @@
 #pragma link C++ class QnCorrectionsQnVector+;
 #pragma link C++ class QnCorrectionsQnVectorAlignment+;
 #pragma link C++ class QnCorrectionsQnVectorBuild+;
+#pragma link C++ class QnCorrectionsQnVectorCorrelations+;
+#pragma link C++ class QnCorrectionsQnVectorDifferentialFlow+;
 #pragma link C++ class QnCorrectionsQnVectorRecentering+;
 #pragma link C++ class QnCorrectionsQnVectorTwistAndRescale+;
 
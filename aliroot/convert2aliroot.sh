@@ -35,7 +35,9 @@ fi
 
 rsync -av $inputfolder/ $outputfolder
 
-listclasses="CorrectionOnInputData
+listclasses="Checkpoint
+Core
+CorrectionOnInputData
 CorrectionOnQvector
 CorrectionsSetOnInputData
 CorrectionsSetOnQvector
@@ -54,10 +56,25 @@ EventClassVariable
 Histogram
 InputGainEqualization
 Manager
+Output
+Pipeline
 Profile
 QnVector"
 
-listclassesfiles="CorrectionOnInputData
+listclassesfiles="Checkpoint
+CoreAccumulator
+CoreArena
+CoreBinRegisters
+CoreCorrectionKernels
+CoreDirtyBins
+CoreEventClassBinning
+CoreFillBuffer
+CoreHarmonicBasis
+CoreQnVector
+CoreQuantizedTable
+CoreSpscQueue
+CoreVariablesBank
+CorrectionOnInputData
 CorrectionOnQvector
 CorrectionsSetOnInputData
 CorrectionsSetOnQvector
@@ -77,6 +94,8 @@ DetectorConfigurationBase
 DetectorConfigurationChannels
 DetectorConfigurationsSet
 DetectorConfigurationTracks
+DetectorConfigurationTracksFamily
+DetectorConfigurationTracksVariations
 EventClassVariable
 EventClassVariablesSet
 Histogram
@@ -86,6 +105,8 @@ HistogramChannelizedSparse
 HistogramSparse
 InputGainEqualization
 Manager
+OutputWriter
+Pipeline
 Profile
 Profile3DCorrelations
 ProfileChannelized
@@ -97,12 +118,16 @@ QnVector
 QnVectorBuild
 QnVectorRecentering
 QnVectorAlignment
+QnVectorCorrelations
+QnVectorDifferentialFlow
 QnVectorTwistAndRescale"
 
 for j in $listclassesfiles; do
   mv $outputfolder/QnCorrections${j}.cxx $outputfolder/AliQnCorrections${j}.cxx
   mv $outputfolder/QnCorrections${j}.h $outputfolder/AliQnCorrections${j}.h
 done
+# header only classes
+mv $outputfolder/QnCorrectionsCoreCuts.h $outputfolder/AliQnCorrectionsCoreCuts.h
 
 # remove the framework tracing support
 rm $outputfolder/QnCorrectionsLog.*